@@ -22,6 +22,7 @@
 #include <stdint.h>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <set>
 #include <string>
 #include <rogue/interfaces/stream/Master.h>
@@ -31,16 +32,53 @@
 #include <rogue/interfaces/memory/Block.h>
 #include <rogue/Logging.h>
 
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+#endif
+
 namespace rogue {
 
    //! LibraryBase
    class LibraryBase {
 
+         // Memory map entry, one per variable
+         struct MemMapEntry {
+            std::string name;
+            std::string mode;
+            std::string mbName;
+            std::string blkName;
+            bool overlapEn;
+            bool verify;
+            bool bulkEn;
+            bool updateNotify;
+            bool byteReverse;
+            bool bitReverse;
+            uint64_t offset;
+            uint32_t modelId;
+            uint32_t binPoint;
+            uint32_t blockSize;
+            uint32_t numValues;
+            uint32_t valueBits;
+            uint32_t valueStride;
+            uint32_t retryCount;
+            double minimum;
+            double maximum;
+            std::vector<uint32_t> bitOffset;
+            std::vector<uint32_t> bitSize;
+         };
+
+         // Alias for map of block variables
+         typedef std::unordered_map< std::string, std::vector< std::shared_ptr<rogue::interfaces::memory::Variable> > > BlockVarMap;
+
          // Logger
          std::shared_ptr<rogue::Logging> log_;
 
-         //! Map of variables
-         std::map< std::string, std::shared_ptr<rogue::interfaces::memory::Variable> > variables_;
+         //! Hashed map of variables
+         std::unordered_map< std::string, std::shared_ptr<rogue::interfaces::memory::Variable> > variables_;
+
+         //! Ordered map of variables, only built when requested through getVariableList()
+         std::map< std::string, std::shared_ptr<rogue::interfaces::memory::Variable> > varList_;
 
          //! Map of blocks by block name
          std::map< std::string, std::shared_ptr<rogue::interfaces::memory::Block> > blocks_;
@@ -62,15 +100,36 @@ namespace rogue {
          // Parse memory map
          void parseMemMap (std::string map);
 
+         //! Compile a memory map to a binary file
+         /** The passed memory map string, in the format generated by Root.saveAddressMap(),
+          * is parsed and written to the passed file in a compact binary format which can
+          * be loaded with loadMemMap(). No variables are created.
+          *
+          * @param map Memory map string
+          * @param path Binary memory map file to create
+          */
+         void compileMemMap (std::string map, std::string path);
+
+         //! Load a compiled binary memory map
+         /** The passed file, generated by compileMemMap(), is mapped into memory and
+          * Variables and Blocks are created directly from its records.
+          *
+          * @param path Binary memory map file
+          */
+         void loadMemMap (std::string path);
+
          static std::shared_ptr<rogue::LibraryBase> create();
 
+         // Setup class for use in python
+         static void setup_python();
+
          //! Read all variables
          void readAll();
 
          //! Get variable by name
          std::shared_ptr<rogue::interfaces::memory::Variable> getVariable(const std::string & name);
 
-         //! Get a const reference to the map of variables
+         //! Get a const reference to the ordered map of variables
          const std::map<std::string, std::shared_ptr<rogue::interfaces::memory::Variable>> & getVariableList();
 
          //! Get block by name
@@ -79,11 +138,35 @@ namespace rogue {
          //! Get a map of blocks
          const std::map< std::string, std::shared_ptr<rogue::interfaces::memory::Block> > getBlockList();
 
+#ifndef NO_PYTHON
+
+         //! Get a list of variable names, python version
+         boost::python::object getVariableNamesPy();
+
+         //! Get a dictionary of variable attributes, python version
+         boost::python::object getVariableInfoPy(std::string name);
+
+         //! Get the value of a variable as a string, python version
+         std::string getValuePy(std::string name, bool read);
+
+         //! Get a dictionary of block sizes by block name, python version
+         boost::python::object getBlockSizesPy();
+
+#endif
+
       private:
 
+         //! Parse memory map string into entries
+         void parseEntries(std::string & map, std::vector<MemMapEntry> & entries);
+
+         //! Extract memory map entry from fields
+         void extractEntry(std::map<std::string, std::string> &data, MemMapEntry & entry);
+
          //! Create a variable
-         void createVariable(std::map<std::string, std::string> &data,
-                             std::map<std::string, std::vector< std::shared_ptr<rogue::interfaces::memory::Variable> > > &blockVars );
+         void createVariable(MemMapEntry & entry, BlockVarMap & blockVars);
+
+         //! Add variables to their blocks
+         void addBlockVariables(BlockVarMap & blockVars);
 
          //! Helper function to get string from fields
          std::string getFieldString(std::map<std::string, std::string> fields, std::string name);
@@ -20,6 +20,7 @@
 #ifndef __ROGUE_QUEUE_H__
 #define __ROGUE_QUEUE_H__
 #include <condition_variable>
+#include <chrono>
 #include <stdint.h>
 #include <queue>
 #include <mutex>
@@ -80,6 +81,12 @@ namespace rogue {
              return busy_;
           }
 
+          // Wait until the queue drops below threshold or is stopped, false on timeout
+          bool waitIdle(uint64_t timeout) {
+             std::unique_lock<std::mutex> lock(mtx_);
+             return pushCond_.wait_for(lock,std::chrono::microseconds(timeout),[this]{ return ( !run_ || !busy_ ); });
+          }
+
           void reset() {
              std::unique_lock<std::mutex> lock(mtx_);
              while(!queue_.empty()) queue_.pop();
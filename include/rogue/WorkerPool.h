@@ -0,0 +1,193 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Ordered Worker Pool
+ * ----------------------------------------------------------------------------
+ * File       : WorkerPool.h
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Pool of worker threads fed from a bounded queue. Items can be completed
+ * in the order they were pushed while the bulk of the work runs in parallel.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_WORKER_POOL_H__
+#define __ROGUE_WORKER_POOL_H__
+#include <condition_variable>
+#include <stdint.h>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <rogue/Queue.h>
+
+namespace rogue {
+
+   //! Ordered worker pool
+   /*
+    * The owner starts the pool with one of its member functions as the thread
+    * body. The body pops items, does the parallel part of the work, calls wait()
+    * with the item index before the ordered part and done() after it:
+    *
+    *    while ( pool_.pop(item,index) ) {
+    *       ... parallel work ...
+    *       pool_.wait(index);
+    *       ... ordered work ...
+    *       pool_.done(index);
+    *    }
+    *
+    * Unordered items have index 0 and do not wait. Calls to start(), stop(),
+    * active() and push() are serialized by the owner.
+    */
+   template<typename T>
+   class WorkerPool {
+      private:
+
+         //! Max items queued per worker
+         static const uint32_t QueueMax = 4;
+
+         //! Queued item with dispatch index
+         struct Work {
+            T item;
+            uint64_t index;
+            bool valid;
+
+            Work() : item(), index(0), valid(false) { }
+         };
+
+         std::shared_ptr<rogue::Queue<Work>> queue_;
+         std::vector<std::thread *> threads_;
+
+         //! Items are completed in dispatch order
+         bool orderEn_;
+         uint64_t dispatchIdx_;
+         uint64_t emitIdx_;
+         std::mutex orderMtx_;
+         std::condition_variable orderCond_;
+
+      public:
+
+         WorkerPool() {
+            orderEn_     = false;
+            dispatchIdx_ = 0;
+            emitIdx_     = 0;
+         }
+
+         ~WorkerPool() {
+            stop();
+         }
+
+         //! Start count threads running body on owner, stopping any current threads
+         template<typename C>
+         void start(uint32_t count, const char * name, void (C::*body)(), C * owner) {
+            uint32_t x;
+
+            stop();
+
+            if ( count == 0 ) return;
+
+            queue_ = std::make_shared<rogue::Queue<Work>>();
+            queue_->setMax(count * QueueMax);
+
+            {
+               std::lock_guard<std::mutex> lock(orderMtx_);
+               orderEn_     = true;
+               dispatchIdx_ = 0;
+               emitIdx_     = 0;
+            }
+
+            for (x=0; x < count; x++) {
+               threads_.push_back(new std::thread(body, owner));
+#ifndef __MACH__
+               pthread_setname_np( threads_.back()->native_handle(), name );
+#endif
+            }
+         }
+
+         //! Stop and join threads, queued items are discarded
+         void stop() {
+            uint32_t x;
+
+            if ( queue_ ) queue_->stop();
+
+            // Release workers waiting for their turn
+            {
+               std::lock_guard<std::mutex> lock(orderMtx_);
+               orderEn_ = false;
+               orderCond_.notify_all();
+            }
+
+            for (x=0; x < threads_.size(); x++) {
+               threads_[x]->join();
+               delete threads_[x];
+            }
+
+            threads_.clear();
+            queue_.reset();
+         }
+
+         //! Number of worker threads
+         uint32_t count() {
+            return(threads_.size());
+         }
+
+         //! True when threads are running
+         bool active() {
+            return(queue_ != NULL);
+         }
+
+         //! Queue an item, blocks while the queue is full
+         void push(T const & item, bool ordered) {
+            Work work;
+
+            work.item  = item;
+            work.valid = true;
+
+            if ( ordered ) {
+               std::lock_guard<std::mutex> lock(orderMtx_);
+
+               // First ordered item after a restart starts a new sequence
+               if ( dispatchIdx_ == 0 ) emitIdx_ = 1;
+               work.index = ++dispatchIdx_;
+            }
+            queue_->push(work);
+         }
+
+         //! Get the next item, false once the pool is stopped. Called by workers.
+         bool pop(T & item, uint64_t & index) {
+            Work work;
+
+            // Pop returns an invalid item once the queue is stopped
+            if ( ! (work = queue_->pop()).valid ) return(false);
+
+            item  = work.item;
+            index = work.index;
+            return(true);
+         }
+
+         //! Wait until all earlier ordered items are done
+         void wait(uint64_t index) {
+            if ( index == 0 ) return;
+
+            std::unique_lock<std::mutex> lock(orderMtx_);
+            while ( orderEn_ && emitIdx_ != index ) orderCond_.wait(lock);
+         }
+
+         //! Mark an ordered item done, releasing the next one
+         void done(uint64_t index) {
+            if ( index == 0 ) return;
+
+            std::lock_guard<std::mutex> lock(orderMtx_);
+            emitIdx_++;
+            orderCond_.notify_all();
+         }
+   };
+}
+
+#endif
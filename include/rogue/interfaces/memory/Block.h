@@ -23,6 +23,7 @@
 
 #include <rogue/interfaces/memory/Master.h>
 #include <thread>
+#include <atomic>
 
 #ifndef NO_PYTHON
 #define BOOST_BIND_GLOBAL_PLACEHOLDERS
@@ -70,8 +71,16 @@ namespace rogue {
          // Forward declaration
          class Variable;
 
+         // Forward declaration
+         class BulkOp;
+
+         // Forward declaration
+         class UpdateBus;
+
          //! Memory interface Block device
          class Block : public Master {
+            friend class BulkOp;
+            friend class UpdateBus;
 
             protected:
 
@@ -144,6 +153,22 @@ namespace rogue {
                // Retry count
                uint32_t retryCount_;
 
+               // Data version, incremented on each completed transaction
+               std::atomic<uint64_t> version_;
+
+               // Transaction started since last check, transiant
+               bool tranStarted_;
+
+               // Update bus, variable updates are published here when set
+               std::shared_ptr<rogue::interfaces::memory::UpdateBus> updateBus_;
+
+#ifndef NO_PYTHON
+
+               // Create a read only numpy view of a block buffer, referencing the python block object
+               static boost::python::object numpyView(boost::python::object self, uint8_t *data, uint32_t size);
+
+#endif
+
 #ifndef NO_PYTHON
 
                // Call variable update for all variables
@@ -263,6 +288,53 @@ namespace rogue {
                //! Get block python transactions flag
                bool blockPyTrans();
 
+               //! Get data version
+               /** Return the data version counter. The counter is incremented each time a
+                * started transaction is checked and completes without error, allowing consumers
+                * of the block data to detect updates. Checks with no transaction started leave
+                * the counter unchanged.
+                *
+                * Exposed as version property to Python
+                * @return 64-bit version counter
+                */
+               uint64_t version();
+
+#ifndef NO_PYTHON
+
+               //! Get block data as a numpy array
+               /** Return a read only numpy uint8 array which references the block data
+                * buffer without copying. The array keeps the Block alive. The contents
+                * track the block data as transactions complete, a copy should be made if
+                * a stable or writable array is required.
+                *
+                * Exposed as data property to Python
+                * @param self Python Block object
+                * @return Numpy array
+                */
+               static boost::python::object dataPy(boost::python::object self);
+
+               //! Get block verify data as a numpy array
+               /** Return a read only numpy uint8 array which references the verify data
+                * buffer without copying.
+                *
+                * Exposed as verifyData property to Python
+                * @param self Python Block object
+                * @return Numpy array
+                */
+               static boost::python::object verifyDataPy(boost::python::object self);
+
+               //! Get block verify mask as a numpy array
+               /** Return a read only numpy uint8 array which references the verify mask
+                * buffer without copying.
+                *
+                * Exposed as verifyMask property to Python
+                * @param self Python Block object
+                * @return Numpy array
+                */
+               static boost::python::object verifyMaskPy(boost::python::object self);
+
+#endif
+
             private:
 
                //! Start a c++ transaction for this block, internal version
@@ -276,6 +348,20 @@ namespace rogue {
                 */
                void intStartTransaction(uint32_t type, bool forceWr, bool check, rogue::interfaces::memory::Variable *var, int32_t index);
 
+               //! Start a c++ transaction for this block with retries
+               /** Start a c++ transaction, retrying up to the configured retry count. When the
+                * transaction is checked, either because check is set or a retry count is configured,
+                * the returned flag indicates that variable updates are required.
+                *
+                * @param type    Transaction type
+                * @param forceWr Force write of non-stale block
+                * @param check   Flag to indicate if the transaction results should be immediately checked
+                * @param var     Variable associated with transaction
+                * @param index   Variable index for list variables, -1 for full variable
+                * @return True if variable updates are required
+                */
+               bool retryTransaction(uint32_t type, bool forceWr, bool check, rogue::interfaces::memory::Variable *var, int32_t index);
+
             public:
 
                //! Start a c++ transaction for this block
@@ -0,0 +1,159 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Memory Bulk Operation
+ * ----------------------------------------------------------------------------
+ * File       : BulkOp.h
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Concurrent bulk read and write of Blocks grouped by downstream Slave.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_INTERFACES_MEMORY_BULK_OP_H__
+#define __ROGUE_INTERFACES_MEMORY_BULK_OP_H__
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <string>
+#include <rogue/interfaces/memory/Block.h>
+#include <rogue/Logging.h>
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+#endif
+
+namespace rogue {
+   namespace interfaces {
+      namespace memory {
+
+         //! Bulk operation engine
+         /** The BulkOp class performs bulk write/verify and read sequences on a set of
+          * Blocks. Blocks are grouped by the ID of the Slave which terminates their memory
+          * path, and each group is processed in its own thread with a bounded number of
+          * Block transactions in flight. Blocks behind independent Slaves are therefore
+          * accessed concurrently while transactions to a single Slave retain their order.
+          *
+          * The write sequence starts the write transaction of each Block and checks it, then
+          * starts the verify transaction for the Blocks whose write completed without error and
+          * checks those. Each Block generates at most one variable update per sequence.
+          *
+          * Errors from all groups are collected and reported together once every group has
+          * completed. The python GIL is only held while generating variable update notifications
+          * after all transactions are complete.
+          */
+         class BulkOp {
+
+               // Block group serviced by one thread
+               struct Group {
+                  uint32_t slaveId;
+                  std::vector< std::shared_ptr<rogue::interfaces::memory::Block> > blocks;
+                  std::vector<bool> update;
+                  std::vector<bool> failed;
+                  std::vector<std::string> errors;
+               };
+
+               // Block groups
+               std::vector<Group> groups_;
+
+               // Max blocks in flight per group
+               uint32_t maxDepth_;
+
+               // Operation lock
+               std::mutex mtx_;
+
+               // Logging
+               std::shared_ptr<rogue::Logging> log_;
+
+               // Issue a transaction type to all blocks in a group
+               void process(Group *grp, uint32_t type, bool force);
+
+               // Check the oldest in flight block of a group
+               void checkOldest(Group *grp, std::vector<uint32_t> & inFlight, uint32_t & head);
+
+               // Group thread for write and verify sequence
+               void runWrite(Group *grp, bool force);
+
+               // Group thread for read sequence
+               void runRead(Group *grp);
+
+               // Run group threads and report results
+               void execute(bool write, bool force);
+
+            public:
+
+               //! Class factory which returns a pointer to a BulkOp (BulkOpPtr)
+               /** Exposed to Python as rogue.interfaces.memory.BulkOp()
+                *
+                * @param maxDepth Maximum number of Block transactions in flight per Slave
+                */
+               static std::shared_ptr<rogue::interfaces::memory::BulkOp> create (uint32_t maxDepth);
+
+               // Setup class for use in python
+               static void setup_python();
+
+               // Create a BulkOp object
+               BulkOp(uint32_t maxDepth);
+
+               // Destroy the BulkOp object
+               ~BulkOp();
+
+               //! Set the list of Blocks, C++ version
+               /** Blocks without bulk operations enabled or with python transactions blocked
+                * are ignored. The Slave ID of each Block is queried at this time, so the memory
+                * tree must be connected.
+                *
+                * @param blocks Block list
+                */
+               void setBlocks(std::vector< std::shared_ptr<rogue::interfaces::memory::Block> > blocks);
+
+#ifndef NO_PYTHON
+
+               //! Set the list of Blocks, Python version
+               /** Exposed as setBlocks() to Python
+                *
+                * @param blocks Block list
+                */
+               void setBlocksPy(boost::python::object blocks);
+
+#endif
+
+               //! Get the number of Slave groups
+               /** Exposed as getGroupCount() to Python
+                * @return Number of independent Slave groups
+                */
+               uint32_t getGroupCount();
+
+               //! Perform a write, verify and check sequence on all Blocks
+               /** An exception is thrown if any errors occur.
+                *
+                * Exposed as write() to Python
+                * @param force Force write of non-stale blocks
+                */
+               void write(bool force);
+
+               //! Perform a read and check sequence on all Blocks
+               /** An exception is thrown if any errors occur.
+                *
+                * Exposed as read() to Python
+                */
+               void read();
+         };
+
+         //! Alias for using shared pointer as BulkOpPtr
+         typedef std::shared_ptr<rogue::interfaces::memory::BulkOp> BulkOpPtr;
+
+      }
+   }
+}
+
+#endif
+
@@ -0,0 +1,159 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Memory Emulator
+ * ----------------------------------------------------------------------------
+ * File       : Emulate.h
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Native memory space emulator.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_INTERFACES_MEMORY_EMULATE_H__
+#define __ROGUE_INTERFACES_MEMORY_EMULATE_H__
+#include <stdint.h>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <rogue/interfaces/memory/Slave.h>
+#include <rogue/Logging.h>
+
+namespace rogue {
+   namespace interfaces {
+      namespace memory {
+
+         //! Memory space emulator
+         /** The Emulate class is a memory Slave which services transactions from
+          * a local emulated address space. It is intended as a fast replacement for
+          * the Python MemEmulate class in tests and simulations.
+          *
+          * By default the address space is sparse: memory is tracked in 4KB pages which
+          * are allocated on the first write to the page. Reads from unallocated pages
+          * return zeros. Alternatively a file can be mapped with mapFile(), in which
+          * case the address space is backed by the file and persists across runs.
+          *
+          * Transactions are serviced directly in the thread of the calling Master with
+          * the python GIL released, allowing multiple Masters to access the emulated
+          * space concurrently. Pages are spread over a set of independently locked
+          * stripes so that transactions to different pages do not serialize.
+          */
+         class Emulate : public Slave {
+
+               // Page size
+               static const uint64_t PageSize = 4096;
+
+               // Number of lock stripes, consecutive pages use different stripes
+               static const uint32_t StripeCount = 64;
+
+               // Alias for page map
+               typedef std::unordered_map<uint64_t, uint8_t *> PageMap;
+
+               // Lock stripe with the pages it owns
+               struct Stripe {
+                  std::mutex mtx;
+                  PageMap    pages;
+               };
+
+               // Page stripes
+               Stripe stripes_[StripeCount];
+
+               // Mapped file descriptor
+               int32_t fd_;
+
+               // Mapped file size
+               uint64_t mapSize_;
+
+               // Mapped file pointer
+               uint8_t * map_;
+
+               // Total allocated size
+               std::atomic<uint64_t> totAlloc_;
+
+               // Transaction count
+               std::atomic<uint64_t> tranCount_;
+
+               // Logging
+               std::shared_ptr<rogue::Logging> log_;
+
+               // Get the stripe which owns a page
+               Stripe & stripe(uint64_t page);
+
+               // Lock all stripes, used when changing the mapping
+               void lockAll(std::vector<std::unique_lock<std::mutex>> & locks);
+
+               // Unmap file and free allocated pages, all stripes must be locked
+               void release();
+
+            public:
+
+               //! Class factory which returns a pointer to an Emulate object (EmulatePtr)
+               /** Exposed to Python as rogue.interfaces.memory.Emulate()
+                *
+                * @param min Minimum transaction size, also used as the address alignment.
+                * @param max Maximum transaction size.
+                */
+               static std::shared_ptr<rogue::interfaces::memory::Emulate> create (uint32_t min, uint32_t max);
+
+               // Setup class for use in python
+               static void setup_python();
+
+               // Create an Emulate object
+               Emulate(uint32_t min, uint32_t max);
+
+               // Destroy the Emulate object
+               ~Emulate();
+
+               //! Back the emulated address space with a file
+               /** The passed file is created if it does not exist and is extended to the
+                * passed size as a sparse file. Any previously written sparse pages are discarded.
+                * Transactions beyond the passed size will return an error.
+                *
+                * Exposed as mapFile() to Python
+                * @param path Path of file to map
+                * @param size Size of address space to map
+                */
+               void mapFile(std::string path, uint64_t size);
+
+               //! Get total allocated memory in bytes
+               /** Exposed as getTotalAllocated() to Python
+                * @return Total bytes allocated for sparse pages
+                */
+               uint64_t getTotalAllocated();
+
+               //! Get number of allocated pages
+               /** Exposed as getPageCount() to Python
+                * @return Number of allocated pages
+                */
+               uint32_t getPageCount();
+
+               //! Get number of serviced transactions
+               /** Exposed as getTransactionCount() to Python
+                * @return Transaction count
+                */
+               uint64_t getTransactionCount();
+
+               //! Stop the interface
+               void stop();
+
+               //! Service a transaction from an attached master
+               void doTransaction(std::shared_ptr<rogue::interfaces::memory::Transaction> transaction);
+         };
+
+         //! Alias for using shared pointer as EmulatePtr
+         typedef std::shared_ptr<rogue::interfaces::memory::Emulate> EmulatePtr;
+
+      }
+   }
+}
+
+#endif
+
@@ -0,0 +1,123 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Memory Traffic Generator
+ * ----------------------------------------------------------------------------
+ * File       : TrafficGen.h
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Native memory transaction generator for throughput measurements.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_INTERFACES_MEMORY_TRAFFIC_GEN_H__
+#define __ROGUE_INTERFACES_MEMORY_TRAFFIC_GEN_H__
+#include <stdint.h>
+#include <atomic>
+#include <rogue/interfaces/memory/Master.h>
+#include <rogue/Logging.h>
+
+namespace rogue {
+   namespace interfaces {
+      namespace memory {
+
+         //! Memory transaction generator
+         /** The TrafficGen class is a memory Master which issues write and read back
+          * transactions to the attached Slave from a set of native threads. It is used
+          * to measure the throughput of a memory Slave without the cost of the python
+          * Variable interface.
+          *
+          * Each thread is given its own region of the address space and its own Master
+          * so that threads only contend in the Slave being measured.
+          */
+         class TrafficGen : public Master {
+
+               // Transactions completed by the last run
+               std::atomic<uint64_t> tranCount_;
+
+               // Data mismatches and transaction errors in the last run
+               std::atomic<uint64_t> errCount_;
+
+               // Bytes transferred by the last run
+               std::atomic<uint64_t> byteCount_;
+
+               // Duration of the last run in seconds
+               double runTime_;
+
+               // Logging
+               std::shared_ptr<rogue::Logging> log_;
+
+               // Thread body
+               void runThread(uint32_t idx, uint64_t base, uint64_t span, uint32_t size, uint32_t count);
+
+            public:
+
+               //! Class factory which returns a pointer to a TrafficGen object (TrafficGenPtr)
+               /** Exposed to Python as rogue.interfaces.memory.TrafficGen()
+                */
+               static std::shared_ptr<rogue::interfaces::memory::TrafficGen> create ();
+
+               // Setup class for use in python
+               static void setup_python();
+
+               // Create a TrafficGen object
+               TrafficGen();
+
+               // Destroy the TrafficGen object
+               ~TrafficGen();
+
+               //! Run the generator and wait for it to complete
+               /** Each thread writes and reads back count transactions of the passed size,
+                * walking through a region of span bytes starting at base + thread * span.
+                *
+                * Exposed as run() to Python
+                * @param threads Number of threads
+                * @param count Number of write and read pairs per thread
+                * @param size Transaction size in bytes
+                * @param base Base address
+                * @param span Size of the region accessed by each thread
+                */
+               void run(uint32_t threads, uint32_t count, uint32_t size, uint64_t base, uint64_t span);
+
+               //! Get number of transactions completed by the last run
+               /** Exposed as getTransactionCount() to Python
+                * @return Transaction count
+                */
+               uint64_t getTransactionCount();
+
+               //! Get number of errors in the last run
+               /** Transaction errors and read back mismatches are counted.
+                *
+                * Exposed as getErrorCount() to Python
+                * @return Error count
+                */
+               uint64_t getErrorCount();
+
+               //! Get the transaction rate of the last run
+               /** Exposed as getRate() to Python
+                * @return Transactions per second
+                */
+               double getRate();
+
+               //! Get the bandwidth of the last run
+               /** Exposed as getBandwidth() to Python
+                * @return Bytes per second
+                */
+               double getBandwidth();
+         };
+
+         //! Alias for using shared pointer as TrafficGenPtr
+         typedef std::shared_ptr<rogue::interfaces::memory::TrafficGen> TrafficGenPtr;
+
+      }
+   }
+}
+
+#endif
+
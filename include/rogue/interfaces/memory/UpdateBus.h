@@ -0,0 +1,266 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Memory Variable Update Bus
+ * ----------------------------------------------------------------------------
+ * File       : UpdateBus.h
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Lock free publication of variable update notifications.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_INTERFACES_MEMORY_UPDATE_BUS_H__
+#define __ROGUE_INTERFACES_MEMORY_UPDATE_BUS_H__
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <rogue/EnableSharedFromThis.h>
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+#endif
+
+namespace rogue {
+   namespace interfaces {
+      namespace memory {
+
+         class Block;
+         class Variable;
+
+         //! Variable update bus
+         /** The UpdateBus carries variable update notifications from Blocks to a single
+          * consumer without taking the python GIL or a lock on the publishing side.
+          *
+          * Each variable registered with the bus is assigned an integer ID. When a Block
+          * completes a transaction it publishes the IDs of its variables to the bus. Each ID
+          * is placed in a bounded lock free ring at most once until it is consumed, so repeated
+          * updates to the same variable between consumer wakeups are coalesced into a single
+          * entry. A per variable version counter records the number of publications.
+          *
+          * The consumer receives batches of entries. When the variable data is requested it is
+          * copied from the Block at the time the batch is consumed, returning the most
+          * recent value. Fan out to multiple subscribers (listeners, ZMQ, EPICS) is performed
+          * by the consumer.
+          *
+          * The bus can be held while a group of transactions is in progress. Publications are
+          * still queued and coalesced while held, but the consumer does not receive them until
+          * every hold has been released.
+          */
+         class UpdateBus : public rogue::EnableSharedFromThis<rogue::interfaces::memory::UpdateBus> {
+
+               // Ring cell
+               struct Cell {
+                  std::atomic<uint32_t> seq;
+                  uint32_t id;
+               };
+
+               // Per variable state
+               struct VarState {
+                  std::atomic<bool> pending;
+                  std::atomic<uint64_t> version;
+                  std::shared_ptr<rogue::interfaces::memory::Variable> var;
+               };
+
+               // Ring cells
+               std::unique_ptr<Cell[]> ring_;
+
+               // Ring index mask
+               uint32_t mask_;
+
+               // Producer position
+               std::atomic<uint32_t> head_;
+
+               // Consumer position
+               uint32_t tail_;
+
+               // Variable states
+               std::unique_ptr<VarState[]> vars_;
+
+               // Maximum number of variables
+               uint32_t maxVars_;
+
+               // Number of registered variables, published after the variable is stored
+               std::atomic<uint32_t> varCount_;
+
+               // Consumer is waiting
+               std::atomic<bool> waiting_;
+
+               // Bus is stopped
+               std::atomic<bool> stopped_;
+
+               // Consumer hold count
+               std::atomic<uint32_t> holdCount_;
+
+               // Publish counter
+               std::atomic<uint64_t> pubCount_;
+
+               // Coalesced publish counter
+               std::atomic<uint64_t> coalCount_;
+
+               // Registration and consumer lock
+               std::mutex mtx_;
+
+               // Consumer condition
+               std::condition_variable cond_;
+
+               // Consumer lock
+               std::mutex popMtx_;
+
+               // Push an ID into the ring
+               bool push(uint32_t id);
+
+               // Pop an ID from the ring
+               bool pop(uint32_t & id);
+
+               // Check if ring has data
+               bool ready();
+
+               // Wait for data
+               bool wait(uint32_t timeout);
+
+            public:
+
+               //! Update entry
+               struct Update {
+
+                  //! Variable ID
+                  uint32_t id;
+
+                  //! Version at the time the update was consumed
+                  uint64_t version;
+
+                  //! Raw variable bytes, empty if data was not requested
+                  std::vector<uint8_t> data;
+               };
+
+               //! Class factory which returns a pointer to an UpdateBus (UpdateBusPtr)
+               /** Exposed to Python as rogue.interfaces.memory.UpdateBus()
+                *
+                * @param maxVariables Maximum number of variables which can be registered
+                */
+               static std::shared_ptr<rogue::interfaces::memory::UpdateBus> create (uint32_t maxVariables);
+
+               // Setup class for use in python
+               static void setup_python();
+
+               // Create an UpdateBus object
+               UpdateBus(uint32_t maxVariables);
+
+               // Destroy the UpdateBus object
+               ~UpdateBus();
+
+               //! Register all update enabled variables in a Block with the bus
+               /** Once registered the Block publishes updates to the bus instead of calling
+                * the python variable update hooks. The consumer is then responsible for
+                * calling those hooks.
+                *
+                * Exposed as addBlock() to Python
+                * @param block Block pointer
+                */
+               void addBlock(std::shared_ptr<rogue::interfaces::memory::Block> block);
+
+               //! Get the number of registered variables
+               /** Exposed as getVariableCount() to Python
+                * @return Variable count
+                */
+               uint32_t getVariableCount();
+
+               //! Get the variable associated with an ID
+               /** Exposed as getVariable() to Python
+                * @param id Variable ID
+                * @return Variable pointer
+                */
+               std::shared_ptr<rogue::interfaces::memory::Variable> getVariable(uint32_t id);
+
+               //! Publish an update for a variable ID
+               /** This method is lock free and may be called from any thread. An ID
+                * which has not been registered throws a GeneralError.
+                *
+                * Exposed as publish() to Python
+                * @param id Variable ID
+                */
+               void publish(uint32_t id);
+
+               //! Hold delivery of updates to the consumer
+               /** Holds are counted, delivery resumes when each hold has been released.
+                *
+                * Exposed as hold() to Python
+                */
+               void hold();
+
+               //! Release a hold on the delivery of updates
+               /** Exposed as release() to Python
+                */
+               void release();
+
+               //! Consume a batch of updates
+               /** Waits up to timeout for at least one update to be available. No updates
+                * are returned while the bus is held.
+                * @param batch Vector to append updates to
+                * @param maxCount Maximum number of updates to return, 0 for no limit
+                * @param timeout Timeout in microseconds, 0 to return immediately
+                * @param withData Copy the current variable data into each update
+                * @return Number of updates returned
+                */
+               uint32_t consume(std::vector<rogue::interfaces::memory::UpdateBus::Update> & batch,
+                                uint32_t maxCount, uint32_t timeout, bool withData);
+
+#ifndef NO_PYTHON
+
+               //! Consume a batch of variable IDs, Python version
+               /** The GIL is released while waiting.
+                *
+                * Exposed as pop() to Python
+                * @param timeout Timeout in microseconds
+                * @return List of variable IDs
+                */
+               boost::python::object popPy(uint32_t timeout);
+
+               //! Consume a batch of updates with data, Python version
+               /** The GIL is released while waiting.
+                *
+                * Exposed as popValues() to Python
+                * @param timeout Timeout in microseconds
+                * @return List of (id, version, bytearray) tuples
+                */
+               boost::python::object popValuesPy(uint32_t timeout);
+
+#endif
+
+               //! Get the total number of publish calls
+               /** Exposed as getPublishCount() to Python
+                * @return Publish count
+                */
+               uint64_t getPublishCount();
+
+               //! Get the number of publish calls which were coalesced with a pending update
+               /** Exposed as getCoalesceCount() to Python
+                * @return Coalesced count
+                */
+               uint64_t getCoalesceCount();
+
+               //! Stop the bus and wake the consumer
+               /** Exposed as stop() to Python
+                */
+               void stop();
+         };
+
+         //! Alias for using shared pointer as UpdateBusPtr
+         typedef std::shared_ptr<rogue::interfaces::memory::UpdateBus> UpdateBusPtr;
+
+      }
+   }
+}
+
+#endif
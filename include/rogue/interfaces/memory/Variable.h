@@ -44,6 +44,7 @@ namespace rogue {
          class Variable {
 
             friend class Block;
+            friend class UpdateBus;
 
             protected:
 
@@ -143,6 +144,9 @@ namespace rogue {
                // Retry count
                uint32_t retryCount_;
 
+               // Update bus ID, -1 when not registered
+               int32_t busId_;
+
 #ifndef NO_PYTHON
                /////////////////////////////////
                // Python
@@ -0,0 +1,133 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : AXI Batcher V1 Combiner
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Software equivalent of the firmware AxiStreamBatcher. Combines incoming
+ * frames into version 1 super-frames.
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_PROTOCOLS_BATCHER_COMBINER_V1_H__
+#define __ROGUE_PROTOCOLS_BATCHER_COMBINER_V1_H__
+#include <stdint.h>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <rogue/interfaces/stream/Master.h>
+#include <rogue/interfaces/stream/Slave.h>
+#include <rogue/interfaces/stream/FrameIterator.h>
+#include <rogue/Logging.h>
+
+namespace rogue {
+   namespace protocols {
+      namespace batcher {
+
+         //! Batcher V1 super-frame builder
+         /*
+          * Each received frame becomes a record in the current super-frame, with the
+          * frame channel, first user and last user stored in the record tail. The
+          * super-frame is sent when the next record would exceed the maximum size,
+          * when the flush timeout expires after its first record, or on flush().
+          * Completed super-frames are queued and sent in order without the lock held.
+          */
+         class CombinerV1 : public rogue::interfaces::stream::Master,
+                            public rogue::interfaces::stream::Slave {
+
+               std::shared_ptr<rogue::Logging> log_;
+
+               //! Width code, header size and tail size
+               uint32_t width_;
+               uint32_t headerSize_;
+               uint32_t tailSize_;
+
+               //! Max super-frame size
+               uint32_t maxSize_;
+
+               //! Flush timeout in microseconds
+               uint32_t timeout_;
+
+               //! Sequence number
+               uint8_t seq_;
+
+               //! Super-frame under construction
+               std::shared_ptr<rogue::interfaces::stream::Frame> frame_;
+               rogue::interfaces::stream::FrameIterator iter_;
+               uint32_t size_;
+               uint32_t count_;
+
+               //! Counters
+               uint32_t batchCount_;
+               uint32_t recordCount_;
+
+               //! Flush deadline for current super-frame
+               std::chrono::steady_clock::time_point deadline_;
+
+               std::mutex mtx_;
+               std::condition_variable cond_;
+
+               //! Flush timer thread
+               bool threadEn_;
+               std::thread* thread_;
+
+               //! Thread background
+               void runThread();
+
+               //! Completed super-frames waiting to be sent
+               std::deque< std::shared_ptr<rogue::interfaces::stream::Frame> > txQueue_;
+
+               //! A thread is sending from the queue
+               bool sending_;
+
+               //! Queue current super-frame, called with lock held
+               void flushLocked();
+
+               //! Send queued super-frames, lock is released while sending
+               void sendQueued(std::unique_lock<std::mutex> & lock);
+
+            public:
+
+               //! Class creation
+               static std::shared_ptr<rogue::protocols::batcher::CombinerV1> create(uint32_t width, uint32_t maxSize);
+
+               //! Setup class in python
+               static void setup_python();
+
+               //! Creator, width is the interface width in bytes (2 - 64)
+               CombinerV1(uint32_t width, uint32_t maxSize);
+
+               //! Deconstructor
+               ~CombinerV1();
+
+               //! Set flush timeout in microseconds, zero flushes only when full
+               void setTimeout(uint32_t timeout);
+
+               //! Send the current super-frame
+               void flush();
+
+               //! Get super-frame count
+               uint32_t getBatchCount();
+
+               //! Get record count
+               uint32_t getRecordCount();
+
+               //! Accept a frame from master
+               void acceptFrame ( std::shared_ptr<rogue::interfaces::stream::Frame> frame );
+         };
+
+         // Convienence
+         typedef std::shared_ptr<rogue::protocols::batcher::CombinerV1> CombinerV1Ptr;
+      }
+   }
+}
+#endif
+
@@ -22,6 +22,7 @@
 #define __ROGUE_PROTOCOLS_BATCHER_CORE_V1_H__
 #include <stdint.h>
 #include <thread>
+#include <vector>
 #include <rogue/interfaces/stream/Frame.h>
 #include <rogue/Logging.h>
 
@@ -39,7 +40,24 @@ namespace rogue {
                //! Frame pointers
                std::shared_ptr<rogue::interfaces::stream::Frame> frame_;
 
-               //! Data List
+            public:
+
+               //! Record entry, offsets are from the start of the frame payload
+               struct Entry {
+                  uint32_t offset;
+                  uint32_t size;
+                  uint32_t tail;
+                  uint8_t  dest;
+                  uint8_t  fUser;
+                  uint8_t  lUser;
+               };
+
+            private:
+
+               //! Record table in frame order, capacity is retained across frames
+               std::vector<rogue::protocols::batcher::CoreV1::Entry> table_;
+
+               //! Data objects, created on request
                std::vector< std::shared_ptr<rogue::protocols::batcher::Data> > list_;
 
                //! Header size
@@ -48,12 +66,18 @@ namespace rogue {
                //! Tail size
                uint32_t tailSize_;
 
-               //! Tail pointers
-               std::vector<rogue::interfaces::stream::FrameIterator> tails_;
-
                //! Sequence number
                uint32_t seq_;
 
+               //! Set header and tail size from first header byte
+               bool setWidth(uint8_t temp);
+
+               //! Parse contiguous frame by pointer
+               bool parseBuffer(const uint8_t *data, uint32_t rem);
+
+               //! Parse frame using iterators
+               bool parseFrame(uint32_t rem);
+
             public:
 
                //! Setup class in python
@@ -92,6 +116,9 @@ namespace rogue {
                //! Get end of tail iterator
                rogue::interfaces::stream::FrameIterator endTail(uint32_t index);
 
+               //! Get record table entry
+               const rogue::protocols::batcher::CoreV1::Entry & entry(uint32_t index);
+
                //! Get data
                std::shared_ptr<rogue::protocols::batcher::Data> & record(uint32_t index);
 
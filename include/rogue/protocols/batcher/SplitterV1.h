@@ -24,7 +24,11 @@
 #include <thread>
 #include <rogue/interfaces/stream/Master.h>
 #include <rogue/interfaces/stream/Slave.h>
+#include <rogue/protocols/batcher/CoreV1.h>
 #include <rogue/Logging.h>
+#include <rogue/WorkerPool.h>
+#include <mutex>
+#include <vector>
 
 namespace rogue {
    namespace protocols {
@@ -34,6 +38,32 @@ namespace rogue {
          class SplitterV1 : public rogue::interfaces::stream::Master,
                             public rogue::interfaces::stream::Slave {
 
+               //! Parser, reused to retain record table capacity
+               rogue::protocols::batcher::CoreV1 core_;
+               std::mutex mtx_;
+
+               //! Super-frame buffers referenced by zero copy records
+               std::vector<std::shared_ptr<rogue::interfaces::stream::Buffer>> slots_;
+               std::vector<uint32_t> free_;
+               std::mutex slotMtx_;
+
+               //! Worker pool, inactive when splitting in the caller's thread
+               rogue::WorkerPool<std::shared_ptr<rogue::interfaces::stream::Frame>> workers_;
+
+               //! Emit records in dispatch order
+               bool ordered_;
+
+               //! Create a frame referencing part of a super-frame buffer
+               std::shared_ptr<rogue::interfaces::stream::Frame> subFrame (
+                     std::shared_ptr<rogue::interfaces::stream::Buffer> parent, uint32_t offset, uint32_t size);
+
+               //! Parse a super-frame and send its records
+               void process ( rogue::protocols::batcher::CoreV1 & core,
+                              std::shared_ptr<rogue::interfaces::stream::Frame> frame );
+
+               //! Worker thread
+               void runWorker();
+
             public:
 
                //! Class creation
@@ -51,6 +81,21 @@ namespace rogue {
                //! Accept a frame from master
                void acceptFrame ( std::shared_ptr<rogue::interfaces::stream::Frame> frame );
 
+               //! Set number of worker threads, 0 splits in the caller's thread
+               void setWorkers(uint32_t count);
+
+               //! Get number of worker threads
+               uint32_t getWorkers();
+
+               //! Preserve record order across super-frames when using workers
+               void setOrdered(bool ordered);
+
+               //! Get ordered state
+               bool getOrdered();
+
+               //! Return a buffer, releasing super-frame buffer for zero copy records
+               void retBuffer(uint8_t * data, uint32_t meta, uint32_t size);
+
          };
 
          // Convienence
@@ -19,6 +19,7 @@
 #include <rogue/interfaces/stream/Master.h>
 #include <rogue/interfaces/stream/Slave.h>
 #include <memory>
+#include <atomic>
 #include <stdint.h>
 #include <rogue/Queue.h>
 #include <rogue/Logging.h>
@@ -44,7 +45,7 @@ namespace rogue {
                uint32_t tranCount_[256];
                uint32_t crc_[256];
                uint8_t  tranDest_;
-               uint32_t dropCount_;
+               std::atomic<uint32_t> dropCount_;
                uint32_t headSize_;
                uint32_t tailSize_;
                uint32_t alignSize_;
@@ -23,6 +23,8 @@
 #include <rogue/interfaces/stream/Master.h>
 #include <rogue/interfaces/stream/Slave.h>
 #include <memory>
+#include <thread>
+#include <vector>
 #include <stdint.h>
 #include <rogue/Queue.h>
 #include <rogue/Logging.h>
@@ -42,6 +44,22 @@ namespace rogue {
                bool     enIbCrc_;
                bool     enObCrc_;
 
+               //! Max frames queued per reassembly shard
+               static const uint32_t ShardQueueMax = 256;
+
+               // Reassembly shards, destination tDest is handled by shard tDest % shards
+               std::vector<std::shared_ptr<rogue::Queue<std::shared_ptr<rogue::interfaces::stream::Frame>>>> shardQueue_;
+               std::vector<std::thread *> shardThreads_;
+
+               // Reassembly shard thread
+               void runShard(uint32_t idx);
+
+               // Stop reassembly shard threads
+               void stopShards();
+
+               // Check and reassemble a transport frame
+               void rxProcess( std::shared_ptr<rogue::interfaces::stream::Frame> frame );
+
             public:
 
                //! Class creation
@@ -63,6 +81,12 @@ namespace rogue {
 
                //! Frame received at application interface
                void applicationRx( std::shared_ptr<rogue::interfaces::stream::Frame> frame, uint8_t id);
+
+               //! Set number of reassembly threads, 0 reassembles in the transport thread
+               void setRxShards(uint32_t shards);
+
+               //! Get number of reassembly threads
+               uint32_t getRxShards();
          };
 
          // Convenience
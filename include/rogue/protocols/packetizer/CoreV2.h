@@ -67,6 +67,12 @@ namespace rogue {
 
                //! Set timeout
                void setTimeout(uint32_t timeout);
+
+               //! Set number of reassembly threads, destinations are spread across threads
+               void setRxShards(uint32_t shards);
+
+               //! Get number of reassembly threads
+               uint32_t getRxShards();
          };
 
          // Convenience
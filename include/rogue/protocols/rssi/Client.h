@@ -71,6 +71,24 @@ namespace rogue {
                //! Get Retransmit Count
                uint32_t getRetranCount();
 
+               //! Get count of retransmissions triggered by selective acknowledgement
+               uint32_t getFastRetranCount();
+
+               //! Get smoothed round trip time in microseconds
+               uint32_t getRtt();
+
+               //! Get round trip time variation in microseconds
+               uint32_t getRttVar();
+
+               //! Get minimum round trip time in microseconds
+               uint32_t getRttMin();
+
+               //! Get maximum round trip time in microseconds
+               uint32_t getRttMax();
+
+               //! Get current retransmission timeout in microseconds
+               uint32_t getRto();
+
                //! Get locBusy
                bool getLocBusy();
 
@@ -86,8 +104,8 @@ namespace rogue {
                void     setLocTryPeriod(uint32_t val);
                uint32_t getLocTryPeriod();
 
-               void     setLocMaxBuffers(uint8_t val);
-               uint8_t  getLocMaxBuffers();
+               void     setLocMaxBuffers(uint16_t val);
+               uint16_t getLocMaxBuffers();
 
                void     setLocMaxSegment(uint16_t val);
                uint16_t getLocMaxSegment();
@@ -107,7 +125,12 @@ namespace rogue {
                void     setLocMaxCumAck(uint8_t val);
                uint8_t  getLocMaxCumAck();
 
-               uint8_t  curMaxBuffers();
+               void     setLocSack(bool val);
+               bool     getLocSack();
+
+               uint16_t curMaxBuffers();
+               bool     curWindowExt();
+               bool     curSack();
                uint16_t curMaxSegment();
                uint16_t curCumAckTout();
                uint16_t curRetranTout();
@@ -23,7 +23,12 @@
 #include <rogue/interfaces/stream/Slave.h>
 #include <memory>
 #include <map>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <condition_variable>
 #include <stdint.h>
+#include <sys/time.h>
 #include <rogue/Queue.h>
 #include <rogue/Logging.h>
 #include <rogue/EnableSharedFromThis.h>
@@ -43,11 +48,19 @@ namespace rogue {
                static const uint8_t  Version       = 1;
                static const uint8_t  TimeoutUnit   = 3; // rssiTime * std::pow(10,-TimeoutUnit) = 3 = ms
 
+               //! Window extension limits. Standard links use an 8-bit sequence space,
+               //! extended links use a 16-bit space with up to ExtMaxBuffers outstanding.
+               static const uint16_t StdMaxBuffers = 255;
+               static const uint16_t ExtMaxBuffers = 16384;
+
+               //! Eack frames received before holes are retransmitted
+               static const uint32_t DupAckThold   = 3;
+
                //! Local parameters
                uint32_t locTryPeriod_;
 
                //! Configurable parameters, requested by software
-               uint8_t  locMaxBuffers_;
+               uint16_t locMaxBuffers_;
                uint16_t locMaxSegment_;
                uint16_t locCumAckTout_;
                uint16_t locRetranTout_;
@@ -56,7 +69,7 @@ namespace rogue {
                uint8_t  locMaxCumAck_;
 
                //! Negotiated parameters
-               uint8_t  curMaxBuffers_;
+               uint16_t curMaxBuffers_;
                uint16_t curMaxSegment_;
                uint16_t curCumAckTout_;
                uint16_t curRetranTout_;
@@ -64,6 +77,25 @@ namespace rogue {
                uint8_t  curMaxRetran_;
                uint8_t  curMaxCumAck_;
 
+               //! Window extension in use and sequence number mask
+               bool     windowExt_;
+               uint16_t seqMask_;
+
+               //! Selective acknowledgement requested and in use
+               bool     locSack_;
+               bool     sack_;
+
+               //! Retransmit deadline for a transmitted frame
+               struct TxDeadline {
+                  struct timeval time;
+                  std::weak_ptr<rogue::protocols::rssi::Header> head;
+                  uint32_t count;
+
+                  bool operator > (const TxDeadline & other) const {
+                     return(timercmp(&time,&(other.time),>));
+                  }
+               };
+
                //! Connection states
                enum States : uint32_t { StClosed     = 0,
                                         StWaitSyn    = 1,
@@ -83,8 +115,8 @@ namespace rogue {
 
                // Receive tracking
                uint32_t dropCount_;
-               uint8_t  nextSeqRx_;
-               uint8_t  lastAckRx_;
+               uint16_t nextSeqRx_;
+               uint16_t lastAckRx_;
                bool     remBusy_;
                bool     locBusy_;
 
@@ -92,18 +124,19 @@ namespace rogue {
                rogue::Queue<std::shared_ptr<rogue::protocols::rssi::Header>> appQueue_;
 
                // Sequence Out of Order ("OOO") queue
-               std::map<uint8_t, std::shared_ptr<rogue::protocols::rssi::Header>> oooQueue_;
+               std::map<uint16_t, std::shared_ptr<rogue::protocols::rssi::Header>> oooQueue_;
 
                // State queue
                rogue::Queue<std::shared_ptr<rogue::protocols::rssi::Header>> stQueue_;
 
                // Application tracking
-               uint8_t lastSeqRx_;
-               uint8_t ackSeqRx_;
+               uint16_t lastSeqRx_;
+               uint16_t ackSeqRx_;
 
                // State Tracking
                std::condition_variable stCond_;
                std::mutex stMtx_;
+               bool stEvent_;
                uint32_t state_;
                struct timeval stTime_;
                uint32_t downCount_;
@@ -114,13 +147,20 @@ namespace rogue {
                uint32_t remConnId_;
 
                // Transmit tracking
-               std::shared_ptr<rogue::protocols::rssi::Header> txList_[256];
+               std::vector<std::shared_ptr<rogue::protocols::rssi::Header>> txList_;
                std::mutex txMtx_;
-               uint8_t txListCount_;
-               uint8_t lastAckTx_;
-               uint8_t locSequence_;
+               std::condition_variable txCond_;
+               uint32_t txListCount_;
+               uint16_t lastAckTx_;
+               uint16_t locSequence_;
+               uint32_t eackCount_;
+               uint32_t fastRetranCount_;
                struct timeval txTime_;
 
+               // Retransmit deadlines, earliest first. Entries for frames which
+               // have been acked or sent again are discarded when they expire.
+               std::priority_queue<TxDeadline, std::vector<TxDeadline>, std::greater<TxDeadline>> txHeap_;
+
                // Time values
                struct timeval retranToutD1_;  // retranTout_ / 1
                struct timeval tryPeriodD1_;   // TryPeriod   / 1
@@ -129,6 +169,15 @@ namespace rogue {
                struct timeval cumAckToutD2_;  // cumAckTout_ / 2
                struct timeval nullToutD3_;    // nullTout_   / 3
                struct timeval zeroTme_;       // 0
+               struct timeval openWait_;      // Time to next open state event
+
+               // Round trip estimation, microseconds
+               uint32_t rttCount_;
+               uint32_t srtt_;
+               uint32_t rttVar_;
+               uint32_t rttMin_;
+               uint32_t rttMax_;
+               uint32_t rto_;
 
                // State thread
                std::thread* thread_;
@@ -180,6 +229,24 @@ namespace rogue {
                //! Get Retransmit Count
                uint32_t getRetranCount();
 
+               //! Get count of retransmissions triggered by selective acknowledgement
+               uint32_t getFastRetranCount();
+
+               //! Get smoothed round trip time in microseconds
+               uint32_t getRtt();
+
+               //! Get round trip time variation in microseconds
+               uint32_t getRttVar();
+
+               //! Get minimum round trip time in microseconds
+               uint32_t getRttMin();
+
+               //! Get maximum round trip time in microseconds
+               uint32_t getRttMax();
+
+               //! Get current retransmission timeout in microseconds
+               uint32_t getRto();
+
                //! Get locBusy
                bool getLocBusy();
 
@@ -195,8 +262,9 @@ namespace rogue {
                void     setLocTryPeriod(uint32_t val);
                uint32_t getLocTryPeriod();
 
-               void     setLocMaxBuffers(uint8_t val);
-               uint8_t  getLocMaxBuffers();
+               //! Values above StdMaxBuffers request the window extension from a Rogue peer
+               void     setLocMaxBuffers(uint16_t val);
+               uint16_t getLocMaxBuffers();
 
                void     setLocMaxSegment(uint16_t val);
                uint16_t getLocMaxSegment();
@@ -216,7 +284,13 @@ namespace rogue {
                void     setLocMaxCumAck(uint8_t val);
                uint8_t  getLocMaxCumAck();
 
-               uint8_t  curMaxBuffers();
+               //! Request selective acknowledgement from a Rogue peer
+               void     setLocSack(bool val);
+               bool     getLocSack();
+
+               uint16_t curMaxBuffers();
+               bool     curWindowExt();
+               bool     curSack();
                uint16_t curMaxSegment();
                uint16_t curCumAckTout();
                uint16_t curRetranTout();
@@ -238,8 +312,35 @@ namespace rogue {
                // Method to transit a frame with proper updates
                void transportTx(std::shared_ptr<rogue::protocols::rssi::Header> head, bool seqUpdate, bool txReset);
 
-               // Method to retransmit a frame
-               int8_t retransmit(uint8_t id);
+               // Retransmit frames with expired deadlines, next is lowered to the earliest pending deadline
+               int8_t retransmit(struct timeval &next);
+
+               // Add retransmit deadline for a transmitted frame, called with txMtx_ held
+               void txDeadline(std::shared_ptr<rogue::protocols::rssi::Header> head);
+
+               // Prepare a frame for retransmission, called with txMtx_ held
+               void txResend(std::shared_ptr<rogue::protocols::rssi::Header> head);
+
+               // Send out of order sequence list to the remote
+               void sendEack();
+
+               // Process an out of order sequence list from the remote
+               void recvEack(std::shared_ptr<rogue::protocols::rssi::Header> head);
+
+               // Select the sequence space for a connection
+               void setWindowExt(bool enable);
+
+               // Wake the state thread
+               void stNotify();
+
+               // Update round trip estimate with a new sample, called with txMtx_ held
+               void rttSample(uint32_t rtt);
+
+               // Reset round trip estimate to the negotiated retransmission timeout
+               void rttReset();
+
+               //! Convert time structure to microseconds
+               static uint64_t timeUs ( struct timeval &tme );
 
                //! Convert rssi time to time structure
                static void convTime ( struct timeval &tme, uint32_t rssiTime );
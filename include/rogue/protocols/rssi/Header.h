@@ -59,6 +59,9 @@ namespace rogue {
                //! Transmit count
                uint32_t count_;
 
+               //! Selectively acknowledged by the remote
+               bool sacked_;
+
             public:
 
                //! Create
@@ -89,6 +92,12 @@ namespace rogue {
                //! Reset tx time
                void rstTime();
 
+               //! Set selectively acknowledged state
+               void setSacked(bool sacked);
+
+               //! Get selectively acknowledged state
+               bool getSacked();
+
                //! Dump message contents
                std::string dump();
 
@@ -107,11 +116,14 @@ namespace rogue {
                //! Busy flag
                bool busy;
 
-               //! Sequence number
-               uint8_t sequence;
+               //! Eack flag, out of order sequence list follows the header
+               bool eack;
+
+               //! Sequence number, upper byte is only used with the window extension
+               uint16_t sequence;
 
-               //! Acknowledge number
-               uint8_t acknowledge;
+               //! Acknowledge number, upper byte is only used with the window extension
+               uint16_t acknowledge;
 
                //! Version field
                uint8_t version;
@@ -146,6 +158,15 @@ namespace rogue {
                //! Connection ID
                uint32_t connectionId;
 
+               //! Window extension request, Rogue to Rogue links only
+               bool windowExt;
+
+               //! MAX Outstanding Segments with window extension
+               uint16_t maxOutstandingSegmentsExt;
+
+               //! Selective acknowledgement request, Rogue to Rogue links only
+               bool sack;
+
          };
 
          // Convienence
@@ -43,6 +43,9 @@ namespace rogue {
                //! Thread background
                void runThread();
 
+               //! Receive and forward one batch of datagrams
+               bool rxService();
+
             public:
 
                //! Class creation
@@ -17,12 +17,24 @@
 #ifndef __ROGUE_PROTOCOLS_UDP_CORE_H__
 #define __ROGUE_PROTOCOLS_UDP_CORE_H__
 #include <rogue/Logging.h>
+#include <rogue/protocols/udp/Reactor.h>
+#include <rogue/interfaces/stream/Frame.h>
+#include <rogue/interfaces/stream/Pool.h>
 #include <stdint.h>
+#include <vector>
+#include <atomic>
 #include <netdb.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netinet/ip.h>
 
+#ifdef __MACH__
+struct mmsghdr {
+   struct msghdr msg_hdr;
+   unsigned int  msg_len;
+};
+#endif
+
 namespace rogue {
    namespace protocols {
       namespace udp {
@@ -33,8 +45,27 @@ namespace rogue {
          const uint32_t JumboMTU = 9000;
          const uint32_t StdMTU   = 1500;
 
+         //! Maximum number of datagrams per receive call
+         const uint32_t RxBatchSize = 64;
+
+         //! Maximum number of datagrams per transmit call
+         const uint32_t TxBatchSize = 64;
+
+         //! Maximum number of datagrams in a segmentation offload super buffer
+         const uint32_t GsoMaxSegments = 64;
+
+         //! Maximum size of a segmentation offload super buffer
+         const uint32_t GsoMaxSize = 65000;
+
+         //! Maximum number of coalesced reads per receive call
+         const uint32_t GroBatchSize = 8;
+
+         //! Receive buffer size for coalesced reads
+         const uint32_t GroBufferSize = 65536;
+
          //! UDP Core
          class Core {
+            friend class Reactor;
 
             protected:
 
@@ -53,11 +84,69 @@ namespace rogue {
                struct timeval timeout_;
 
                std::thread* thread_;
-               bool threadEn_;
+               std::atomic<bool> threadEn_;
 
                //! mutex
                std::mutex udpMtx_;
 
+               //! Pipe used to wake the receive thread
+               int32_t wakeFd_[2];
+
+               //! Transmit all buffers in a frame to the passed address, batched
+               void txFrame(std::shared_ptr<rogue::interfaces::stream::Frame> frame, struct sockaddr_in * addr);
+
+               //! Transmit segmentation offload enable
+               bool gso_;
+
+               //! Receive coalescing enable
+               bool gro_;
+
+               //! Per socket receive state
+               struct RxContext {
+
+                  //! Socket
+                  int32_t fd;
+
+                  //! Preallocated receive frames, one per datagram
+                  std::vector< std::shared_ptr<rogue::interfaces::stream::Frame> > slot;
+
+                  //! Receive buffers for coalesced reads, allocated on first use
+                  std::vector<uint8_t> groBuf;
+               };
+
+               //! Receive state for the primary socket
+               RxContext rx_;
+
+               //! Receive a batch of datagrams without blocking, returns count or error
+               int32_t rxBatch(int32_t fd, struct mmsghdr * msgs, uint32_t count);
+
+               //! Receive a batch of frames without blocking, one per datagram
+               /** Frames are allocated from the passed pool. Coalesced reads are split back
+                * into individual datagrams. The address of the most recent sender is stored
+                * in addr if it is not NULL. Returns the number of frames appended.
+                */
+               uint32_t rxFrames(RxContext & ctx, rogue::interfaces::stream::Pool * pool,
+                                 std::vector< std::shared_ptr<rogue::interfaces::stream::Frame> > & frames,
+                                 struct sockaddr_in * addr);
+
+               //! Block until receive data is available, returns false if woken for stop
+               bool rxWait(int32_t fd);
+
+               //! Wake the receive thread
+               void rxWake();
+
+               //! Consume pending wake requests
+               void rxDrain();
+
+               //! Set receive coalescing option on a socket
+               bool setSocketGro(int32_t fd, bool enable);
+
+               //! Shared reactor, replaces the receive thread when set
+               std::shared_ptr<rogue::protocols::udp::Reactor> reactor_;
+
+               //! Receive and forward one batch of datagrams, returns false if none were available
+               virtual bool rxService() = 0;
+
             public:
 
                //! Setup class in python
@@ -67,7 +156,7 @@ namespace rogue {
                Core(bool jumbo);
 
                //! Destructor
-               ~Core();
+               virtual ~Core();
 
                //! Stop the interface
                void stop();
@@ -80,6 +169,33 @@ namespace rogue {
 
                //! Set timeout for frame transmits in microseconds
                void setTimeout(uint32_t timeout);
+
+               //! Enable or disable transmit segmentation offload (UDP_SEGMENT)
+               /** Runs of equal size buffers in a frame are sent as a single super buffer
+                * which the kernel splits into datagrams. Returns false if the kernel does
+                * not support segmentation offload, in which case it remains disabled. It is
+                * also disabled automatically if a segmented transmit fails.
+                */
+               bool setGso(bool enable);
+
+               //! Get transmit segmentation offload state
+               bool getGso();
+
+               //! Enable or disable receive coalescing (UDP_GRO)
+               /** Coalesced reads are split back into one frame per datagram. Returns false
+                * if the kernel does not support receive coalescing, in which case it remains
+                * disabled.
+                */
+               virtual bool setGro(bool enable);
+
+               //! Get receive coalescing state
+               bool getGro();
+
+               //! Attach to a shared reactor
+               /** The dedicated receive thread is stopped and the socket is serviced by
+                * the reactor threads from then on. An endpoint can only be attached once.
+                */
+               virtual void setReactor(std::shared_ptr<rogue::protocols::udp::Reactor> reactor);
          };
 
          // Convenience
@@ -0,0 +1,112 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : UDP Shared Reactor
+ * ----------------------------------------------------------------------------
+ * File       : Reactor.h
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Shared receive reactor which services multiple UDP endpoints.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_PROTOCOLS_UDP_REACTOR_H__
+#define __ROGUE_PROTOCOLS_UDP_REACTOR_H__
+#include <rogue/Logging.h>
+#include <stdint.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <map>
+#include <memory>
+
+namespace rogue {
+   namespace protocols {
+      namespace udp {
+
+         class Core;
+
+         //! UDP Reactor
+         /** A Reactor services the receive side of multiple UDP Client and Server
+          * endpoints from a small pool of threads. Endpoints attach with Core::setReactor(),
+          * which replaces their dedicated receive thread. Each ready socket is drained with
+          * one batched receive call per wakeup, and a socket is serviced by at most one
+          * reactor thread at a time.
+          */
+         class Reactor {
+
+               // Registered endpoint
+               struct Entry {
+                  rogue::protocols::udp::Core * core;
+                  bool busy;
+                  bool removed;
+               };
+
+               // Logging
+               std::shared_ptr<rogue::Logging> log_;
+
+               // Event file descriptor
+               int32_t efd_;
+
+               // Pipe used to stop threads
+               int32_t stopFd_[2];
+
+               // Registered endpoints by socket
+               std::map<int32_t, Entry> entries_;
+
+               // Service threads
+               std::vector<std::thread *> threads_;
+
+               // Run enable
+               bool threadEn_;
+
+               // Lock
+               std::mutex mtx_;
+
+               // Condition for removal of busy endpoints
+               std::condition_variable cond_;
+
+               // Thread background
+               void runThread();
+
+            public:
+
+               //! Class creation
+               static std::shared_ptr<rogue::protocols::udp::Reactor> create (uint32_t threads);
+
+               //! Setup class in python
+               static void setup_python();
+
+               //! Creator
+               Reactor(uint32_t threads);
+
+               //! Destructor
+               ~Reactor();
+
+               //! Stop the reactor threads
+               void stop();
+
+               //! Attach an endpoint
+               void add(rogue::protocols::udp::Core * core);
+
+               //! Detach an endpoint, waits for any in progress service to complete
+               void remove(rogue::protocols::udp::Core * core);
+
+               //! Get the number of attached endpoints
+               uint32_t getCount();
+         };
+
+         // Convenience
+         typedef std::shared_ptr<rogue::protocols::udp::Reactor> ReactorPtr;
+      }
+   }
+};
+
+#endif
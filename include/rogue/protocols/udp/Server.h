@@ -18,8 +18,10 @@
 #define __ROGUE_PROTOCOLS_UDP_SERVER_H__
 #include <rogue/interfaces/stream/Master.h>
 #include <rogue/interfaces/stream/Slave.h>
+#include <rogue/protocols/udp/ServerShard.h>
 #include <rogue/Logging.h>
 #include <thread>
+#include <vector>
 #include <stdint.h>
 #include <netdb.h>
 #include <sys/socket.h>
@@ -34,6 +36,7 @@ namespace rogue {
          class Server : public rogue::protocols::udp::Core,
                         public rogue::interfaces::stream::Master,
                         public rogue::interfaces::stream::Slave {
+            friend class ServerShard;
 
                //! Local port number
                uint16_t port_;
@@ -41,20 +44,57 @@ namespace rogue {
                //! Local socket address
                struct sockaddr_in locAddr_;
 
+               //! Receive state for additional shard sockets
+               std::vector<rogue::protocols::udp::Core::RxContext> shards_;
+
+               //! Threads for additional shard sockets
+               std::vector<std::thread *> shardThreads_;
+
+               //! Stream endpoints for additional shard sockets
+               std::vector<rogue::protocols::udp::ServerShardPtr> shardPorts_;
+
                //! Thread background
                void runThread();
 
+               //! Thread background for additional shard sockets
+               void runShard(uint32_t idx);
+
+               //! Receive and forward one batch of datagrams
+               bool rxService();
+
+               //! Receive and forward one batch of datagrams from an additional shard socket
+               bool rxShard(uint32_t idx);
+
+               //! Transmit a frame to the passed address
+               void txShard(std::shared_ptr<rogue::interfaces::stream::Frame> frame, struct sockaddr_in * addr);
+
+               //! Create and bind a socket
+               int32_t openSocket(bool reuse);
+
+               //! Attach steering program keyed on source address and port
+               void attachSteering();
+
             public:
 
                //! Class creation
                static std::shared_ptr<rogue::protocols::udp::Server>
-                  create (uint16_t port, bool jumbo);
+                  create (uint16_t port, bool jumbo, uint32_t shards=1);
 
                //! Setup class in python
                static void setup_python();
 
                //! Creator
-               Server(uint16_t port, bool jumbo);
+               /** When shards is greater than one, shards sockets are bound to the port with
+                * SO_REUSEPORT, each with its own receive thread. Datagrams are steered to a
+                * socket by source address and port so that the order from each source is
+                * preserved, while sources are spread across threads.
+                *
+                * Shard 0 is the server itself. Each additional shard is a separate stream
+                * endpoint returned by getShard(). Every endpoint outputs the frames received by
+                * its own socket and sends the frames it accepts to the most recent sender on
+                * that socket, so a reply is returned to a source on the shard it arrived on.
+                */
+               Server(uint16_t port, bool jumbo, uint32_t shards=1);
 
                //! Destructor
                ~Server();
@@ -65,6 +105,26 @@ namespace rogue {
                //! Get port number
                uint32_t getPort();
 
+               //! Get the number of receive shards
+               uint32_t getShardCount();
+
+               //! Get the stream endpoint of an additional shard
+               /** Valid shard indexes are 1 to getShardCount() - 1, shard 0 is the server itself.
+                */
+               std::shared_ptr<rogue::protocols::udp::ServerShard> getShard(uint32_t shard);
+
+               //! Pin the receive thread of a shard to a CPU
+               bool setShardCpu(uint32_t shard, uint32_t cpu);
+
+               //! Enable or disable receive coalescing on all shard sockets
+               bool setGro(bool enable);
+
+               //! Attach to a shared reactor
+               /** Only supported with a single shard, a sharded server keeps its
+                * receive threads.
+                */
+               void setReactor(std::shared_ptr<rogue::protocols::udp::Reactor> reactor);
+
                //! Accept a frame from master
                void acceptFrame ( std::shared_ptr<rogue::interfaces::stream::Frame> frame );
          };
@@ -0,0 +1,94 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : UDP Server Shard
+ * ----------------------------------------------------------------------------
+ * File       : ServerShard.h
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Stream endpoint for an additional receive shard of a UDP Server.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_PROTOCOLS_UDP_SERVER_SHARD_H__
+#define __ROGUE_PROTOCOLS_UDP_SERVER_SHARD_H__
+#include <rogue/interfaces/stream/Master.h>
+#include <rogue/interfaces/stream/Slave.h>
+#include <stdint.h>
+#include <mutex>
+#include <memory>
+#include <netinet/in.h>
+
+namespace rogue {
+   namespace protocols {
+      namespace udp {
+
+         class Server;
+
+         //! UDP Server Shard
+         /** A ServerShard is the stream endpoint for one of the additional receive sockets
+          * of a sharded Server. Frames received by the shard socket are output on its Master
+          * interface. Frames passed to its Slave interface are sent to the most recent sender
+          * received by that shard socket.
+          *
+          * ServerShard objects are created by the Server and returned by Server::getShard().
+          * Frames passed to a shard after the Server has been stopped are dropped.
+          */
+         class ServerShard : public rogue::interfaces::stream::Master,
+                             public rogue::interfaces::stream::Slave {
+            friend class Server;
+
+               //! Owning server, NULL once the server has been stopped
+               rogue::protocols::udp::Server * server_;
+
+               //! Shard index
+               uint32_t index_;
+
+               //! Remote socket address
+               struct sockaddr_in remAddr_;
+
+               //! Remote address and server lock
+               std::mutex mtx_;
+
+               //! Update the remote address from a received datagram
+               void setRemote(struct sockaddr_in * addr);
+
+               //! Detach from the server
+               void close();
+
+            public:
+
+               //! Class creation
+               static std::shared_ptr<rogue::protocols::udp::ServerShard>
+                  create (rogue::protocols::udp::Server * server, uint32_t index);
+
+               //! Setup class in python
+               static void setup_python();
+
+               //! Creator
+               ServerShard(rogue::protocols::udp::Server * server, uint32_t index);
+
+               //! Destructor
+               ~ServerShard();
+
+               //! Get shard index
+               uint32_t getIndex();
+
+               //! Accept a frame from master
+               void acceptFrame ( std::shared_ptr<rogue::interfaces::stream::Frame> frame );
+         };
+
+         // Convenience
+         typedef std::shared_ptr<rogue::protocols::udp::ServerShard> ServerShardPtr;
+
+      }
+   }
+};
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title         : CRC-32 Checksum Library
+ *-----------------------------------------------------------------------------
+ * Description :
+ *    CRC-32 (IEEE 802.3, reflected 0xEDB88320) with table, slicing-by-16
+ *    and carry-less multiply / CRC instruction implementations selected at
+ *    run time.
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_UTILITIES_CRC32_H__
+#define __ROGUE_UTILITIES_CRC32_H__
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#ifndef NO_PYTHON
+#include <boost/python.hpp>
+#endif
+
+namespace rogue {
+   namespace utilities {
+
+      //! CRC-32 checksum
+      /*
+       * Computes the CRC-32 used by the packetizer and zlib. The crc argument is the
+       * result of a previous call, allowing a checksum to be continued across buffers.
+       * Passing zero starts a new checksum. All implementations are bit exact.
+       */
+      class Crc32 {
+         public:
+
+            //! Implementations
+            enum Impl : uint32_t { Auto    = 0,   // Fastest supported
+                                   Table   = 1,   // Byte at a time table
+                                   Slice16 = 2,   // Slicing by 16
+                                   Clmul   = 3,   // x86 PCLMULQDQ folding
+                                   ArmCrc  = 4 }; // ARMv8 CRC32 instructions
+
+            //! Setup class in python
+            static void setup_python();
+
+            //! Compute with the fastest supported implementation
+            static uint32_t compute(const uint8_t *data, size_t size, uint32_t crc=0);
+
+            //! Compute with a specific implementation
+            static uint32_t compute(uint32_t impl, const uint8_t *data, size_t size, uint32_t crc=0);
+
+            //! Return true if implementation is supported by this cpu
+            static bool supported(uint32_t impl);
+
+            //! Get the name of the implementation selected by Auto
+            static std::string implName();
+
+#ifndef NO_PYTHON
+            //! Compute over a python buffer
+            static uint32_t computePy(boost::python::object p, uint32_t crc);
+
+            //! Compute over a python buffer with a specific implementation
+            static uint32_t computeImplPy(uint32_t impl, boost::python::object p, uint32_t crc);
+#endif
+      };
+   }
+}
+
+#endif
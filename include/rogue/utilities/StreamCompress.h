@@ -0,0 +1,152 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title         : Rogue stream compressor, LZ4 and Zstd
+ * ----------------------------------------------------------------------------
+ * File          : StreamCompress.h
+ *-----------------------------------------------------------------------------
+ * Description :
+ *    Stream module to compress a data stream with LZ4 or Zstd. Each frame
+ *    is compressed on its own, Zstd frames use the standard Zstd frame
+ *    format. LZ4 frames start with a 12 byte header:
+ *
+ *       [31:0] = Magic (0x345A4C52, "RLZ4")
+ *       [31:0] = Uncompressed size in bytes
+ *       [31:0] = CRC-32 of the dictionary, zero when no dictionary is used
+ *
+ *    followed by a single LZ4 block.
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_UTILITIES_STREAM_COMPRESS_H__
+#define __ROGUE_UTILITIES_STREAM_COMPRESS_H__
+#include <stdint.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <rogue/interfaces/stream/Slave.h>
+#include <rogue/interfaces/stream/Master.h>
+#include <rogue/Logging.h>
+#include <rogue/WorkerPool.h>
+
+namespace rogue {
+   namespace utilities {
+
+      //! Stream compressor, LZ4 and Zstd
+      /*
+       * Compression contexts are kept in a pool and reused across frames. With
+       * workers enabled frames are compressed on a pool of threads and sent
+       * in the order they were received.
+       */
+      class StreamCompress : public rogue::interfaces::stream::Slave, public rogue::interfaces::stream::Master {
+
+         public:
+
+            //! Codecs
+            enum Codec : uint32_t { Lz4  = 0,
+                                    Zstd = 1 };
+
+            //! LZ4 frame header
+            static const uint32_t Lz4Magic  = 0x345A4C52;
+            static const uint32_t Lz4Header = 12;
+
+            //! Dictionary, defined in StreamCompress.cpp
+            struct Dict;
+
+            //! Compression context, defined in StreamCompress.cpp
+            struct Context;
+
+         private:
+
+            std::shared_ptr<rogue::Logging> log_;
+
+            //! Codec and level
+            uint32_t codec_;
+            int32_t  level_;
+
+            //! Current dictionary, null when not used
+            std::shared_ptr<rogue::utilities::StreamCompress::Dict> dict_;
+
+            //! Context pool, contexts with an old generation are discarded
+            std::vector<rogue::utilities::StreamCompress::Context *> free_;
+            uint32_t gen_;
+            std::mutex ctxMtx_;
+
+            //! Byte counters
+            std::atomic<uint64_t> inBytes_;
+            std::atomic<uint64_t> outBytes_;
+
+            //! Worker pool, inactive when compressing in the caller's thread, frames are sent in dispatch order
+            rogue::WorkerPool<std::shared_ptr<rogue::interfaces::stream::Frame>> workers_;
+            std::mutex mtx_;
+
+            //! Get a context from the pool
+            rogue::utilities::StreamCompress::Context * getContext();
+
+            //! Return a context to the pool
+            void putContext(rogue::utilities::StreamCompress::Context * ctx);
+
+            //! Compress a frame
+            std::shared_ptr<rogue::interfaces::stream::Frame> compress (
+                  rogue::utilities::StreamCompress::Context * ctx,
+                  std::shared_ptr<rogue::interfaces::stream::Frame> frame );
+
+            //! Worker thread
+            void runWorker();
+
+         public:
+
+            //! Class creation
+            static std::shared_ptr<rogue::utilities::StreamCompress> create (uint32_t codec, int32_t level=1);
+
+            //! Setup class in python
+            static void setup_python();
+
+            //! Creator, level is the Zstd level or the LZ4 acceleration
+            StreamCompress(uint32_t codec, int32_t level=1);
+
+            //! Deconstructor
+            ~StreamCompress();
+
+            //! Set level, Zstd level or LZ4 acceleration
+            void setLevel(int32_t level);
+
+            //! Get level
+            int32_t getLevel();
+
+            //! Load a dictionary file, an empty name disables the dictionary
+            void setDictionary(std::string file);
+
+            //! Set number of worker threads, 0 compresses in the caller's thread
+            void setWorkers(uint32_t count);
+
+            //! Get number of worker threads
+            uint32_t getWorkers();
+
+            //! Get number of bytes received
+            uint64_t getInBytes();
+
+            //! Get number of bytes sent
+            uint64_t getOutBytes();
+
+            //! Accept a frame from master
+            void acceptFrame ( std::shared_ptr<rogue::interfaces::stream::Frame> frame );
+
+            //! Accept a new frame request
+            std::shared_ptr<rogue::interfaces::stream::Frame> acceptReq ( uint32_t size, bool zeroCopyEn );
+      };
+
+      // Convienence
+      typedef std::shared_ptr<rogue::utilities::StreamCompress> StreamCompressPtr;
+   }
+}
+#endif
+
@@ -0,0 +1,129 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title         : Rogue stream decompressor, LZ4 and Zstd
+ * ----------------------------------------------------------------------------
+ * File          : StreamDecompress.h
+ *-----------------------------------------------------------------------------
+ * Description :
+ *    Stream module to decompress a data stream compressed by StreamCompress.
+ *    The codec is detected from the start of each frame.
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_UTILITIES_STREAM_DECOMPRESS_H__
+#define __ROGUE_UTILITIES_STREAM_DECOMPRESS_H__
+#include <stdint.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <rogue/interfaces/stream/Slave.h>
+#include <rogue/interfaces/stream/Master.h>
+#include <rogue/Logging.h>
+#include <rogue/WorkerPool.h>
+
+namespace rogue {
+   namespace utilities {
+
+      //! Stream decompressor, LZ4 and Zstd
+      /*
+       * Decompression contexts are kept in a pool and reused across frames. With
+       * workers enabled frames are decompressed on a pool of threads and sent
+       * in the order they were received.
+       */
+      class StreamDecompress : public rogue::interfaces::stream::Slave, public rogue::interfaces::stream::Master {
+
+         public:
+
+            //! Dictionary, defined in StreamDecompress.cpp
+            struct Dict;
+
+            //! Decompression context, defined in StreamDecompress.cpp
+            struct Context;
+
+         private:
+
+            std::shared_ptr<rogue::Logging> log_;
+
+            //! Current dictionary, null when not used
+            std::shared_ptr<rogue::utilities::StreamDecompress::Dict> dict_;
+
+            //! Context pool, contexts with an old generation are discarded
+            std::vector<rogue::utilities::StreamDecompress::Context *> free_;
+            uint32_t gen_;
+            std::mutex ctxMtx_;
+
+            //! Default max decompressed frame size
+            static const uint32_t DefaultMaxSize = 0x10000000;
+
+            //! Frames which decompress to more than this are rejected
+            std::atomic<uint32_t> maxSize_;
+
+            //! Worker pool, inactive when decompressing in the caller's thread, frames are sent in dispatch order
+            rogue::WorkerPool<std::shared_ptr<rogue::interfaces::stream::Frame>> workers_;
+            std::mutex mtx_;
+
+            //! Get a context from the pool
+            rogue::utilities::StreamDecompress::Context * getContext();
+
+            //! Return a context to the pool
+            void putContext(rogue::utilities::StreamDecompress::Context * ctx);
+
+            //! Decompress a frame
+            std::shared_ptr<rogue::interfaces::stream::Frame> decompress (
+                  rogue::utilities::StreamDecompress::Context * ctx,
+                  std::shared_ptr<rogue::interfaces::stream::Frame> frame );
+
+            //! Worker thread
+            void runWorker();
+
+         public:
+
+            //! Class creation
+            static std::shared_ptr<rogue::utilities::StreamDecompress> create ();
+
+            //! Setup class in python
+            static void setup_python();
+
+            //! Creator
+            StreamDecompress();
+
+            //! Deconstructor
+            ~StreamDecompress();
+
+            //! Load a dictionary file, an empty name disables the dictionary
+            void setDictionary(std::string file);
+
+            //! Set number of worker threads, 0 decompresses in the caller's thread
+            void setWorkers(uint32_t count);
+
+            //! Get number of worker threads
+            uint32_t getWorkers();
+
+            //! Set max decompressed frame size in bytes, larger frames are rejected
+            void setMaxSize(uint32_t size);
+
+            //! Get max decompressed frame size in bytes
+            uint32_t getMaxSize();
+
+            //! Accept a frame from master
+            void acceptFrame ( std::shared_ptr<rogue::interfaces::stream::Frame> frame );
+
+            //! Accept a new frame request
+            std::shared_ptr<rogue::interfaces::stream::Frame> acceptReq ( uint32_t size, bool zeroCopyEn );
+      };
+
+      // Convienence
+      typedef std::shared_ptr<rogue::utilities::StreamDecompress> StreamDecompressPtr;
+   }
+}
+#endif
+
@@ -0,0 +1,121 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title         : Data file index
+ *-----------------------------------------------------------------------------
+ * Description :
+ *    Sidecar index for data files written by StreamWriter. The index is
+ *    stored as <name>.idx, where <name> is the file name passed to
+ *    StreamWriter::open(). The file starts with two 32-bit words:
+ *
+ *       [31:0] = Magic (0x58444952, "RIDX")
+ *       [31:0] = Version
+ *
+ *    followed by one 32 byte entry per frame, in the order frames were
+ *    written:
+ *
+ *       [63:0] = Frame number
+ *       [63:0] = Byte offset of frame header within the data file
+ *       [31:0] = Length of data block in bytes (headerA)
+ *       [31:0] = Channel, error and flags (headerB)
+ *       [31:0] = Data file index, zero when the data set is not split
+ *       [31:0] = Microseconds since the previous frame was written
+ *
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#ifndef __ROGUE_UTILITIES_FILEIO_STREAM_INDEX_H__
+#define __ROGUE_UTILITIES_FILEIO_STREAM_INDEX_H__
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef NO_PYTHON
+#include <boost/python.hpp>
+#endif
+
+namespace rogue {
+   namespace utilities {
+      namespace fileio {
+
+         //! Data file index
+         class StreamIndex {
+            public:
+
+               //! Index file header
+               static const uint32_t Magic   = 0x58444952;
+               static const uint32_t Version = 1;
+
+               //! Index entry
+               struct Entry {
+                  uint64_t frame;
+                  uint64_t offset;
+                  uint32_t size;
+                  uint32_t meta;
+                  uint32_t file;
+                  uint32_t time;
+               };
+
+            private:
+
+               //! Entries in frame order
+               std::vector<rogue::utilities::fileio::StreamIndex::Entry> entries_;
+
+            public:
+
+               //! Class creation
+               static std::shared_ptr<rogue::utilities::fileio::StreamIndex> create ();
+
+               //! Setup class in python
+               static void setup_python();
+
+               //! Creator
+               StreamIndex();
+
+               //! Get the base name and first file index for a data file name
+               static std::string baseName(std::string file, uint32_t & idx);
+
+               //! Get the data file name for a base name and file index
+               static std::string fileName(std::string base, uint32_t idx);
+
+               //! Get the index file name for a data file name
+               static std::string indexName(std::string file);
+
+               //! Write the index file header
+               static bool writeHeader(int32_t fd);
+
+               //! Scan data files and write a new index, returns the number of frames
+               static uint64_t rebuild(std::string file);
+
+               //! Load the index for a data file, returns false if there is no valid index
+               bool load(std::string file);
+
+               //! Get number of entries
+               uint64_t getCount();
+
+               //! Get an entry
+               const rogue::utilities::fileio::StreamIndex::Entry & entry(uint64_t pos);
+
+               //! Get position of the first entry at or after a frame number
+               uint64_t find(uint64_t frame);
+
+#ifndef NO_PYTHON
+               //! Get an entry as (frame, channel, file, offset, size, flags, error)
+               boost::python::tuple getEntryPy(uint64_t pos);
+#endif
+         };
+
+         // Convenience
+         typedef std::shared_ptr<rogue::utilities::fileio::StreamIndex> StreamIndexPtr;
+      }
+   }
+}
+#endif
+
@@ -17,18 +17,42 @@
 #ifndef __ROGUE_UTILITIES_FILEIO_STREAM_READER_H__
 #define __ROGUE_UTILITIES_FILEIO_STREAM_READER_H__
 #include <rogue/interfaces/stream/Master.h>
+#include <rogue/interfaces/stream/Pool.h>
+#include <rogue/utilities/fileio/StreamIndex.h>
+#include <rogue/Logging.h>
+#include <rogue/Queue.h>
 #include <thread>
+#include <atomic>
 #include <stdint.h>
 #include <mutex>
 #include <condition_variable>
 #include <map>
+#include <bitset>
+#include <chrono>
+#include <vector>
 
 namespace rogue {
    namespace utilities {
       namespace fileio {
 
          //! Stream writer central class
-         class StreamReader : public rogue::interfaces::stream::Master {
+         class StreamReader : public rogue::interfaces::stream::Master,
+                              public rogue::interfaces::stream::Pool {
+
+               //! Memory mapped window of a data file
+               struct Mapping {
+                  uint8_t * data;
+                  size_t    size;
+
+                  Mapping(uint8_t * data, size_t size);
+                  ~Mapping();
+               };
+
+               //! Size of each mapped window, a larger frame is mapped on its own
+               static const uint64_t MapSize = 1024*1024*1024;
+
+               //! Read advice window for memory mapped files
+               static const uint32_t MapAhead = 64*1024*1024;
 
                //! Base file name
                std::string baseName_;
@@ -39,19 +63,119 @@ namespace rogue {
                //! File index
                uint32_t fdIdx_;
 
+               //! Index of first file, zero when the data set is not split
+               uint32_t firstIdx_;
+
+               //! Sidecar index, empty if the data set has none
+               std::shared_ptr<rogue::utilities::fileio::StreamIndex> index_;
+
+               //! First frame to read and frame to stop at, zero for no limit
+               uint64_t start_;
+               uint64_t end_;
+
+               //! Channels to read when filter is enabled
+               std::bitset<256> filter_;
+               bool filterEn_;
+
+               //! Frame number of next frame in sequential reads
+               uint64_t frame_;
+
+               //! Emit frames from memory mapped files
+               bool mapped_;
+
+               //! Mappings referenced by zero copy buffers
+               std::vector<std::shared_ptr<rogue::utilities::fileio::StreamReader::Mapping>> slots_;
+               std::vector<uint32_t> free_;
+               std::mutex slotMtx_;
+
+               //! Fixed replay rate in frames per second, zero to disable
+               double rate_;
+
+               //! Replay speed relative to original timing, zero to disable
+               double timing_;
+
+               //! Send time of next frame
+               std::chrono::steady_clock::time_point next_;
+
+               //! Size of each prefetch request and of each prefetch read
+               static const uint64_t PrefetchSize = 64*1024*1024;
+               static const uint32_t PrefetchRead = 4*1024*1024;
+
+               //! Byte range of a data file to prefetch
+               struct Prefetch {
+                  uint32_t file;
+                  uint64_t offset;
+                  uint64_t size;
+                  bool     valid;
+
+                  Prefetch() : file(0), offset(0), size(0), valid(false) { }
+               };
+
+               //! Number of files to prefetch beyond the current file, zero to disable
+               uint32_t prefetchDepth_;
+
+               //! Number of prefetch threads
+               uint32_t prefetchThreads_;
+
+               //! Next file to queue for prefetch, set when the data set ends
+               uint32_t prefetchNext_;
+               bool prefetchEnd_;
+
+               //! Prefetch queue and threads
+               std::shared_ptr<rogue::Queue<rogue::utilities::fileio::StreamReader::Prefetch>> prefetchQueue_;
+               std::vector<std::thread *> prefetchWorkers_;
+
+               //! Bytes read into the page cache by the prefetch threads since open
+               std::atomic<uint64_t> prefetchBytes_;
+
+               //! Start prefetch threads
+               void startPrefetch();
+
+               //! Stop prefetch threads
+               void stopPrefetch();
+
+               //! Queue files for prefetch up to the depth beyond a file
+               void prefetch(uint32_t idx);
+
+               //! Prefetch thread
+               void runPrefetch();
+
                //! Active
                bool active_;
 
                //! Read thread
                std::thread* readThread_;
-               bool threadEn_;
+               std::atomic<bool> threadEn_;
 
                //! Thread background
                void runThread();
 
+               //! Read frames sequentially from the data files
+               bool readFiles(rogue::Logging & log);
+
+               //! Read frames located with the index
+               void readIndex(rogue::Logging & log);
+
+               //! Read frames from memory mapped data files
+               void readMapped(rogue::Logging & log);
+
+               //! Read frame data at the current file position
+               bool readFrame(uint32_t size, uint32_t meta, rogue::Logging & log);
+
+               //! Create a frame referencing a memory mapped file
+               std::shared_ptr<rogue::interfaces::stream::Frame> mapFrame(
+                     std::shared_ptr<rogue::utilities::fileio::StreamReader::Mapping> map,
+                     uint64_t offset, uint32_t size, uint32_t meta);
+
+               //! Replay pacing, called for each frame in range
+               void pace(uint64_t frame, bool send);
+
                //! Open file
                bool nextFile();
 
+               //! Open first file and start read thread
+               void intStart();
+
                //! Internal close
                void intClose();
 
@@ -89,6 +213,48 @@ namespace rogue {
 
                //! Return true while reading
                bool isActive();
+
+               //! Set frame range for the next open or seek, zero count reads to the end
+               void setRange(uint64_t first, uint64_t count);
+
+               //! Restart reading at a frame number
+               void seek(uint64_t frame);
+
+               //! Add a channel to the filter, only filtered channels are read
+               void filterChannel(uint8_t channel);
+
+               //! Clear the channel filter
+               void clearFilter();
+
+               //! Get number of frames in the index, zero when there is no index
+               uint64_t getIndexCount();
+
+               //! Emit frames referencing memory mapped files instead of copying
+               void setMapped(bool mapped);
+
+               //! Set fixed replay rate in frames per second, zero to disable
+               void setRate(double rate);
+
+               //! Set replay speed relative to the original timing in the index, zero to disable
+               void setTiming(double speed);
+
+               //! Set number of files to prefetch beyond the current file, zero to disable
+               void setPrefetchDepth(uint32_t depth);
+
+               //! Get number of files to prefetch beyond the current file
+               uint32_t getPrefetchDepth();
+
+               //! Set number of prefetch threads
+               void setPrefetchThreads(uint32_t count);
+
+               //! Get number of prefetch threads
+               uint32_t getPrefetchThreads();
+
+               //! Get number of bytes prefetched since the last open
+               uint64_t getPrefetchBytes();
+
+               //! Return a buffer, releasing mapped files for zero copy buffers
+               void retBuffer(uint8_t * data, uint32_t meta, uint32_t size);
          };
 
          // Convenience
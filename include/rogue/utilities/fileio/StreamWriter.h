@@ -36,9 +36,15 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <chrono>
 #include <rogue/Logging.h>
 #include <rogue/EnableSharedFromThis.h>
+#include <rogue/Queue.h>
+#include <rogue/utilities/fileio/StreamIndex.h>
+#include <vector>
 #include <map>
+#include <sys/uio.h>
 
 namespace rogue {
    namespace utilities {
@@ -74,7 +80,7 @@ namespace rogue {
                uint64_t currSize_;
 
                //! Total file size in bytes
-               uint32_t totSize_;
+               uint64_t totSize_;
 
                //! Buffering size to cache file writes, zero if disabled
                uint32_t buffSize_;
@@ -108,6 +114,125 @@ namespace rogue {
 
                std::map<uint32_t,std::shared_ptr<rogue::utilities::fileio::StreamWriterChannel>> channelMap_;
 
+               //! Alignment of staging buffers and direct I/O writes
+               static const uint32_t DirectAlign = 4096;
+
+               //! Default staging buffer size in asynchronous mode
+               static const uint32_t AsyncBuffSize = 4*1024*1024;
+
+               //! Staging buffer queued for the I/O thread
+               struct AsyncReq {
+                  uint8_t * data;
+                  uint32_t  size;
+                  int32_t   fd;
+                  bool      last;
+
+                  AsyncReq() : data(NULL), size(0), fd(-1), last(false) { }
+               };
+
+               //! Number of staging buffers, zero when writing in the caller's thread
+               uint32_t asyncCount_;
+
+               //! Use O_DIRECT for asynchronous writes
+               bool direct_;
+
+               //! Drop frames instead of blocking when no staging buffer is free
+               bool dropFull_;
+
+               //! Dropped frame count
+               uint32_t dropCount_;
+
+               //! Free staging buffers and buffers queued or being written
+               std::vector<uint8_t *> ioFree_;
+               uint32_t ioPending_;
+               std::mutex ioMtx_;
+               std::condition_variable ioCond_;
+
+               //! I/O thread and queue, buffers are written one at a time
+               std::shared_ptr<rogue::Queue<rogue::utilities::fileio::StreamWriter::AsyncReq>> ioQueue_;
+               std::thread * ioThread_;
+
+               //! File descriptor of a failed asynchronous write, -1 when none
+               std::atomic<int32_t> ioErrorFd_;
+
+               //! Open a file for writing
+               int32_t openFile(std::string name);
+
+               //! Close current file, deferred to the I/O thread in asynchronous mode
+               void closeFile();
+
+               //! Start I/O thread and allocate staging buffers
+               void startAsync();
+
+               //! Drain and stop I/O thread, free staging buffers
+               void stopAsync();
+
+               //! Wait for queued staging buffers to be written
+               void drainAsync();
+
+               //! Get a free staging buffer
+               uint8_t * asyncBuffer();
+
+               //! Queue current staging buffer
+               void asyncFlush();
+
+               //! Write a staging buffer, called by I/O thread
+               bool ioWrite(rogue::utilities::fileio::StreamWriter::AsyncReq & req);
+
+               //! I/O thread
+               void runIo();
+
+               //! Buffers smaller than this are copied in vectored mode, larger ones are referenced
+               static const uint32_t VecCopySize = 4096;
+
+               //! Write frames with writev from the frame buffers
+               bool vectored_;
+
+               //! Pending write vector, entries point into the write buffer or held frame buffers
+               std::vector<struct iovec> iov_;
+
+               //! Frames referenced by the pending write vector
+               std::vector<std::shared_ptr<rogue::interfaces::stream::Frame>> iovFrames_;
+
+               //! Pending bytes referenced outside the write buffer
+               uint64_t iovRef_;
+
+               //! Header storage when there is no write buffer
+               uint32_t iovHdr_[2];
+
+               //! Index entries buffered before writing
+               static const uint32_t IndexBuffCount = 1024;
+
+               //! Write a sidecar index
+               bool index_;
+
+               //! Index file descriptor
+               int32_t idxFd_;
+
+               //! Next frame number in index
+               uint64_t idxFrame_;
+
+               //! Time of previous index entry
+               std::chrono::steady_clock::time_point idxTime_;
+
+               //! Buffered index entries
+               std::vector<rogue::utilities::fileio::StreamIndex::Entry> idxBuff_;
+
+               //! Data set is split into numbered files
+               bool split_;
+
+               //! Size of current file when opened
+               uint64_t fileBase_;
+
+               //! Write buffered index entries
+               void idxFlush();
+
+               //! Add data to the pending write vector, returns true if data is referenced
+               bool iovAdd(void *data, uint32_t size, bool copy);
+
+               //! Write the pending write vector
+               void iovFlush();
+
 
                //! Write data to file. Called from StreamWriterChannel
                virtual void writeFile ( uint8_t channel, std::shared_ptr<rogue::interfaces::stream::Frame> frame);
@@ -138,6 +263,24 @@ namespace rogue {
                //! Set buffering size, 0 to disable
                void setBufferSize(uint32_t size);
 
+               //! Set number of staging buffers for asynchronous writes, 0 to disable
+               void setAsync(uint32_t count);
+
+               //! Use O_DIRECT for asynchronous writes, applied when a file is opened
+               void setDirect(bool direct);
+
+               //! Drop frames instead of blocking when the disk falls behind
+               void setDropFull(bool drop);
+
+               //! Get count of frames dropped when the disk falls behind
+               uint32_t getDropCount();
+
+               //! Write frames with writev from the frame buffers instead of copying them
+               void setVectored(bool vectored);
+
+               //! Write a sidecar index, applied when a file is opened
+               void setIndex(bool index);
+
                //! Set max file size, 0 for unlimited
                void setMaxSize(uint64_t size);
 
@@ -107,6 +107,8 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
                  initRead=False,
                  initWrite=False,
                  pollEn=True,
+                 bulkDepth=0,
+                 updateBus=False,
                  serverPort=0,  # 9099 is the default, 0 for auto
                  sqlUrl=None,
                  maxLog=1000,
@@ -122,6 +124,8 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
         self._initRead        = initRead
         self._initWrite       = initWrite
         self._pollEn          = pollEn
+        self._bulkDepth       = bulkDepth
+        self._updateBusEn     = updateBus
         self._serverPort      = serverPort
         self._sqlUrl          = sqlUrl
         self._maxLog          = maxLog
@@ -144,6 +148,11 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
         # Polling worker
         self._pollQueue = self._pollQueue = pr.PollQueue(root=self)
 
+        # Bulk operation engine and the devices and blocks it does not service
+        self._bulk        = None
+        self._bulkDevices = []
+        self._bulkLocal   = []
+
         # Zeromq server
         self._zmqServer  = None
 
@@ -158,6 +167,11 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
         self._updateCount  = {}
         self._updateList   = {}
 
+        # Variable update bus, blocks publish updates here without the GIL
+        self._updateBus    = None
+        self._busVars      = {}
+        self._busThread    = None
+
         # SQL URL
         self._sqlLog = None
 
@@ -348,6 +362,14 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
             for key,value in self._nodes.items():
                 value._setTimeout(self._timeout)
 
+        # Setup bulk operation engine
+        if self._bulkDepth > 0:
+            bulkBlocks = []
+            self._bulkCollect(self, bulkBlocks)
+            self._bulk = rim.BulkOp(self._bulkDepth)
+            self._bulk.setBlocks(bulkBlocks)
+            self._log.info(f"Bulk operations for {len(bulkBlocks)} blocks across {self._bulk.getGroupCount()} slaves")
+
         # Start ZMQ server if enabled
         if self._serverPort is not None:
             self._zmqServer  = pr.interfaces.ZmqServer(root=self,addr="*",port=self._serverPort)
@@ -358,11 +380,26 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
         if self._sqlUrl is not None:
             self._sqlLog = pr.interfaces.SqlLogger(self._sqlUrl)
 
+        # Setup variable update bus
+        if self._updateBusEn:
+            blocks = [b for d in [self] + self.deviceList for b in d._blocks if isinstance(b, rim.Block)]
+            self._updateBus = rim.UpdateBus(max(1,sum(len(b.variables) for b in blocks)))
+
+            for b in blocks:
+                self._updateBus.addBlock(b)
+
+            self._busVars = {i: self._updateBus.getVariable(i) for i in range(self._updateBus.getVariableCount())}
+            self._log.info(f"Update bus for {len(self._busVars)} variables in {len(blocks)} blocks")
+
         # Start update thread
         self._running = True
         self._updateThread = threading.Thread(target=self._updateWorker)
         self._updateThread.start()
 
+        if self._updateBus is not None:
+            self._busThread = threading.Thread(target=self._busWorker)
+            self._busThread.start()
+
         # Start heartbeat
         if self._doHeartbeat:
             self._hbeatThread = threading.Thread(target=self._hbeatWorker)
@@ -389,6 +426,11 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
         """Stop the polling thread. Must be called for clean exit."""
 
         self._running = False
+
+        if self._busThread is not None:
+            self._updateBus.stop()
+            self._busThread.join()
+
         self._updateQueue.put(None)
         self._updateThread.join()
 
@@ -458,6 +500,7 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
     @contextmanager
     def updateGroup(self):
         tid = threading.get_ident()
+        held = False
 
         # At with call
         with self._updateLock:
@@ -467,6 +510,11 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
 
             self._updateCount[tid] += 1
 
+            # Bus updates generated within the group are delivered after it exits
+            if self._updateCount[tid] == 1 and self._updateBus is not None:
+                self._updateBus.hold()
+                held = True
+
         try:
             yield
         finally:
@@ -477,6 +525,9 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
                     self._updateCount[tid] = 0
                     self._updateQueue.put(self._updateList[tid])
                     self._updateList[tid] = {}
+
+                    if held:
+                        self._updateBus.release()
                 else:
                     self._updateCount[tid] -= 1
 
@@ -533,7 +584,7 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
     def saveAddressMap(self,fname,headerEn=False):
 
         # First form header
-        # Changing these names here requires changing the createVariable() method in LibraryBase.cpp
+        # Changing these names here requires changing the extractEntry() method in LibraryBase.cpp
         header  = "Path\t"
         header += "TypeStr\t"
         header += "Address\t"
@@ -709,11 +760,14 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
         """Write all blocks"""
         self._log.info("Start root write")
         with self.pollBlock(), self.updateGroup():
-            self.writeBlocks(force=self.ForceWrite.value(), recurse=True)
-            self._log.info("Verify root read")
-            self.verifyBlocks(recurse=True)
-            self._log.info("Check root read")
-            self.checkBlocks(recurse=True)
+            if self._bulk is not None:
+                self._bulkWrite(force=self.ForceWrite.value())
+            else:
+                self.writeBlocks(force=self.ForceWrite.value(), recurse=True)
+                self._log.info("Verify root read")
+                self.verifyBlocks(recurse=True)
+                self._log.info("Check root read")
+                self.checkBlocks(recurse=True)
 
         self._log.info("Done root write")
         return True
@@ -722,13 +776,83 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
         """Read all blocks"""
         self._log.info("Start root read")
         with self.pollBlock(), self.updateGroup():
-            self.readBlocks(recurse=True)
-            self._log.info("Check root read")
-            self.checkBlocks(recurse=True)
+            if self._bulk is not None:
+                self._bulkRead()
+            else:
+                self.readBlocks(recurse=True)
+                self._log.info("Check root read")
+                self.checkBlocks(recurse=True)
 
         self._log.info("Done root read")
         return True
 
+    def _bulkCollect(self, dev, bulkBlocks):
+        """
+        Sort the blocks of a device tree between the bulk operation engine and the python path.
+        Devices which override the block transaction methods or which set forceCheckEach are
+        handled as a whole in python.
+        """
+        if dev.forceCheckEach:
+            self._bulkDevices.append(dev)
+            return
+
+        for f in ['writeBlocks', 'verifyBlocks', 'readBlocks', 'checkBlocks']:
+            if getattr(type(dev), f) is not getattr(pr.Device, f):
+                self._bulkDevices.append(dev)
+                return
+
+        for block in dev._blocks:
+            if isinstance(block, rim.Block) and \
+               type(block)._startTransaction is rim.Block._startTransaction and \
+               type(block)._checkTransaction is rim.Block._checkTransaction:
+                bulkBlocks.append(block)
+            else:
+                self._bulkLocal.append(block)
+
+        for key,value in dev.devices.items():
+            self._bulkCollect(value, bulkBlocks)
+
+    def _bulkWrite(self, force):
+        """Write all blocks using the bulk operation engine, python blocks are started first to overlap"""
+        for dev in self._bulkDevices:
+            dev.writeBlocks(force=force, recurse=True)
+
+        for block in self._bulkLocal:
+            if block.bulkOpEn:
+                pr.startTransaction(block, type=rim.Write, forceWr=force)
+
+        self._bulk.write(force)
+
+        for dev in self._bulkDevices:
+            dev.verifyBlocks(recurse=True)
+
+        for block in self._bulkLocal:
+            if block.bulkOpEn:
+                pr.startTransaction(block, type=rim.Verify)
+
+        for dev in self._bulkDevices:
+            dev.checkBlocks(recurse=True)
+
+        for block in self._bulkLocal:
+            pr.checkTransaction(block)
+
+    def _bulkRead(self):
+        """Read all blocks using the bulk operation engine, python blocks are started first to overlap"""
+        for dev in self._bulkDevices:
+            dev.readBlocks(recurse=True)
+
+        for block in self._bulkLocal:
+            if block.bulkOpEn:
+                pr.startTransaction(block, type=rim.Read)
+
+        self._bulk.read()
+
+        for dev in self._bulkDevices:
+            dev.checkBlocks(recurse=True)
+
+        for block in self._bulkLocal:
+            pr.checkTransaction(block)
+
     def saveYaml(self,name,readFirst,modes,incGroups,excGroups,autoPrefix,autoCompress):
         """Save YAML configuration/status to a file. Called from command"""
 
@@ -907,6 +1031,16 @@ class Root(rogue.interfaces.stream.Master,pr.Device):
                 self._updateQueue.put(self._updateList[tid])
                 self._updateList[tid] = {}
 
+    # Update bus worker, forwards coalesced batches through the variable update hooks
+    def _busWorker(self):
+        while self._running:
+            ids = self._updateBus.pop(100000)
+
+            if len(ids) > 0:
+                with self.updateGroup():
+                    for i in ids:
+                        self._busVars[i]._queueUpdate()
+
     # Worker thread
     def _updateWorker(self):
         self._log.info("Starting update thread")
@@ -102,6 +102,45 @@ class UdpRssiPack(pr.Device):
             pollInterval= pollInterval,
         ))
 
+        self.add(pr.LocalVariable(
+            name        = 'rssiFastRetranCount',
+            mode        = 'RO',
+            value       = 0,
+            typeStr     = 'UInt32',
+            localGet    = lambda: self._rssi.getFastRetranCount(),
+            pollInterval= pollInterval,
+        ))
+
+        self.add(pr.LocalVariable(
+            name        = 'rssiRtt',
+            mode        = 'RO',
+            value       = 0,
+            typeStr     = 'UInt32',
+            units       = 'us',
+            localGet    = lambda: self._rssi.getRtt(),
+            pollInterval= pollInterval,
+        ))
+
+        self.add(pr.LocalVariable(
+            name        = 'rssiRttVar',
+            mode        = 'RO',
+            value       = 0,
+            typeStr     = 'UInt32',
+            units       = 'us',
+            localGet    = lambda: self._rssi.getRttVar(),
+            pollInterval= pollInterval,
+        ))
+
+        self.add(pr.LocalVariable(
+            name        = 'rssiRto',
+            mode        = 'RO',
+            value       = 0,
+            typeStr     = 'UInt32',
+            units       = 'us',
+            localGet    = lambda: self._rssi.getRto(),
+            pollInterval= pollInterval,
+        ))
+
         self.add(pr.LocalVariable(
             name        = 'locBusy',
             mode        = 'RO',
@@ -151,7 +190,7 @@ class UdpRssiPack(pr.Device):
             name        = 'locMaxBuffers',
             mode        = 'RW',
             value       = self._rssi.getLocMaxBuffers(),
-            typeStr     = 'UInt8',
+            typeStr     = 'UInt16',
             localGet    = lambda: self._rssi.getLocMaxBuffers(),
             localSet    = lambda value: self._rssi.setLocMaxBuffers(value)
         ))
@@ -214,11 +253,27 @@ class UdpRssiPack(pr.Device):
             name        = 'curMaxBuffers',
             mode        = 'RO',
             value       = 0,
-            typeStr     = 'UInt8',
+            typeStr     = 'UInt16',
             localGet    = lambda: self._rssi.curMaxBuffers(),
             pollInterval= pollInterval
         ))
 
+        self.add(pr.LocalVariable(
+            name        = 'curWindowExt',
+            mode        = 'RO',
+            value       = False,
+            localGet    = lambda: self._rssi.curWindowExt(),
+            pollInterval= pollInterval
+        ))
+
+        self.add(pr.LocalVariable(
+            name        = 'curSack',
+            mode        = 'RO',
+            value       = False,
+            localGet    = lambda: self._rssi.curSack(),
+            pollInterval= pollInterval
+        ))
+
         self.add(pr.LocalVariable(
             name        = 'curMaxSegment',
             mode        = 'RO',
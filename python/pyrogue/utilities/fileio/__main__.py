@@ -0,0 +1,30 @@
+#-----------------------------------------------------------------------------
+# Title      : PyRogue FileIO - Index rebuild tool
+#-----------------------------------------------------------------------------
+# Description:
+# Scan data files written by StreamWriter and rebuild their sidecar index.
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+
+import argparse
+import rogue.utilities.fileio
+
+parser = argparse.ArgumentParser('Rogue data file index rebuild')
+
+parser.add_argument('files',
+                    type=str,
+                    nargs='+',
+                    help='Data file, or first file (name.1) of a split data set')
+
+args = parser.parse_args()
+
+for fn in args.files:
+    count = rogue.utilities.fileio.StreamIndex.rebuild(fn)
+    print(f"{rogue.utilities.fileio.StreamIndex.indexName(fn)}: {count} frames")
@@ -28,15 +28,89 @@
 #include <sstream>
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 
 namespace ris  = rogue::interfaces::stream;
 namespace rim  = rogue::interfaces::memory;
 
+#ifndef NO_PYTHON
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+// Compiled memory map file identification
+#define MEM_MAP_MAGIC   0x4D4D4752
+#define MEM_MAP_VERSION 1
+
+// Compiled memory map flags
+#define MEM_MAP_OVERLAP_EN    0x01
+#define MEM_MAP_VERIFY        0x02
+#define MEM_MAP_BULK_EN       0x04
+#define MEM_MAP_UPDATE_NOTIFY 0x08
+#define MEM_MAP_BYTE_REVERSE  0x10
+#define MEM_MAP_BIT_REVERSE   0x20
+
+// Compiled memory map header. The header is followed by the variable records,
+// the uint32_t table holding the bit offset and bit size lists and the string table.
+struct MemMapHeader {
+   uint32_t magic;
+   uint32_t version;
+   uint32_t recCount;
+   uint32_t vecCount;
+   uint32_t strSize;
+   uint32_t recSize;
+};
+
+// Compiled memory map variable record, strings are offsets into the string
+// table and lists are indexes into the uint32_t table.
+struct MemMapRecord {
+   uint64_t offset;
+   double   minimum;
+   double   maximum;
+   uint32_t name;
+   uint32_t mode;
+   uint32_t mbName;
+   uint32_t blkName;
+   uint32_t modelId;
+   uint32_t binPoint;
+   uint32_t blockSize;
+   uint32_t numValues;
+   uint32_t valueBits;
+   uint32_t valueStride;
+   uint32_t retryCount;
+   uint32_t bitOffset;
+   uint32_t bitOffsetCount;
+   uint32_t bitSize;
+   uint32_t bitSizeCount;
+   uint32_t flags;
+};
+
 rogue::LibraryBasePtr rogue::LibraryBase::create() {
    rogue::LibraryBasePtr ret = std::make_shared<rogue::LibraryBase>();
    return(ret);
 }
 
+void rogue::LibraryBase::setup_python() {
+#ifndef NO_PYTHON
+   bp::class_<rogue::LibraryBase, rogue::LibraryBasePtr, boost::noncopyable>("LibraryBase",bp::init<>())
+      .def("addMemory",        &rogue::LibraryBase::addMemory)
+      .def("parseMemMap",      &rogue::LibraryBase::parseMemMap)
+      .def("compileMemMap",    &rogue::LibraryBase::compileMemMap)
+      .def("loadMemMap",       &rogue::LibraryBase::loadMemMap)
+      .def("readAll",          &rogue::LibraryBase::readAll)
+      .def("getVariableNames", &rogue::LibraryBase::getVariableNamesPy)
+      .def("getVariableInfo",  &rogue::LibraryBase::getVariableInfoPy)
+      .def("getValue",         &rogue::LibraryBase::getValuePy)
+      .def("getBlockSizes",    &rogue::LibraryBase::getBlockSizesPy)
+   ;
+#endif
+}
+
 rogue::LibraryBase::LibraryBase () {
    log_ = rogue::Logging::create("LibraryBase");
 }
@@ -50,12 +124,21 @@ void rogue::LibraryBase::addMemory (std::string name, rim::SlavePtr slave) {
 
 //! Get variable by name
 rim::VariablePtr rogue::LibraryBase::getVariable(const std::string & name) {
-   return variables_[name];
+   std::unordered_map<std::string, rim::VariablePtr>::iterator it;
+
+   if ( (it = variables_.find(name)) == variables_.end() ) return rim::VariablePtr();
+   return it->second;
 }
 
 //! Get a map of variables
 const std::map<std::string, rim::VariablePtr> & rogue::LibraryBase::getVariableList() {
-   return variables_;
+
+   // Variables are only ever added, rebuild the ordered copy when the count changes
+   if ( varList_.size() != variables_.size() ) {
+      varList_.clear();
+      varList_.insert(variables_.begin(),variables_.end());
+   }
+   return varList_;
 }
 
 //! Get block by name
@@ -68,16 +151,86 @@ const std::map< std::string, rim::BlockPtr> rogue::LibraryBase::getBlockList() {
    return blocks_;
 }
 
+#ifndef NO_PYTHON
+
+//! Get a list of variable names, python version
+bp::object rogue::LibraryBase::getVariableNamesPy() {
+   std::map<std::string, rim::VariablePtr>::const_iterator it;
+   bp::list ret;
+
+   const std::map<std::string, rim::VariablePtr> & vars = getVariableList();
+
+   for (it=vars.begin(); it != vars.end(); ++it) ret.append(it->first);
+   return ret;
+}
+
+//! Get a dictionary of variable attributes, python version
+bp::object rogue::LibraryBase::getVariableInfoPy(std::string name) {
+   rim::VariablePtr var;
+   bp::dict ret;
+
+   if ( (var = getVariable(name)) == NULL )
+      throw(rogue::GeneralError::create("LibraryBase::getVariableInfo","Variable '%s' not found",name.c_str()));
+
+   ret["path"]        = var->path();
+   ret["mode"]        = var->mode();
+   ret["offset"]      = var->offset();
+   ret["minimum"]     = var->minimum();
+   ret["maximum"]     = var->maximum();
+   ret["verify"]      = var->verifyEn();
+   ret["overlapEn"]   = var->overlapEn();
+   ret["bulkEn"]      = var->bulkOpEn();
+   ret["modelId"]     = var->modelId();
+   ret["bitTotal"]    = var->bitTotal();
+   ret["byteSize"]    = var->byteSize();
+   ret["numValues"]   = var->numValues();
+   ret["valueBits"]   = var->valueBits();
+   ret["valueStride"] = var->valueStride();
+   ret["retryCount"]  = var->retryCount();
+   return ret;
+}
+
+//! Get the value of a variable as a string, python version
+std::string rogue::LibraryBase::getValuePy(std::string name, bool read) {
+   rim::VariablePtr var;
+
+   if ( (var = getVariable(name)) == NULL )
+      throw(rogue::GeneralError::create("LibraryBase::getValue","Variable '%s' not found",name.c_str()));
+
+   return var->getDumpValue(read);
+}
+
+//! Get a dictionary of block sizes by block name, python version
+bp::object rogue::LibraryBase::getBlockSizesPy() {
+   std::map<std::string, rim::BlockPtr>::iterator it;
+   bp::dict ret;
+
+   for (it=blocks_.begin(); it != blocks_.end(); ++it) ret[it->first] = it->second->size();
+   return ret;
+}
+
+#endif
+
 // Parse memory map
 void rogue::LibraryBase::parseMemMap (std::string map) {
+   std::vector<MemMapEntry> entries;
+   std::vector<MemMapEntry>::iterator it;
+   BlockVarMap blockVars;
+
+   parseEntries(map,entries);
+
+   for (it=entries.begin(); it != entries.end(); ++it) createVariable(*it,blockVars);
+
+   addBlockVariables(blockVars);
+}
+
+//! Parse memory map string into entries
+void rogue::LibraryBase::parseEntries(std::string & map, std::vector<MemMapEntry> & entries) {
    std::string line;
    std::string field;
    std::istringstream fStream(map);
    std::vector<std::string> key;
 
-   std::map< std::string, std::vector<rim::VariablePtr> > blockVars;
-   std::map< std::string, std::vector<rim::VariablePtr> >::iterator it;
-
    uint32_t x;
    bool doKey=true;
    char delim;
@@ -98,91 +251,275 @@ void rogue::LibraryBase::parseMemMap (std::string map) {
          ++x;
       }
 
-      if (!doKey) createVariable(fields,blockVars);
+      if (!doKey) {
+         entries.push_back(MemMapEntry());
+         extractEntry(fields,entries.back());
+      }
       doKey = false;
    }
+}
+
+//! Compile a memory map to a binary file
+void rogue::LibraryBase::compileMemMap (std::string map, std::string path) {
+   std::vector<MemMapEntry> entries;
+   std::vector<MemMapEntry>::iterator it;
+   std::vector<MemMapRecord> recs;
+   std::vector<uint32_t> vec;
+   std::string strTable;
+   std::unordered_map<std::string, uint32_t> strIndex;
+   std::unordered_map<std::string, uint32_t>::iterator sit;
+   MemMapHeader hdr;
+   MemMapRecord rec;
+   std::ofstream ofs;
+
+   // Add string to table, duplicate strings share an entry
+   auto addString = [&](const std::string & str) -> uint32_t {
+      if ( (sit = strIndex.find(str)) != strIndex.end() ) return sit->second;
+      uint32_t off = strTable.size();
+      strTable.append(str.c_str(),str.size()+1);
+      strIndex.insert(std::make_pair(str,off));
+      return off;
+   };
+
+   parseEntries(map,entries);
+
+   for (it=entries.begin(); it != entries.end(); ++it) {
+      memset(&rec,0,sizeof(rec));
+
+      rec.offset      = it->offset;
+      rec.minimum     = it->minimum;
+      rec.maximum     = it->maximum;
+      rec.name        = addString(it->name);
+      rec.mode        = addString(it->mode);
+      rec.mbName      = addString(it->mbName);
+      rec.blkName     = addString(it->blkName);
+      rec.modelId     = it->modelId;
+      rec.binPoint    = it->binPoint;
+      rec.blockSize   = it->blockSize;
+      rec.numValues   = it->numValues;
+      rec.valueBits   = it->valueBits;
+      rec.valueStride = it->valueStride;
+      rec.retryCount  = it->retryCount;
+
+      rec.bitOffset      = vec.size();
+      rec.bitOffsetCount = it->bitOffset.size();
+      vec.insert(vec.end(),it->bitOffset.begin(),it->bitOffset.end());
+
+      rec.bitSize      = vec.size();
+      rec.bitSizeCount = it->bitSize.size();
+      vec.insert(vec.end(),it->bitSize.begin(),it->bitSize.end());
+
+      if ( it->overlapEn    ) rec.flags |= MEM_MAP_OVERLAP_EN;
+      if ( it->verify       ) rec.flags |= MEM_MAP_VERIFY;
+      if ( it->bulkEn       ) rec.flags |= MEM_MAP_BULK_EN;
+      if ( it->updateNotify ) rec.flags |= MEM_MAP_UPDATE_NOTIFY;
+      if ( it->byteReverse  ) rec.flags |= MEM_MAP_BYTE_REVERSE;
+      if ( it->bitReverse   ) rec.flags |= MEM_MAP_BIT_REVERSE;
+
+      recs.push_back(rec);
+   }
+
+   hdr.magic    = MEM_MAP_MAGIC;
+   hdr.version  = MEM_MAP_VERSION;
+   hdr.recCount = recs.size();
+   hdr.vecCount = vec.size();
+   hdr.strSize  = strTable.size();
+   hdr.recSize  = sizeof(MemMapRecord);
+
+   ofs.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+   if ( ! ofs.is_open() )
+      throw(rogue::GeneralError::create("LibraryBase::compileMemMap","Failed to open file '%s'",path.c_str()));
+
+   ofs.write((const char *)&hdr, sizeof(hdr));
+   ofs.write((const char *)recs.data(), recs.size() * sizeof(MemMapRecord));
+   ofs.write((const char *)vec.data(), vec.size() * sizeof(uint32_t));
+   ofs.write(strTable.data(), strTable.size());
+   ofs.close();
+
+   if ( ofs.fail() )
+      throw(rogue::GeneralError::create("LibraryBase::compileMemMap","Failed to write file '%s'",path.c_str()));
+
+   log_->info("Compiled %i variables to %s",recs.size(),path.c_str());
+}
+
+//! Load a compiled binary memory map
+void rogue::LibraryBase::loadMemMap (std::string path) {
+   struct stat st;
+   MemMapHeader * hdr;
+   MemMapRecord * recs;
+   MemMapEntry entry;
+   BlockVarMap blockVars;
+   uint32_t * vec;
+   char * str;
+   uint8_t * map;
+   uint64_t size;
+   uint32_t x;
+   int32_t fd;
+
+   if ( (fd = ::open(path.c_str(), O_RDONLY)) < 0 )
+      throw(rogue::GeneralError::create("LibraryBase::loadMemMap","Failed to open file '%s'",path.c_str()));
+
+   if ( fstat(fd,&st) != 0 || (uint64_t)st.st_size < sizeof(MemMapHeader) ) {
+      ::close(fd);
+      throw(rogue::GeneralError::create("LibraryBase::loadMemMap","Invalid memory map file '%s'",path.c_str()));
+   }
+   size = st.st_size;
+
+   map = (uint8_t *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   ::close(fd);
+
+   if ( map == MAP_FAILED )
+      throw(rogue::GeneralError::create("LibraryBase::loadMemMap","Failed to map file '%s'",path.c_str()));
+
+   hdr  = (MemMapHeader *)map;
+   recs = (MemMapRecord *)(map + sizeof(MemMapHeader));
+   vec  = (uint32_t *)(recs + hdr->recCount);
+   str  = (char *)(vec + hdr->vecCount);
+
+   if ( hdr->magic != MEM_MAP_MAGIC || hdr->version != MEM_MAP_VERSION || hdr->recSize != sizeof(MemMapRecord) ||
+        size != (sizeof(MemMapHeader) + (uint64_t)hdr->recCount * sizeof(MemMapRecord) +
+                 (uint64_t)hdr->vecCount * sizeof(uint32_t) + hdr->strSize) ) {
+      munmap(map,size);
+      throw(rogue::GeneralError::create("LibraryBase::loadMemMap","Invalid or incompatible memory map file '%s'",path.c_str()));
+   }
+
+   // Every string offset must be followed by a terminator inside the table
+   if ( hdr->strSize == 0 || str[hdr->strSize-1] != 0 ) {
+      munmap(map,size);
+      throw(rogue::GeneralError::create("LibraryBase::loadMemMap","Unterminated string table in memory map file '%s'",path.c_str()));
+   }
+
+   madvise(map,size,MADV_SEQUENTIAL);
+
+   for (x=0; x < hdr->recCount; x++) {
+      MemMapRecord & rec = recs[x];
+
+      if ( rec.name >= hdr->strSize || rec.mode >= hdr->strSize || rec.mbName >= hdr->strSize || rec.blkName >= hdr->strSize ||
+           ((uint64_t)rec.bitOffset + rec.bitOffsetCount) > hdr->vecCount ||
+           ((uint64_t)rec.bitSize + rec.bitSizeCount) > hdr->vecCount ) {
+         munmap(map,size);
+         throw(rogue::GeneralError::create("LibraryBase::loadMemMap","Corrupt record %i in memory map file '%s'",x,path.c_str()));
+      }
+
+      entry.name         = str + rec.name;
+      entry.mode         = str + rec.mode;
+      entry.mbName       = str + rec.mbName;
+      entry.blkName      = str + rec.blkName;
+      entry.overlapEn    = rec.flags & MEM_MAP_OVERLAP_EN;
+      entry.verify       = rec.flags & MEM_MAP_VERIFY;
+      entry.bulkEn       = rec.flags & MEM_MAP_BULK_EN;
+      entry.updateNotify = rec.flags & MEM_MAP_UPDATE_NOTIFY;
+      entry.byteReverse  = rec.flags & MEM_MAP_BYTE_REVERSE;
+      entry.bitReverse   = rec.flags & MEM_MAP_BIT_REVERSE;
+      entry.offset       = rec.offset;
+      entry.modelId      = rec.modelId;
+      entry.binPoint     = rec.binPoint;
+      entry.blockSize    = rec.blockSize;
+      entry.numValues    = rec.numValues;
+      entry.valueBits    = rec.valueBits;
+      entry.valueStride  = rec.valueStride;
+      entry.retryCount   = rec.retryCount;
+      entry.minimum      = rec.minimum;
+      entry.maximum      = rec.maximum;
+      entry.bitOffset.assign(vec + rec.bitOffset, vec + rec.bitOffset + rec.bitOffsetCount);
+      entry.bitSize.assign(vec + rec.bitSize, vec + rec.bitSize + rec.bitSizeCount);
+
+      createVariable(entry,blockVars);
+   }
+
+   munmap(map,size);
+
+   addBlockVariables(blockVars);
+   log_->info("Loaded %i variables from %s",x,path.c_str());
+}
+
+//! Add variables to their blocks
+void rogue::LibraryBase::addBlockVariables(BlockVarMap & blockVars) {
+   BlockVarMap::iterator it;
 
-   // Add variables to the blocks
    for (it=blockVars.begin(); it != blockVars.end(); ++it) {
       rim::BlockPtr blk = blocks_[it->first];
       blk->addVariables(it->second);
    }
 }
 
-//! Create a variable
+//! Extract memory map entry from fields
 // The fields used here are defined in saveAddressMap in _Root.py
-void rogue::LibraryBase::createVariable(std::map<std::string, std::string> &data,
-                                        std::map<std::string, std::vector<rim::VariablePtr> > &blockVars ) {
+void rogue::LibraryBase::extractEntry(std::map<std::string, std::string> &data, MemMapEntry & entry) {
+   entry.name    = getFieldString(data,"Path");
+   entry.mode    = getFieldString(data,"Mode");
+   entry.mbName  = getFieldString(data,"MemBaseName");
+   entry.blkName = getFieldString(data,"BlockName");
+
+   entry.overlapEn    = getFieldBool(data,"OverlapEn");
+   entry.verify       = getFieldBool(data,"Verify");
+   entry.bulkEn       = getFieldBool(data,"BulkEn");
+   entry.updateNotify = getFieldBool(data,"UpdateNotify");
+   entry.byteReverse  = getFieldBool(data,"ByteReverse");
+   entry.bitReverse   = getFieldBool(data,"BitReverse");
+
+   entry.offset      = getFieldUInt64(data,"Address");
+   entry.modelId     = getFieldUInt32(data,"ModelId");
+   entry.binPoint    = getFieldUInt32(data,"BinPoint");
+   entry.blockSize   = getFieldUInt32(data,"BlockSize");
+   entry.numValues   = getFieldUInt32(data,"NumValues",true);
+   entry.valueBits   = getFieldUInt32(data,"ValueBits",true);
+   entry.valueStride = getFieldUInt32(data,"ValueStride",true);
+   entry.retryCount  = getFieldUInt32(data,"RetryCount",true);
+
+   entry.minimum = getFieldDouble(data,"Minimum");
+   entry.maximum = getFieldDouble(data,"Maximum");
+
+   entry.bitOffset = getFieldVectorUInt32(data,"BitOffset");
+   entry.bitSize   = getFieldVectorUInt32(data,"BitSize");
+}
 
-   // Extract fields
-   std::string name    = getFieldString(data,"Path");
-   std::string mode    = getFieldString(data,"Mode");
-   std::string mbName  = getFieldString(data,"MemBaseName");
-   std::string blkName = getFieldString(data,"BlockName");
+//! Create a variable
+void rogue::LibraryBase::createVariable(MemMapEntry & entry, BlockVarMap & blockVars) {
+   std::map<std::string, rim::BlockPtr>::iterator bit;
 
    // Verify memory slave exists
-   if ( memSlaves_.find(mbName) == memSlaves_.end() ) {
-      if ( memSlavesMissing_.find(mbName) != memSlavesMissing_.end() ) {
+   if ( memSlaves_.find(entry.mbName) == memSlaves_.end() ) {
+      if ( memSlavesMissing_.find(entry.mbName) != memSlavesMissing_.end() ) {
          // Just return as we've already reported this.
          return;
       }
-      memSlavesMissing_.insert(mbName);
-      log_->info("LibraryBase::createVariable: '%s' memory interface '%s' not found!",name.c_str(),mbName.c_str());
+      memSlavesMissing_.insert(entry.mbName);
+      log_->info("LibraryBase::createVariable: '%s' memory interface '%s' not found!",entry.name.c_str(),entry.mbName.c_str());
       return;
    }
 
-   bool overlapEn    = getFieldBool(data,"OverlapEn");
-   bool verify       = getFieldBool(data,"Verify");
-   bool bulkEn       = getFieldBool(data,"BulkEn");
-   bool updateNotify = getFieldBool(data,"UpdateNotify");
-   bool byteReverse  = getFieldBool(data,"ByteReverse");
-   bool bitReverse   = getFieldBool(data,"BitReverse");
-
-   uint64_t offset      = getFieldUInt64(data,"Address");
-   uint32_t modelId     = getFieldUInt32(data,"ModelId");
-   uint32_t binPoint    = getFieldUInt32(data,"BinPoint");
-   uint32_t blockSize   = getFieldUInt32(data,"BlockSize");
-   uint32_t numValues   = getFieldUInt32(data,"NumValues",true);
-   uint32_t valueBits   = getFieldUInt32(data,"ValueBits",true);
-   uint32_t valueStride = getFieldUInt32(data,"ValueStride",true);
-   uint32_t retryCount  = getFieldUInt32(data,"RetryCount",true);
-
-   double minimum = getFieldDouble(data,"Minimum");
-   double maximum = getFieldDouble(data,"Maximum");
-
-   std::vector<uint32_t> bitOffset = getFieldVectorUInt32(data,"BitOffset");
-   std::vector<uint32_t> bitSize   = getFieldVectorUInt32(data,"BitSize");
-
    // Create the holding block if it does not already exist
-   if ( blocks_.find(blkName) == blocks_.end() ) {
-      rim::BlockPtr block = rim::Block::create(offset,blockSize);
-      blocks_.insert(std::pair<std::string,rim::BlockPtr>(blkName,block));
+   if ( (bit = blocks_.find(entry.blkName)) == blocks_.end() ) {
+      rim::BlockPtr block = rim::Block::create(entry.offset,entry.blockSize);
+      blocks_.insert(std::pair<std::string,rim::BlockPtr>(entry.blkName,block));
       std::vector<rim::VariablePtr> vp;
-      blockVars.insert(std::pair<std::string,std::vector<rim::VariablePtr>>(blkName,vp));
+      blockVars.insert(std::pair<std::string,std::vector<rim::VariablePtr>>(entry.blkName,vp));
 
       // Connect to memory slave
-      *block >> memSlaves_[mbName];
+      *block >> memSlaves_[entry.mbName];
 
       // Enable the block
       block->setEnable(true);
    }
 
    // Create variable
-   rim::VariablePtr var = rim::Variable::create(name,mode,minimum,maximum,offset,bitOffset,bitSize,
-      overlapEn,verify,bulkEn,updateNotify,modelId,byteReverse,bitReverse,binPoint,numValues,
-      valueBits,valueStride,retryCount);
+   rim::VariablePtr var = rim::Variable::create(entry.name,entry.mode,entry.minimum,entry.maximum,entry.offset,
+      entry.bitOffset,entry.bitSize,entry.overlapEn,entry.verify,entry.bulkEn,entry.updateNotify,entry.modelId,
+      entry.byteReverse,entry.bitReverse,entry.binPoint,entry.numValues,entry.valueBits,entry.valueStride,entry.retryCount);
 
    // Adjust min transaction size to match blocksize field
-   var->shiftOffsetDown(0, blockSize);
+   var->shiftOffsetDown(0, entry.blockSize);
 
    // Add to block list
-   blockVars[blkName].push_back(var);
-   variables_[name]=var;
+   blockVars[entry.blkName].push_back(var);
+   variables_[entry.name]=var;
 }
 
 // Read all variables
 void rogue::LibraryBase::readAll() {
-   std::map< std::string, rim::VariablePtr>::iterator it;
+   std::unordered_map< std::string, rim::VariablePtr>::iterator it;
    for (it=variables_.begin(); it != variables_.end(); ++it) {
       it->second->read();
    }
@@ -289,13 +626,15 @@ std::vector<uint32_t> rogue::LibraryBase::getFieldVectorUInt32(std::map<std::str
 
 //! Dump the current state of the registers in the system
 void rogue::LibraryBase::dumpRegisterStatus(std::string filename, bool read, bool includeStatus) {
-   std::map< std::string, rim::VariablePtr>::iterator it;
+   std::map< std::string, rim::VariablePtr>::const_iterator it;
 
    std::ofstream myfile;
 
+   const std::map<std::string, rim::VariablePtr> & vars = getVariableList();
+
    myfile.open(filename);
 
-   for (it=variables_.begin(); it != variables_.end(); ++it) {
+   for (it=vars.begin(); it != vars.end(); ++it) {
       if ( includeStatus || it->second->mode() != "RO" ) {
          myfile << it->second->getDumpValue(read);
       }
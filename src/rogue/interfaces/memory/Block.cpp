@@ -17,6 +17,7 @@
  * ----------------------------------------------------------------------------
 **/
 #include <rogue/interfaces/memory/Block.h>
+#include <rogue/interfaces/memory/UpdateBus.h>
 #include <rogue/interfaces/memory/Variable.h>
 #include <rogue/interfaces/memory/Transaction.h>
 #include <rogue/interfaces/memory/Constants.h>
@@ -33,8 +34,11 @@
 namespace rim = rogue::interfaces::memory;
 
 #ifndef NO_PYTHON
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #define BOOST_BIND_GLOBAL_PLACEHOLDERS
 #include <boost/python.hpp>
+#include <numpy/arrayobject.h>
+#include <numpy/ndarraytypes.h>
 namespace bp  = boost::python;
 #endif
 
@@ -48,6 +52,8 @@ rim::BlockPtr rim::Block::create (uint64_t offset, uint32_t size) {
 // Setup class for use in python
 void rim::Block::setup_python() {
 
+   _import_array();
+
    bp::class_<rim::Block, rim::BlockPtr, bp::bases<rim::Master>, boost::noncopyable>("Block",bp::init<uint64_t,uint32_t>())
        .add_property("path",      &rim::Block::path)
        .add_property("mode",      &rim::Block::mode)
@@ -56,6 +62,10 @@ void rim::Block::setup_python() {
        .add_property("offset",    &rim::Block::offset)
        .add_property("address",   &rim::Block::address)
        .add_property("size",      &rim::Block::size)
+       .add_property("version",   &rim::Block::version)
+       .add_property("data",       &rim::Block::dataPy)
+       .add_property("verifyData", &rim::Block::verifyDataPy)
+       .add_property("verifyMask", &rim::Block::verifyMaskPy)
        .def("setEnable",          &rim::Block::setEnable)
        .def("_startTransaction",  &rim::Block::startTransactionPy)
        .def("_checkTransaction",  &rim::Block::checkTransactionPy)
@@ -84,6 +94,8 @@ rim::Block::Block (uint64_t offset, uint32_t size) {
    enable_     = false;
    stale_      = false;
    retryCount_ = 0;
+   version_    = 0;
+   tranStarted_ = false;
 
    verifyBase_ = 0; // Verify Range
    verifySize_ = 0; // Verify Range
@@ -156,6 +168,53 @@ bool rim::Block::blockPyTrans() {
     return blockPyTrans_;
 }
 
+// Get data version
+uint64_t rim::Block::version() {
+   return version_;
+}
+
+#ifndef NO_PYTHON
+
+// Create a read only numpy view of a block buffer
+bp::object rim::Block::numpyView(bp::object self, uint8_t *data, uint32_t size) {
+   npy_intp dims[1] = { size };
+
+   PyObject *obj = PyArray_New(&PyArray_Type, 1, dims, NPY_UINT8, NULL, data, 0, NPY_ARRAY_CARRAY_RO, NULL);
+
+   if ( obj == NULL )
+      throw(rogue::GeneralError("Block::numpyView","Failed to create numpy array"));
+
+   // Array holds a reference to the python block, which owns the buffer
+   Py_INCREF(self.ptr());
+   if ( PyArray_SetBaseObject(reinterpret_cast<PyArrayObject *>(obj), self.ptr()) < 0 ) {
+      Py_DECREF(obj);
+      throw(rogue::GeneralError("Block::numpyView","Failed to set numpy array base"));
+   }
+
+   bp::handle<> handle(obj);
+   return bp::object(handle);
+}
+
+// Get block data as a numpy array
+bp::object rim::Block::dataPy(bp::object self) {
+   rim::Block & blk = bp::extract<rim::Block &>(self);
+   return numpyView(self, blk.blockData_, blk.size_);
+}
+
+// Get block verify data as a numpy array
+bp::object rim::Block::verifyDataPy(bp::object self) {
+   rim::Block & blk = bp::extract<rim::Block &>(self);
+   return numpyView(self, blk.verifyData_, blk.size_);
+}
+
+// Get block verify mask as a numpy array
+bp::object rim::Block::verifyMaskPy(bp::object self) {
+   rim::Block & blk = bp::extract<rim::Block &>(self);
+   return numpyView(self, blk.verifyMask_, blk.size_);
+}
+
+#endif
+
 // Start a transaction for this block
 void rim::Block::intStartTransaction(uint32_t type, bool forceWr, bool check, rim::Variable *var, int32_t index) {
    uint32_t  x;
@@ -241,6 +300,7 @@ void rim::Block::intStartTransaction(uint32_t type, bool forceWr, bool check, ri
          }
       }
       doUpdate_ = updateEn_;
+      tranStarted_ = true;
 
       bLog_->debug("Start transaction type = %i, Offset=0x%x, lByte=%i, hByte=%i, tOff=0x%x, tSize=%i",type,offset_,lowByte,highByte,tOff,tSize);
 
@@ -249,12 +309,14 @@ void rim::Block::intStartTransaction(uint32_t type, bool forceWr, bool check, ri
    }
 }
 
-// Start a transaction for this block, cpp version
-void rim::Block::startTransaction(uint32_t type, bool forceWr, bool check, rim::Variable *var, int32_t index) {
+// Start a transaction for this block with retries, returns update flag if checked
+bool rim::Block::retryTransaction(uint32_t type, bool forceWr, bool check, rim::Variable *var, int32_t index) {
    uint32_t count;
+   bool     upd;
    bool     fWr;
 
    count = 0;
+   upd = false;
    fWr = forceWr;
 
    do {
@@ -262,7 +324,7 @@ void rim::Block::startTransaction(uint32_t type, bool forceWr, bool check, rim::
       intStartTransaction(type,fWr,check,var,index);
 
       try {
-         if ( check || retryCount_ > 0 ) checkTransaction();
+         if ( check || retryCount_ > 0 ) upd = checkTransaction();
 
          // Success
          count = retryCount_;
@@ -274,41 +336,22 @@ void rim::Block::startTransaction(uint32_t type, bool forceWr, bool check, rim::
       }
    }
    while (count++ < retryCount_);
+
+   return upd;
+}
+
+// Start a transaction for this block, cpp version
+void rim::Block::startTransaction(uint32_t type, bool forceWr, bool check, rim::Variable *var, int32_t index) {
+   retryTransaction(type,forceWr,check,var,index);
 }
 
 #ifndef NO_PYTHON
 
 // Start a transaction for this block, python version
 void rim::Block::startTransactionPy(uint32_t type, bool forceWr, bool check, rim::VariablePtr var, int32_t index) {
-   uint32_t count;
-   bool     upd;
-   bool     fWr;
-
    if ( blockPyTrans_ ) return;
 
-   count = 0;
-   upd = false;
-   fWr = forceWr;
-
-   do {
-
-      intStartTransaction(type,fWr,check,var.get(),index);
-
-      try {
-         if ( check || retryCount_ > 0 ) upd = checkTransaction();
-
-         // Success
-         count = retryCount_;
-
-      } catch ( rogue::GeneralError err ) {
-         if ( (count+1) >= retryCount_ ) throw err;
-         bLog_->error("Error on try %i out of %i: %s",(count+1),(retryCount_+1),err.what());
-         fWr = true; // Stale state is now lost
-      }
-   }
-   while (count++ < retryCount_);
-
-   if ( upd ) varUpdate();
+   if ( retryTransaction(type,forceWr,check,var.get(),index) ) varUpdate();
 }
 
 #endif
@@ -317,6 +360,7 @@ void rim::Block::startTransactionPy(uint32_t type, bool forceWr, bool check, rim
 bool rim::Block::checkTransaction() {
    std::string err;
    bool locUpdate;
+   bool started;
    uint32_t x;
 
    {
@@ -327,6 +371,9 @@ bool rim::Block::checkTransaction() {
       err = getError();
       clearError();
 
+      started = tranStarted_;
+      tranStarted_ = false;
+
       if ( err != "" ) {
          throw(rogue::GeneralError::create("Block::checkTransaction",
             "Transaction error for block %s with address 0x%.8x. Error %s",
@@ -351,6 +398,7 @@ bool rim::Block::checkTransaction() {
          }
       }
       bLog_->debug("Transaction complete");
+      if ( started ) version_++;
 
       locUpdate = doUpdate_;
       doUpdate_ = false;
@@ -388,6 +436,14 @@ void rim::Block::read(rim::Variable *var,int32_t index) {
 void rim::Block::varUpdate() {
    std::vector<rim::VariablePtr>::iterator vit;
 
+   // Publish to the update bus without the GIL
+   if ( updateBus_ ) {
+      for ( vit = variables_.begin(); vit != variables_.end(); ++vit ) {
+         if ( (*vit)->updateNotify_ && (*vit)->busId_ >= 0 ) updateBus_->publish((*vit)->busId_);
+      }
+      return;
+   }
+
    rogue::ScopedGil gil;
 
    for ( vit = variables_.begin(); vit != variables_.end(); ++vit ) {
@@ -0,0 +1,215 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Memory Bulk Operation
+ * ----------------------------------------------------------------------------
+ * File       : BulkOp.cpp
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Concurrent bulk read and write of Blocks grouped by downstream Slave.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#include <rogue/interfaces/memory/BulkOp.h>
+#include <rogue/interfaces/memory/Block.h>
+#include <rogue/interfaces/memory/Constants.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <memory>
+#include <thread>
+
+namespace rim = rogue::interfaces::memory;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+//! Class creation
+rim::BulkOpPtr rim::BulkOp::create (uint32_t maxDepth) {
+   rim::BulkOpPtr r = std::make_shared<rim::BulkOp>(maxDepth);
+   return(r);
+}
+
+//! Creator
+rim::BulkOp::BulkOp(uint32_t maxDepth) {
+   log_ = rogue::Logging::create("memory.BulkOp");
+   maxDepth_ = (maxDepth == 0) ? 1 : maxDepth;
+}
+
+//! Destructor
+rim::BulkOp::~BulkOp() { }
+
+//! Set the list of Blocks
+void rim::BulkOp::setBlocks(std::vector<rim::BlockPtr> blocks) {
+   std::vector<rim::BlockPtr>::iterator it;
+   std::map<uint32_t, uint32_t> index;
+   std::map<uint32_t, uint32_t>::iterator mit;
+   uint32_t id;
+
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+
+   groups_.clear();
+
+   for ( it = blocks.begin(); it != blocks.end(); ++it ) {
+      if ( (!(*it)->bulkOpEn()) || (*it)->blockPyTrans() ) continue;
+
+      id = (*it)->reqSlaveId();
+
+      if ( (mit = index.find(id)) == index.end() ) {
+         mit = index.insert(std::make_pair(id,(uint32_t)groups_.size())).first;
+         groups_.push_back(Group());
+         groups_.back().slaveId = id;
+      }
+      groups_[mit->second].blocks.push_back(*it);
+   }
+
+   log_->debug("Added %i blocks in %i groups",blocks.size(),groups_.size());
+}
+
+#ifndef NO_PYTHON
+
+//! Set the list of Blocks, Python version
+void rim::BulkOp::setBlocksPy(bp::object blocks) {
+   setBlocks(py_list_to_std_vector<rim::BlockPtr>(blocks));
+}
+
+#endif
+
+//! Get the number of Slave groups
+uint32_t rim::BulkOp::getGroupCount() {
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+   return groups_.size();
+}
+
+//! Check the oldest in flight block of a group
+void rim::BulkOp::checkOldest(Group *grp, std::vector<uint32_t> & inFlight, uint32_t & head) {
+   uint32_t idx = inFlight[head++];
+
+   try {
+      if ( grp->blocks[idx]->checkTransaction() ) grp->update[idx] = true;
+   } catch (rogue::GeneralError & err) {
+      grp->failed[idx] = true;
+      grp->errors.push_back(err.what());
+   }
+}
+
+//! Issue a transaction type to all blocks in a group, skipping failed blocks
+void rim::BulkOp::process(Group *grp, uint32_t type, bool force) {
+   std::vector<uint32_t> inFlight;
+   rim::BlockPtr blk;
+   uint32_t head;
+   uint32_t idx;
+
+   inFlight.reserve(grp->blocks.size());
+   head = 0;
+
+   for ( idx = 0; idx < grp->blocks.size(); idx++ ) {
+      if ( grp->failed[idx] ) continue;
+      blk = grp->blocks[idx];
+
+      // Blocks with retries configured are checked during the start call
+      try {
+         if ( blk->retryTransaction(type,force,false,NULL,-1) ) grp->update[idx] = true;
+         if ( blk->retryCount_ == 0 ) inFlight.push_back(idx);
+      } catch (rogue::GeneralError & err) {
+         grp->failed[idx] = true;
+         grp->errors.push_back(err.what());
+      }
+
+      while ( (inFlight.size() - head) >= maxDepth_ ) checkOldest(grp,inFlight,head);
+   }
+
+   while ( head < inFlight.size() ) checkOldest(grp,inFlight,head);
+}
+
+//! Group thread for write and verify sequence
+void rim::BulkOp::runWrite(Group *grp, bool force) {
+   process(grp,rim::Write,force);
+   process(grp,rim::Verify,false);
+}
+
+//! Group thread for read sequence
+void rim::BulkOp::runRead(Group *grp) {
+   process(grp,rim::Read,false);
+}
+
+//! Run group threads and report results
+void rim::BulkOp::execute(bool write, bool force) {
+   std::vector<std::thread *> threads;
+   std::vector<std::thread *>::iterator tit;
+   std::vector<Group>::iterator git;
+   std::string first;
+   uint32_t errCount;
+
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+
+   for ( git = groups_.begin(); git != groups_.end(); ++git ) {
+      git->update.assign(git->blocks.size(),false);
+      git->failed.assign(git->blocks.size(),false);
+      git->errors.clear();
+
+      if ( write ) threads.push_back(new std::thread(&rim::BulkOp::runWrite, this, &(*git), force));
+      else threads.push_back(new std::thread(&rim::BulkOp::runRead, this, &(*git)));
+   }
+
+   for ( tit = threads.begin(); tit != threads.end(); ++tit ) {
+      (*tit)->join();
+      delete (*tit);
+   }
+
+   errCount = 0;
+
+   // Variable updates acquire the GIL
+   for ( git = groups_.begin(); git != groups_.end(); ++git ) {
+
+#ifndef NO_PYTHON
+      for (uint32_t idx=0; idx < git->blocks.size(); idx++) {
+         if ( git->update[idx] ) git->blocks[idx]->varUpdate();
+      }
+#endif
+
+      if ( git->errors.size() > 0 ) {
+         if ( errCount == 0 ) first = git->errors.front();
+         errCount += git->errors.size();
+      }
+   }
+
+   if ( errCount > 0 )
+      throw(rogue::GeneralError::create("BulkOp::execute",
+               "%i block errors during bulk %s. First error: %s",
+               errCount, (write?"write":"read"), first.c_str()));
+}
+
+//! Perform a write, verify and check sequence on all Blocks
+void rim::BulkOp::write(bool force) {
+   execute(true,force);
+}
+
+//! Perform a read and check sequence on all Blocks
+void rim::BulkOp::read() {
+   execute(false,false);
+}
+
+void rim::BulkOp::setup_python () {
+#ifndef NO_PYTHON
+
+   bp::class_<rim::BulkOp, rim::BulkOpPtr, boost::noncopyable >("BulkOp",bp::init<uint32_t>())
+      .def("setBlocks",     &rim::BulkOp::setBlocksPy)
+      .def("getGroupCount", &rim::BulkOp::getGroupCount)
+      .def("write",         &rim::BulkOp::write)
+      .def("read",          &rim::BulkOp::read)
+   ;
+#endif
+}
+
@@ -0,0 +1,272 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Memory Emulator
+ * ----------------------------------------------------------------------------
+ * File       : Emulate.cpp
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Native memory space emulator.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#include <rogue/interfaces/memory/Emulate.h>
+#include <rogue/interfaces/memory/Constants.h>
+#include <rogue/interfaces/memory/Transaction.h>
+#include <rogue/interfaces/memory/TransactionLock.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <memory>
+#include <cstring>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <inttypes.h>
+
+namespace rim = rogue::interfaces::memory;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+//! Class creation
+rim::EmulatePtr rim::Emulate::create (uint32_t min, uint32_t max) {
+   rim::EmulatePtr r = std::make_shared<rim::Emulate>(min,max);
+   return(r);
+}
+
+//! Creator
+rim::Emulate::Emulate(uint32_t min, uint32_t max) : rim::Slave(min,max) {
+   log_ = rogue::Logging::create("memory.Emulate");
+
+   fd_        = -1;
+   mapSize_   = 0;
+   map_       = NULL;
+   totAlloc_  = 0;
+   tranCount_ = 0;
+}
+
+//! Destructor
+rim::Emulate::~Emulate() {
+   release();
+}
+
+//! Stop the interface
+void rim::Emulate::stop() {
+   std::vector<std::unique_lock<std::mutex>> locks;
+
+   rogue::GilRelease noGil;
+   lockAll(locks);
+   if ( map_ != NULL ) msync(map_,mapSize_,MS_SYNC);
+}
+
+//! Get the stripe which owns a page
+rim::Emulate::Stripe & rim::Emulate::stripe(uint64_t page) {
+   return stripes_[(page / PageSize) % StripeCount];
+}
+
+//! Lock all stripes, always in the same order
+void rim::Emulate::lockAll(std::vector<std::unique_lock<std::mutex>> & locks) {
+   uint32_t x;
+
+   locks.reserve(StripeCount);
+   for (x=0; x < StripeCount; x++) locks.emplace_back(stripes_[x].mtx);
+}
+
+//! Unmap file and free allocated pages
+void rim::Emulate::release() {
+   PageMap::iterator it;
+   uint32_t x;
+
+   for (x=0; x < StripeCount; x++) {
+      for ( it = stripes_[x].pages.begin(); it != stripes_[x].pages.end(); ++it ) free(it->second);
+      stripes_[x].pages.clear();
+   }
+   totAlloc_ = 0;
+
+   if ( map_ != NULL ) {
+      munmap(map_,mapSize_);
+      map_ = NULL;
+   }
+
+   if ( fd_ >= 0 ) {
+      ::close(fd_);
+      fd_ = -1;
+   }
+   mapSize_ = 0;
+}
+
+//! Back the emulated address space with a file
+void rim::Emulate::mapFile(std::string path, uint64_t size) {
+   std::vector<std::unique_lock<std::mutex>> locks;
+   struct stat st;
+
+   rogue::GilRelease noGil;
+   lockAll(locks);
+
+   release();
+
+   if ( (fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) < 0 )
+      throw(rogue::GeneralError::create("Emulate::mapFile", "Failed to open file: %s",path.c_str()));
+
+   // Extend file as a sparse file, never truncate existing data
+   if ( fstat(fd_,&st) != 0 || ((uint64_t)st.st_size < size && ftruncate(fd_,size) != 0) ) {
+      ::close(fd_);
+      fd_ = -1;
+      throw(rogue::GeneralError::create("Emulate::mapFile", "Failed to size file %s to %" PRIu64 " bytes",path.c_str(),size));
+   }
+
+   if ( (map_ = (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd_, 0)) == MAP_FAILED ) {
+      map_ = NULL;
+      ::close(fd_);
+      fd_ = -1;
+      throw(rogue::GeneralError::create("Emulate::mapFile", "Failed to map file %s",path.c_str()));
+   }
+   mapSize_ = size;
+
+   log_->debug("Mapped file %s with size 0x%" PRIx64, path.c_str(), size);
+}
+
+//! Get total allocated memory in bytes
+uint64_t rim::Emulate::getTotalAllocated() {
+   return totAlloc_;
+}
+
+//! Get number of allocated pages
+uint32_t rim::Emulate::getPageCount() {
+   uint32_t ret;
+   uint32_t x;
+
+   rogue::GilRelease noGil;
+
+   ret = 0;
+   for (x=0; x < StripeCount; x++) {
+      std::lock_guard<std::mutex> lock(stripes_[x].mtx);
+      ret += stripes_[x].pages.size();
+   }
+   return ret;
+}
+
+//! Get number of serviced transactions
+uint64_t rim::Emulate::getTransactionCount() {
+   return tranCount_;
+}
+
+//! Service a transaction
+void rim::Emulate::doTransaction(rim::TransactionPtr tran) {
+   PageMap::iterator it;
+   uint64_t addr;
+   uint64_t page;
+   uint64_t off;
+   uint32_t size;
+   uint32_t len;
+   uint8_t * tPtr;
+   uint8_t * pPtr;
+   bool write;
+   bool first;
+
+   rogue::GilRelease noGil;
+   rim::TransactionLockPtr tlock = tran->lock();
+
+   if ( tran->expired() ) {
+      log_->warning("Transaction expired. Id=%i",tran->id());
+      return;
+   }
+
+   addr  = tran->address();
+   size  = tran->size();
+   tPtr  = tran->begin();
+   write = (tran->type() == rim::Write || tran->type() == rim::Post);
+   first = true;
+
+   if ( min() > 0 && (addr % min()) != 0 ) {
+      tran->error("Transaction address 0x%" PRIx64 " is not aligned to min access %i",addr,min());
+      return;
+   }
+
+   if ( size > max() ) {
+      tran->error("Transaction size %i exceeds max access %i",size,max());
+      return;
+   }
+
+   // Each page is accessed under the lock of its stripe. The mapping only
+   // changes with all stripes locked.
+   while ( size > 0 ) {
+      off  = addr % PageSize;
+      page = addr - off;
+      len  = ((PageSize - off) < size) ? (PageSize - off) : size;
+
+      Stripe & st = stripe(page);
+      std::lock_guard<std::mutex> lock(st.mtx);
+
+      // File backed space, whole transaction is checked before the first access
+      if ( map_ != NULL ) {
+         if ( addr > mapSize_ || (first ? size : len) > (mapSize_ - addr) ) {
+            tran->error("Transaction to address 0x%" PRIx64 " with size %i is out of bounds",tran->address(),tran->size());
+            return;
+         }
+
+         if ( write ) std::memcpy(map_ + addr, tPtr, len);
+         else std::memcpy(tPtr, map_ + addr, len);
+      }
+
+      // Sparse paged space
+      else {
+         it = st.pages.find(page);
+
+         if ( write ) {
+
+            // Allocate page on first write
+            if ( it == st.pages.end() ) {
+               if ( (pPtr = (uint8_t *)calloc(PageSize,1)) == NULL ) {
+                  tran->error("Failed to allocate page for address 0x%" PRIx64,addr);
+                  return;
+               }
+               st.pages.insert(std::make_pair(page, pPtr));
+               totAlloc_ += PageSize;
+            }
+            else pPtr = it->second;
+
+            std::memcpy(pPtr + off, tPtr, len);
+         }
+
+         // Unallocated pages read as zero
+         else if ( it == st.pages.end() ) std::memset(tPtr, 0, len);
+         else std::memcpy(tPtr, it->second + off, len);
+      }
+
+      addr += len;
+      tPtr += len;
+      size -= len;
+      first = false;
+   }
+
+   tranCount_++;
+   tran->done();
+}
+
+void rim::Emulate::setup_python () {
+#ifndef NO_PYTHON
+
+   bp::class_<rim::Emulate, rim::EmulatePtr, bp::bases<rim::Slave>, boost::noncopyable >("Emulate",bp::init<uint32_t, uint32_t>())
+      .def("mapFile",             &rim::Emulate::mapFile)
+      .def("getTotalAllocated",   &rim::Emulate::getTotalAllocated)
+      .def("getPageCount",        &rim::Emulate::getPageCount)
+      .def("getTransactionCount", &rim::Emulate::getTransactionCount)
+   ;
+
+   bp::implicitly_convertible<rim::EmulatePtr, rim::SlavePtr>();
+#endif
+}
+
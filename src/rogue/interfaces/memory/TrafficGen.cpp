@@ -0,0 +1,157 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Memory Traffic Generator
+ * ----------------------------------------------------------------------------
+ * File       : TrafficGen.cpp
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Native memory transaction generator for throughput measurements.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#include <rogue/interfaces/memory/TrafficGen.h>
+#include <rogue/interfaces/memory/Constants.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <inttypes.h>
+
+namespace rim = rogue::interfaces::memory;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+//! Class creation
+rim::TrafficGenPtr rim::TrafficGen::create () {
+   rim::TrafficGenPtr r = std::make_shared<rim::TrafficGen>();
+   return(r);
+}
+
+//! Creator
+rim::TrafficGen::TrafficGen() : rim::Master() {
+   log_ = rogue::Logging::create("memory.TrafficGen");
+
+   tranCount_ = 0;
+   errCount_  = 0;
+   byteCount_ = 0;
+   runTime_   = 0;
+}
+
+//! Destructor
+rim::TrafficGen::~TrafficGen() { }
+
+//! Run the generator
+void rim::TrafficGen::run(uint32_t threads, uint32_t count, uint32_t size, uint64_t base, uint64_t span) {
+   std::vector<std::thread *> thList;
+   uint32_t x;
+
+   if ( threads == 0 || size == 0 || span < size )
+      throw(rogue::GeneralError::create("TrafficGen::run",
+               "Invalid configuration: threads=%i, size=%i, span=%" PRIu64,threads,size,span));
+
+   rogue::GilRelease noGil;
+
+   tranCount_ = 0;
+   errCount_  = 0;
+   byteCount_ = 0;
+
+   std::chrono::steady_clock::time_point sTime = std::chrono::steady_clock::now();
+
+   for (x=0; x < threads; x++)
+      thList.push_back(new std::thread(&rim::TrafficGen::runThread, this, x, base + x * span, span, size, count));
+
+   for (x=0; x < threads; x++) {
+      thList[x]->join();
+      delete thList[x];
+   }
+
+   runTime_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - sTime).count();
+
+   log_->debug("Completed %" PRIu64 " transactions in %f seconds, errors=%" PRIu64,
+         tranCount_.load(), runTime_, errCount_.load());
+}
+
+//! Thread body
+void rim::TrafficGen::runThread(uint32_t idx, uint64_t base, uint64_t span, uint32_t size, uint32_t count) {
+   uint64_t addr;
+   uint32_t id;
+   uint32_t x;
+   uint32_t y;
+
+   // Each thread has its own master so that only the slave is shared
+   rim::MasterPtr mast = rim::Master::create();
+   mast->setSlave(getSlave());
+
+   std::vector<uint8_t> wData(size);
+   std::vector<uint8_t> rData(size);
+
+   for (x=0; x < count; x++) {
+      addr = base + ((uint64_t)x * size) % (span - span % size);
+
+      for (y=0; y < size; y++) wData[y] = (uint8_t)(idx + x + y);
+
+      id = mast->reqTransaction(addr, size, wData.data(), rim::Write);
+      mast->waitTransaction(id);
+
+      id = mast->reqTransaction(addr, size, rData.data(), rim::Read);
+      mast->waitTransaction(id);
+
+      if ( mast->getError() != "" ) {
+         mast->clearError();
+         errCount_++;
+      }
+      else if ( std::memcmp(wData.data(), rData.data(), size) != 0 ) errCount_++;
+
+      tranCount_ += 2;
+      byteCount_ += 2 * size;
+   }
+}
+
+//! Get number of transactions completed by the last run
+uint64_t rim::TrafficGen::getTransactionCount() {
+   return tranCount_;
+}
+
+//! Get number of errors in the last run
+uint64_t rim::TrafficGen::getErrorCount() {
+   return errCount_;
+}
+
+//! Get the transaction rate of the last run
+double rim::TrafficGen::getRate() {
+   return (runTime_ > 0) ? (tranCount_ / runTime_) : 0.0;
+}
+
+//! Get the bandwidth of the last run
+double rim::TrafficGen::getBandwidth() {
+   return (runTime_ > 0) ? (byteCount_ / runTime_) : 0.0;
+}
+
+void rim::TrafficGen::setup_python () {
+#ifndef NO_PYTHON
+
+   bp::class_<rim::TrafficGen, rim::TrafficGenPtr, bp::bases<rim::Master>, boost::noncopyable >("TrafficGen",bp::init<>())
+      .def("run",                 &rim::TrafficGen::run)
+      .def("getTransactionCount", &rim::TrafficGen::getTransactionCount)
+      .def("getErrorCount",       &rim::TrafficGen::getErrorCount)
+      .def("getRate",             &rim::TrafficGen::getRate)
+      .def("getBandwidth",        &rim::TrafficGen::getBandwidth)
+   ;
+
+   bp::implicitly_convertible<rim::TrafficGenPtr, rim::MasterPtr>();
+#endif
+}
@@ -0,0 +1,340 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : Memory Variable Update Bus
+ * ----------------------------------------------------------------------------
+ * File       : UpdateBus.cpp
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Lock free publication of variable update notifications.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#include <rogue/interfaces/memory/UpdateBus.h>
+#include <rogue/interfaces/memory/Block.h>
+#include <rogue/interfaces/memory/Variable.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <memory>
+#include <chrono>
+
+namespace rim = rogue::interfaces::memory;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+//! Class creation
+rim::UpdateBusPtr rim::UpdateBus::create (uint32_t maxVariables) {
+   rim::UpdateBusPtr r = std::make_shared<rim::UpdateBus>(maxVariables);
+   return(r);
+}
+
+//! Creator
+rim::UpdateBus::UpdateBus(uint32_t maxVariables) {
+   uint32_t size;
+   uint32_t x;
+
+   maxVars_  = (maxVariables == 0) ? 1 : maxVariables;
+   varCount_ = 0;
+
+   // Each ID is in the ring at most once, a power of two ring
+   // which holds every variable can never overflow
+   size = 1;
+   while ( size < maxVars_ ) size <<= 1;
+
+   mask_ = size - 1;
+   ring_.reset(new Cell[size]);
+   for (x=0; x < size; x++) ring_[x].seq.store(x,std::memory_order_relaxed);
+
+   vars_.reset(new VarState[maxVars_]);
+   for (x=0; x < maxVars_; x++) {
+      vars_[x].pending.store(false,std::memory_order_relaxed);
+      vars_[x].version.store(0,std::memory_order_relaxed);
+   }
+
+   head_.store(0);
+   tail_ = 0;
+
+   waiting_.store(false);
+   stopped_.store(false);
+   holdCount_.store(0);
+   pubCount_.store(0);
+   coalCount_.store(0);
+}
+
+//! Destructor
+rim::UpdateBus::~UpdateBus() {
+   stop();
+}
+
+// Push an ID into the ring
+bool rim::UpdateBus::push(uint32_t id) {
+   Cell    * cell;
+   uint32_t  pos;
+   uint32_t  seq;
+   int32_t   dif;
+
+   pos = head_.load(std::memory_order_relaxed);
+
+   while (1) {
+      cell = &(ring_[pos & mask_]);
+      seq  = cell->seq.load(std::memory_order_acquire);
+      dif  = (int32_t)seq - (int32_t)pos;
+
+      if ( dif == 0 ) {
+         if ( head_.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed) ) break;
+      }
+      else if ( dif < 0 ) return false;
+      else pos = head_.load(std::memory_order_relaxed);
+   }
+
+   cell->id = id;
+   cell->seq.store(pos+1,std::memory_order_release);
+   return true;
+}
+
+// Pop an ID from the ring, single consumer
+bool rim::UpdateBus::pop(uint32_t & id) {
+   Cell * cell;
+
+   cell = &(ring_[tail_ & mask_]);
+   if ( cell->seq.load(std::memory_order_acquire) != (tail_ + 1) ) return false;
+
+   id = cell->id;
+   cell->seq.store(tail_ + mask_ + 1,std::memory_order_release);
+   tail_++;
+   return true;
+}
+
+// Check if ring has data
+bool rim::UpdateBus::ready() {
+   return(ring_[tail_ & mask_].seq.load(std::memory_order_acquire) == (tail_ + 1));
+}
+
+// Wait for data, return false on timeout or stop
+bool rim::UpdateBus::wait(uint32_t timeout) {
+   std::unique_lock<std::mutex> lock(mtx_);
+
+   // Announce the wait before checking the ring again. A producer
+   // which pushes after this point will observe the flag and notify.
+   // The fence pairs with the one in publish() so that either the
+   // producer sees the flag or this thread sees the pushed entry.
+   waiting_.store(true);
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+
+   if ( ((!ready()) || holdCount_.load() > 0) && (!stopped_.load()) )
+      cond_.wait_for(lock,std::chrono::microseconds(timeout));
+
+   waiting_.store(false);
+   return(ready() && holdCount_.load() == 0);
+}
+
+//! Register all update enabled variables in a Block with the bus
+void rim::UpdateBus::addBlock(rim::BlockPtr block) {
+   std::vector<rim::VariablePtr>::iterator vit;
+
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+
+   for ( vit = block->variables_.begin(); vit != block->variables_.end(); ++vit ) {
+      if ( (!(*vit)->updateNotify_) || (*vit)->busId_ >= 0 ) continue;
+
+      if ( varCount_ == maxVars_ )
+         throw(rogue::GeneralError::create("UpdateBus::addBlock",
+            "Variable count exceeds bus size %i while adding block %s",maxVars_,block->path().c_str()));
+
+      vars_[varCount_].var = *vit;
+      (*vit)->busId_ = varCount_;
+      varCount_.store(varCount_ + 1,std::memory_order_release);
+   }
+   block->updateBus_ = shared_from_this();
+}
+
+//! Get the number of registered variables
+uint32_t rim::UpdateBus::getVariableCount() {
+   return varCount_.load();
+}
+
+//! Get the variable associated with an ID
+rim::VariablePtr rim::UpdateBus::getVariable(uint32_t id) {
+   if ( id >= varCount_ )
+      throw(rogue::GeneralError::create("UpdateBus::getVariable","Invalid variable id %i",id));
+
+   return vars_[id].var;
+}
+
+//! Publish an update for a variable ID
+void rim::UpdateBus::publish(uint32_t id) {
+   VarState * st;
+
+   if ( id >= varCount_.load(std::memory_order_acquire) )
+      throw(rogue::GeneralError::create("UpdateBus::publish","Invalid variable id %i",id));
+
+   st = &(vars_[id]);
+
+   st->version.fetch_add(1,std::memory_order_relaxed);
+   pubCount_++;
+
+   // Already queued, the consumer will pick up the latest value
+   if ( st->pending.exchange(true) ) {
+      coalCount_++;
+      return;
+   }
+
+   push(id);
+
+   // Pairs with the fence in wait(), see above
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+
+   if ( waiting_.load() ) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      cond_.notify_one();
+   }
+}
+
+//! Hold delivery of updates to the consumer
+void rim::UpdateBus::hold() {
+   holdCount_++;
+}
+
+//! Release a hold on the delivery of updates
+void rim::UpdateBus::release() {
+   uint32_t cur = holdCount_.load();
+
+   do {
+      if ( cur == 0 ) throw(rogue::GeneralError::create("UpdateBus::release","Release without a matching hold"));
+   } while ( ! holdCount_.compare_exchange_weak(cur,cur-1) );
+
+   // Wake the consumer so held updates are delivered
+   if ( cur == 1 ) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      cond_.notify_all();
+   }
+}
+
+//! Consume a batch of updates
+uint32_t rim::UpdateBus::consume(std::vector<rim::UpdateBus::Update> & batch,
+                                 uint32_t maxCount, uint32_t timeout, bool withData) {
+   rim::Variable * var;
+   VarState      * st;
+   uint32_t        count;
+   uint32_t        size;
+   uint32_t        id;
+   uint32_t        x;
+
+   std::lock_guard<std::mutex> lock(popMtx_);
+
+   if ( ((!ready()) || holdCount_.load() > 0) && (timeout == 0 || !wait(timeout)) ) return 0;
+
+   count = 0;
+   while ( (maxCount == 0 || count < maxCount) && pop(id) ) {
+      st = &(vars_[id]);
+
+      // Clear pending before reading so later publications are queued again
+      st->pending.store(false);
+
+      batch.push_back(Update());
+      batch.back().id      = id;
+      batch.back().version = st->version.load(std::memory_order_relaxed);
+
+      if ( withData ) {
+         var = st->var.get();
+
+         if ( var->numValues_ == 0 ) {
+            batch.back().data.resize(var->valueBytes_);
+            var->block_->getBytes(batch.back().data.data(), var, 0);
+         }
+         else {
+            size = var->valueBytes_;
+            batch.back().data.resize(var->numValues_ * size);
+            for (x=0; x < var->numValues_; x++)
+               var->block_->getBytes(batch.back().data.data() + (x * size), var, x);
+         }
+      }
+      count++;
+   }
+   return count;
+}
+
+//! Get the total number of publish calls
+uint64_t rim::UpdateBus::getPublishCount() {
+   return pubCount_.load();
+}
+
+//! Get the number of publish calls which were coalesced with a pending update
+uint64_t rim::UpdateBus::getCoalesceCount() {
+   return coalCount_.load();
+}
+
+//! Stop the bus and wake the consumer
+void rim::UpdateBus::stop() {
+   stopped_.store(true);
+   std::lock_guard<std::mutex> lock(mtx_);
+   cond_.notify_all();
+}
+
+#ifndef NO_PYTHON
+
+//! Consume a batch of variable IDs, Python version
+bp::object rim::UpdateBus::popPy(uint32_t timeout) {
+   std::vector<rim::UpdateBus::Update> batch;
+   std::vector<rim::UpdateBus::Update>::iterator it;
+   bp::list ret;
+
+   {
+      rogue::GilRelease noGil;
+      consume(batch,0,timeout,false);
+   }
+
+   for ( it = batch.begin(); it != batch.end(); ++it ) ret.append(it->id);
+   return ret;
+}
+
+//! Consume a batch of updates with data, Python version
+bp::object rim::UpdateBus::popValuesPy(uint32_t timeout) {
+   std::vector<rim::UpdateBus::Update> batch;
+   std::vector<rim::UpdateBus::Update>::iterator it;
+   bp::list ret;
+
+   {
+      rogue::GilRelease noGil;
+      consume(batch,0,timeout,true);
+   }
+
+   for ( it = batch.begin(); it != batch.end(); ++it ) {
+      PyObject *val = PyByteArray_FromStringAndSize((const char *)it->data.data(),it->data.size());
+      bp::handle<> handle(val);
+      ret.append(bp::make_tuple(it->id,it->version,bp::object(handle)));
+   }
+   return ret;
+}
+
+#endif
+
+void rim::UpdateBus::setup_python() {
+#ifndef NO_PYTHON
+
+   bp::class_<rim::UpdateBus, rim::UpdateBusPtr, boost::noncopyable>("UpdateBus",bp::init<uint32_t>())
+      .def("addBlock",         &rim::UpdateBus::addBlock)
+      .def("getVariableCount", &rim::UpdateBus::getVariableCount)
+      .def("getVariable",      &rim::UpdateBus::getVariable)
+      .def("publish",          &rim::UpdateBus::publish)
+      .def("hold",             &rim::UpdateBus::hold)
+      .def("release",          &rim::UpdateBus::release)
+      .def("pop",              &rim::UpdateBus::popPy)
+      .def("popValues",        &rim::UpdateBus::popValuesPy)
+      .def("getPublishCount",  &rim::UpdateBus::getPublishCount)
+      .def("getCoalesceCount", &rim::UpdateBus::getCoalesceCount)
+      .def("stop",             &rim::UpdateBus::stop)
+   ;
+#endif
+}
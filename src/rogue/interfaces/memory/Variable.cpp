@@ -136,6 +136,7 @@ rim::Variable::Variable ( std::string name,
    valueStride_  = valueStride;
    stale_        = false;
    retryCount_   = retryCount;
+   busId_        = -1;
 
    // Compute bit total
    bitTotal_ = bitSize_[0];
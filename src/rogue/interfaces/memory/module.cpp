@@ -29,6 +29,10 @@
 #include <rogue/interfaces/memory/TcpServer.h>
 #include <rogue/interfaces/memory/Block.h>
 #include <rogue/interfaces/memory/Variable.h>
+#include <rogue/interfaces/memory/Emulate.h>
+#include <rogue/interfaces/memory/TrafficGen.h>
+#include <rogue/interfaces/memory/BulkOp.h>
+#include <rogue/interfaces/memory/UpdateBus.h>
 
 #define BOOST_BIND_GLOBAL_PLACEHOLDERS
 #include <boost/python.hpp>
@@ -74,5 +78,9 @@ void rim::setup_module() {
    rim::TcpServer::setup_python();
    rim::Block::setup_python();
    rim::Variable::setup_python();
+   rim::Emulate::setup_python();
+   rim::TrafficGen::setup_python();
+   rim::BulkOp::setup_python();
+   rim::UpdateBus::setup_python();
 }
 
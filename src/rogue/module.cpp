@@ -31,6 +31,7 @@
 #include <rogue/GeneralError.h>
 #include <rogue/Logging.h>
 #include <rogue/Version.h>
+#include <rogue/LibraryBase.h>
 
 namespace bp  = boost::python;
 
@@ -44,6 +45,7 @@ void rogue::setup_module() {
    rogue::GeneralError::setup_python();
    rogue::Logging::setup_python();
    rogue::Version::setup_python();
+   rogue::LibraryBase::setup_python();
 
 }
 
@@ -0,0 +1,286 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : AXI Batcher V1 Combiner
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Software equivalent of the firmware AxiStreamBatcher. Combines incoming
+ * frames into version 1 super-frames, see CoreV1.cpp for the format.
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#include <stdint.h>
+#include <thread>
+#include <memory>
+#include <string.h>
+#include <rogue/interfaces/stream/Master.h>
+#include <rogue/interfaces/stream/Slave.h>
+#include <rogue/interfaces/stream/Frame.h>
+#include <rogue/interfaces/stream/FrameLock.h>
+#include <rogue/interfaces/stream/FrameIterator.h>
+#include <rogue/protocols/batcher/CombinerV1.h>
+#include <rogue/GeneralError.h>
+#include <rogue/Logging.h>
+#include <rogue/GilRelease.h>
+
+namespace rpb = rogue::protocols::batcher;
+namespace ris = rogue::interfaces::stream;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+//! Class creation
+rpb::CombinerV1Ptr rpb::CombinerV1::create(uint32_t width, uint32_t maxSize) {
+   rpb::CombinerV1Ptr p = std::make_shared<rpb::CombinerV1>(width,maxSize);
+   return(p);
+}
+
+//! Setup class in python
+void rpb::CombinerV1::setup_python() {
+#ifndef NO_PYTHON
+   bp::class_<rpb::CombinerV1, rpb::CombinerV1Ptr, bp::bases<ris::Master,ris::Slave>, boost::noncopyable >("CombinerV1",bp::init<uint32_t,uint32_t>())
+      .def("setTimeout",     &rpb::CombinerV1::setTimeout)
+      .def("flush",          &rpb::CombinerV1::flush)
+      .def("getBatchCount",  &rpb::CombinerV1::getBatchCount)
+      .def("getRecordCount", &rpb::CombinerV1::getRecordCount)
+   ;
+#endif
+}
+
+//! Creator
+rpb::CombinerV1::CombinerV1(uint32_t width, uint32_t maxSize) : ris::Master(), ris::Slave() {
+   log_ = rogue::Logging::create("batcher.CombinerV1");
+
+   // Width code is log2(width/2), matching the firmware header
+   for (width_=0; width_ < 6; width_++)
+      if ( (2u << width_) == width ) break;
+
+   if ( width_ == 6 )
+      throw(rogue::GeneralError::create("batcher::CombinerV1::CombinerV1",
+               "Invalid width %i, must be a power of 2 from 2 to 64",width));
+
+   headerSize_ = width;
+   tailSize_   = (headerSize_ < 8)?8:headerSize_;
+
+   if ( maxSize < (headerSize_ + tailSize_ + headerSize_) )
+      throw(rogue::GeneralError::create("batcher::CombinerV1::CombinerV1",
+               "Max size %i is too small for width %i",maxSize,width));
+
+   maxSize_     = maxSize;
+   timeout_     = 1000;
+   seq_         = 0;
+   size_        = 0;
+   count_       = 0;
+   batchCount_  = 0;
+   recordCount_ = 0;
+   sending_     = false;
+
+   threadEn_ = true;
+   thread_   = new std::thread(&rpb::CombinerV1::runThread, this);
+
+   // Set a thread name
+#ifndef __MACH__
+   pthread_setname_np( thread_->native_handle(), "CombinerV1" );
+#endif
+}
+
+//! Deconstructor
+rpb::CombinerV1::~CombinerV1() {
+   rogue::GilRelease noGil;
+   {
+      std::lock_guard<std::mutex> lock(mtx_);
+      threadEn_ = false;
+      cond_.notify_all();
+   }
+   thread_->join();
+   delete thread_;
+}
+
+//! Set flush timeout in microseconds, zero flushes only when full
+void rpb::CombinerV1::setTimeout(uint32_t timeout) {
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+   timeout_ = timeout;
+   deadline_ = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_);
+   cond_.notify_all();
+}
+
+//! Send the current super-frame
+void rpb::CombinerV1::flush() {
+   rogue::GilRelease noGil;
+   std::unique_lock<std::mutex> lock(mtx_);
+   flushLocked();
+   sendQueued(lock);
+}
+
+//! Get super-frame count
+uint32_t rpb::CombinerV1::getBatchCount() {
+   return batchCount_;
+}
+
+//! Get record count
+uint32_t rpb::CombinerV1::getRecordCount() {
+   return recordCount_;
+}
+
+//! Queue current super-frame, called with lock held
+void rpb::CombinerV1::flushLocked() {
+   ris::FramePtr frame;
+
+   if ( ! frame_ ) return;
+
+   frame = frame_;
+   frame_.reset();
+
+   frame->setPayload(size_);
+
+   // SOF in first user, as set by ssiSetUserSof in firmware
+   frame->setFirstUser(0x2);
+   frame->setLastUser(0x0);
+
+   log_->debug("Sending super-frame: seq=%i, records=%i, size=%i",seq_,count_,size_);
+
+   seq_++;
+   batchCount_++;
+   size_  = 0;
+   count_ = 0;
+
+   txQueue_.push_back(frame);
+}
+
+//! Send queued super-frames, lock is released while sending
+void rpb::CombinerV1::sendQueued(std::unique_lock<std::mutex> & lock) {
+   ris::FramePtr frame;
+
+   // Another thread is draining the queue and will send these in order
+   if ( sending_ ) return;
+   sending_ = true;
+
+   while ( ! txQueue_.empty() ) {
+      frame = txQueue_.front();
+      txQueue_.pop_front();
+
+      lock.unlock();
+      try {
+         sendFrame(frame);
+      } catch (...) {
+         lock.lock();
+         sending_ = false;
+         throw;
+      }
+      frame.reset();
+      lock.lock();
+   }
+   sending_ = false;
+}
+
+//! Accept a frame from master
+void rpb::CombinerV1::acceptFrame ( ris::FramePtr frame ) {
+   uint8_t  buff[64];
+   uint32_t fSize;
+   uint32_t fJump;
+   uint32_t alloc;
+   uint32_t last;
+
+   // Drop errored frames
+   if ( frame->getError() ) {
+      log_->warning("Dropping frame due to error: 0x%x",frame->getError());
+      return;
+   }
+
+   rogue::GilRelease noGil;
+   ris::FrameLockPtr flock = frame->lock();
+   std::unique_lock<std::mutex> lock(mtx_);
+
+   // Record is padded to width, followed by tail
+   fSize = frame->getPayload();
+   if ( (fSize % headerSize_) == 0) fJump = fSize;
+   else fJump = ((fSize / headerSize_) + 1) * headerSize_;
+
+   // Send current super-frame if record does not fit
+   if ( frame_ && (size_ + fJump + tailSize_) > maxSize_ ) flushLocked();
+
+   // Start a new super-frame, a record larger than max size is sent on its own
+   if ( ! frame_ ) {
+      alloc = headerSize_ + fJump + tailSize_;
+      if ( alloc < maxSize_ ) alloc = maxSize_;
+
+      frame_ = reqFrame(alloc,true);
+      frame_->setPayload(alloc);
+      iter_ = frame_->begin();
+
+      // Header, remainder of width is zero
+      memset(buff,0,headerSize_);
+      buff[0] = 0x1 | (width_ << 4);
+      buff[1] = seq_;
+      ris::toFrame(iter_,headerSize_,buff);
+      size_ = headerSize_;
+
+      deadline_ = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_);
+      cond_.notify_all();
+   }
+
+   // Record data and zero padding
+   if ( fSize > 0 ) {
+      ris::FrameIterator src = frame->begin();
+      ris::copyFrame(src,fSize,iter_);
+   }
+
+   memset(buff,0,tailSize_);
+   if ( fJump > fSize ) ris::toFrame(iter_,fJump-fSize,buff);
+
+   // Valid bytes in last width of record
+   last = fSize % headerSize_;
+   if ( last == 0 && fSize > 0 ) last = headerSize_;
+
+   // Tail, remainder of width is zero
+   buff[0] = (fSize >>  0) & 0xFF;
+   buff[1] = (fSize >>  8) & 0xFF;
+   buff[2] = (fSize >> 16) & 0xFF;
+   buff[3] = (fSize >> 24) & 0xFF;
+   buff[4] = frame->getChannel();
+   buff[5] = frame->getFirstUser();
+   buff[6] = frame->getLastUser();
+   buff[7] = last;
+   ris::toFrame(iter_,tailSize_,buff);
+
+   size_ += fJump + tailSize_;
+   count_++;
+   recordCount_++;
+
+   // Full, no further record can fit
+   if ( (size_ + headerSize_ + tailSize_) > maxSize_ ) flushLocked();
+
+   // Release the source frame before sending
+   flock->unlock();
+   sendQueued(lock);
+}
+
+//! Thread background
+void rpb::CombinerV1::runThread() {
+   std::unique_lock<std::mutex> lock(mtx_);
+   log_->logThreadId();
+
+   while(threadEn_) {
+
+      // Wait for the flush deadline of an open super-frame
+      if ( frame_ && timeout_ > 0 ) {
+         if ( std::chrono::steady_clock::now() >= deadline_ ) {
+            flushLocked();
+            sendQueued(lock);
+         }
+         else cond_.wait_until(lock,deadline_);
+      }
+      else cond_.wait(lock);
+   }
+}
+
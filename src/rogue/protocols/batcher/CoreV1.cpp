@@ -47,10 +47,13 @@
 #include <memory>
 #include <rogue/interfaces/stream/Frame.h>
 #include <rogue/interfaces/stream/FrameIterator.h>
+#include <rogue/interfaces/stream/Buffer.h>
 #include <rogue/protocols/batcher/CoreV1.h>
 #include <rogue/protocols/batcher/Data.h>
 #include <rogue/GeneralError.h>
 #include <math.h>
+#include <string.h>
+#include <algorithm>
 
 namespace rpb = rogue::protocols::batcher;
 namespace ris = rogue::interfaces::stream;
@@ -78,13 +81,13 @@ rpb::CoreV1::~CoreV1() {}
 
 //! Init size for internal containers
 void rpb::CoreV1::initSize(uint32_t size) {
+   table_.reserve(size);
    list_.reserve(size);
-   tails_.reserve(size);
 }
 
 //! Record count
 uint32_t rpb::CoreV1::count() {
-   return list_.size();
+   return table_.size();
 }
 
 //! Get header size
@@ -109,32 +112,45 @@ uint32_t rpb::CoreV1::tailSize() {
 
 //! Get beginning of tail iterator
 ris::FrameIterator rpb::CoreV1::beginTail(uint32_t index) {
-   if ( index >= tails_.size() )
+   if ( index >= table_.size() )
       throw(rogue::GeneralError::create("bather::CoreV1::beginTail",
-               "Attempt to get tail index %i in message with %i tails",index,tails_.size()));
+               "Attempt to get tail index %i in message with %i tails",index,table_.size()));
 
-   // Invert order on return
-   return tails_[(tails_.size()-1) - index];
+   return frame_->begin() + table_[index].tail;
 }
 
 //! Get end of tail iterator
 ris::FrameIterator rpb::CoreV1::endTail(uint32_t index) {
-   if ( index >= tails_.size() )
+   if ( index >= table_.size() )
       throw rogue::GeneralError::create("batcher::CoreV1::tail",
-            "Attempt to access tail %i in frame with %i tails", index, tails_.size());
+            "Attempt to access tail %i in frame with %i tails", index, table_.size());
 
-   // Invert order on return
-   return tails_[(tails_.size()-1) - index] + tailSize_;
+   return frame_->begin() + (table_[index].tail + tailSize_);
+}
+
+//! Get record table entry
+const rpb::CoreV1::Entry & rpb::CoreV1::entry(uint32_t index) {
+   if ( index >= table_.size() )
+      throw rogue::GeneralError::create("batcher::CoreV1::entry",
+            "Attempt to access entry %i in frame with %i records", index, table_.size());
+
+   return table_[index];
 }
 
 //! Get data
 rpb::DataPtr & rpb::CoreV1::record(uint32_t index) {
-   if ( index >= list_.size() )
+   if ( index >= table_.size() )
       throw rogue::GeneralError::create("batcher::CoreV1::record",
-            "Attempt to access record %i in frame with %i records", index, tails_.size());
+            "Attempt to access record %i in frame with %i records", index, table_.size());
+
+   // Data objects are only created when requested
+   if ( list_.size() != table_.size() ) list_.resize(table_.size());
 
-   // Invert order on return
-   return list_[(list_.size()-1) - index];
+   if ( ! list_[index] ) {
+      rpb::CoreV1::Entry & e = table_[index];
+      list_[index] = rpb::Data::create(frame_->begin() + e.offset, e.size, e.dest, e.fUser, e.lUser);
+   }
+   return list_[index];
 }
 
 //! Return sequence
@@ -142,38 +158,8 @@ uint32_t rpb::CoreV1::sequence() {
    return seq_;
 }
 
-//! Process a frame
-bool rpb::CoreV1::processFrame ( ris::FramePtr frame ) {
-   uint8_t  temp;
-   uint32_t rem;
-   uint32_t fSize;
-   uint8_t  dest;
-   uint8_t  fUser;
-   uint8_t  lUser;
-   uint32_t fJump;
-
-   // Reset old data
-   reset();
-
-   ris::FrameIterator beg;
-   ris::FrameIterator mark;
-   ris::FrameIterator tail;
-
-   // Drop errored frames
-   if ( (frame->getError()) ) {
-      log_->warning("Dropping frame due to error: 0x%x",frame->getError());
-      return false;
-   }
-
-   // Drop small frames
-   if ( (rem = frame->getPayload()) < 16)  {
-      log_->warning("Dropping small frame size = %i",frame->getPayload());
-      return false;
-   }
-
-   // Get version & size
-   beg = frame->begin();
-   ris::fromFrame(beg, 1, &temp);
+//! Set header and tail size from first header byte
+bool rpb::CoreV1::setWidth(uint8_t temp) {
 
    /////////////////////////////////////////////////////////////////////////
    // Super-Frame Header in firmware
@@ -208,23 +194,146 @@ bool rpb::CoreV1::processFrame ( ris::FramePtr frame ) {
 
    // Set tail size, min 64-bits
    tailSize_ = (headerSize_ < 8)?8:headerSize_;
+   return true;
+}
+
+//! Process a frame
+bool rpb::CoreV1::processFrame ( ris::FramePtr frame ) {
+   uint32_t rem;
+   bool     ret;
+
+   // Reset old data
+   reset();
+
+   // Drop errored frames
+   if ( (frame->getError()) ) {
+      log_->warning("Dropping frame due to error: 0x%x",frame->getError());
+      return false;
+   }
+
+   // Drop small frames
+   if ( (rem = frame->getPayload()) < 16)  {
+      log_->warning("Dropping small frame size = %i",frame->getPayload());
+      return false;
+   }
+
+   frame_ = frame;
+
+   // Contiguous frames read tails directly, others step through buffers
+   if ( frame->bufferCount() == 1 ) ret = parseBuffer((*frame->beginBuffer())->begin(),rem);
+   else ret = parseFrame(rem);
+
+   if ( ! ret ) {
+      reset();
+      return false;
+   }
+
+   // Records were found from the end of the frame
+   std::reverse(table_.begin(),table_.end());
+   return true;
+}
+
+//! Parse contiguous frame by pointer
+bool rpb::CoreV1::parseBuffer(const uint8_t *data, uint32_t rem) {
+   rpb::CoreV1::Entry e;
+   uint32_t pos;
+   uint32_t fJump;
+
+   if ( ! setWidth(data[0]) ) return false;
 
    // Get sequence #
-   ris::fromFrame(beg, 1, &seq_);
+   seq_ = data[1];
+
+   // Frame needs to large enough for header + 1 tail
+   if ( rem < (headerSize_ + tailSize_)) {
+      log_->error("Not enough space (%i) for tail (%i) + header (%i)",rem,headerSize_,tailSize_);
+      return false;
+   }
+
+   // Process each record from the end, stop when we have reached just after the header
+   pos = rem;
+   rem -= headerSize_;
+
+   while (rem != 0) {
+
+      // sanity check
+      if ( rem < tailSize_ ) {
+         log_->error("Not enough space (%i) for tail (%i)",rem,tailSize_);
+         return false;
+      }
+
+      // Jump to start of the tail
+      pos -= tailSize_;
+      rem -= tailSize_;
+
+      // Get tail data
+      e.tail = pos;
+      std::memcpy(&e.size, data + pos, 4);
+      e.dest  = data[pos+4];
+      e.fUser = data[pos+5];
+      e.lUser = data[pos+6];
+
+      // Record must fit before rounding, a size near 2^32 would wrap
+      if ( e.size > rem ) {
+         log_->error("Not enough space (%u) for frame (%u)",rem,e.size);
+         return false;
+      }
+
+      // Round up rewind amount to width
+      if ( (e.size % headerSize_) == 0) fJump = e.size;
+      else fJump = ((e.size / headerSize_) + 1) * headerSize_;
+
+      // Not enough data for rewind value
+      if ( fJump > rem ) {
+         log_->error("Not enough space (%i) for frame (%i)",rem,fJump);
+         return false;
+      }
+
+      // Set position to start of data
+      pos -= fJump;
+      rem -= fJump;
+
+      e.offset = pos;
+      table_.push_back(e);
+   }
+   return true;
+}
+
+//! Parse frame using iterators
+bool rpb::CoreV1::parseFrame(uint32_t rem) {
+   rpb::CoreV1::Entry e;
+   uint8_t  temp;
+   uint8_t  seq;
+   uint32_t pos;
+   uint32_t fJump;
+
+   ris::FrameIterator beg;
+   ris::FrameIterator mark;
+   ris::FrameIterator tail;
+
+   // Get version & size
+   beg = frame_->begin();
+   ris::fromFrame(beg, 1, &temp);
+
+   if ( ! setWidth(temp) ) return false;
+
+   // Get sequence #
+   ris::fromFrame(beg, 1, &seq);
+   seq_ = seq;
 
    // Frame needs to large enough for header + 1 tail
    if ( rem < (headerSize_ + tailSize_)) {
       log_->error("Not enough space (%i) for tail (%i) + header (%i)",rem,headerSize_,tailSize_);
-      reset();
       return false;
    }
 
    // Skip the rest of the header, compute remaining frame size
    beg += (headerSize_-2); // Already read 2 bytes from frame
+   pos = rem;
    rem -= headerSize_;
 
    // Set marker to end of frame
-   mark = frame->end();
+   mark = frame_->end();
 
    // Process each frame, stop when we have reached just after the header
    while (mark != beg) {
@@ -232,41 +341,45 @@ bool rpb::CoreV1::processFrame ( ris::FramePtr frame ) {
       // sanity check
       if ( rem < tailSize_ ) {
          log_->error("Not enough space (%i) for tail (%i)",rem,tailSize_);
-         reset();
          return false;
       }
 
       // Jump to start of the tail
       mark -= tailSize_;
+      pos  -= tailSize_;
       rem  -= tailSize_;
 
-      // Add tail iterator to end of list
-      tails_.push_back(mark);
-
       // Get tail data, use a new iterator
+      e.tail = pos;
       tail = mark;
-      ris::fromFrame(tail, 4, &fSize);
-      ris::fromFrame(tail, 1, &dest);
-      ris::fromFrame(tail, 1, &fUser);
-      ris::fromFrame(tail, 1, &lUser);
+      ris::fromFrame(tail, 4, &e.size);
+      ris::fromFrame(tail, 1, &e.dest);
+      ris::fromFrame(tail, 1, &e.fUser);
+      ris::fromFrame(tail, 1, &e.lUser);
+
+      // Record must fit before rounding, a size near 2^32 would wrap
+      if ( e.size > rem ) {
+         log_->error("Not enough space (%u) for frame (%u)",rem,e.size);
+         return false;
+      }
 
       // Round up rewind amount to width
-      if ( (fSize % headerSize_) == 0) fJump = fSize;
-      else fJump = ((fSize / headerSize_) + 1) * headerSize_;
+      if ( (e.size % headerSize_) == 0) fJump = e.size;
+      else fJump = ((e.size / headerSize_) + 1) * headerSize_;
 
       // Not enough data for rewind value
       if ( fJump > rem ) {
          log_->error("Not enough space (%i) for frame (%i)",rem,fJump);
-         reset();
          return false;
       }
 
       // Set marker to start of data
       mark -= fJump;
+      pos  -= fJump;
       rem  -= fJump;
 
-      // Create data record and add it to end of list
-      list_.push_back(rpb::Data::create(mark,fSize,dest,fUser,lUser));
+      e.offset = pos;
+      table_.push_back(e);
    }
    return true;
 }
@@ -274,11 +387,10 @@ bool rpb::CoreV1::processFrame ( ris::FramePtr frame ) {
 //! Reset data
 void rpb::CoreV1::reset() {
    frame_.reset();
+   table_.clear();
    list_.clear();
-   tails_.clear();
 
    headerSize_ = 0;
    tailSize_   = 0;
    seq_        = 0;
 }
-
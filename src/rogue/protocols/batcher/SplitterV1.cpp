@@ -23,6 +23,7 @@
 #include <rogue/interfaces/stream/Frame.h>
 #include <rogue/interfaces/stream/FrameLock.h>
 #include <rogue/interfaces/stream/FrameIterator.h>
+#include <rogue/interfaces/stream/Buffer.h>
 #include <rogue/protocols/batcher/SplitterV1.h>
 #include <rogue/protocols/batcher/CoreV1.h>
 #include <rogue/protocols/batcher/Data.h>
@@ -48,46 +49,187 @@ rpb::SplitterV1Ptr rpb::SplitterV1::create() {
 //! Setup class in python
 void rpb::SplitterV1::setup_python() {
 #ifndef NO_PYTHON
-   bp::class_<rpb::SplitterV1, rpb::SplitterV1Ptr, bp::bases<ris::Master,ris::Slave>, boost::noncopyable >("SplitterV1",bp::init<>());
+   bp::class_<rpb::SplitterV1, rpb::SplitterV1Ptr, bp::bases<ris::Master,ris::Slave>, boost::noncopyable >("SplitterV1",bp::init<>())
+      .def("setWorkers", &rpb::SplitterV1::setWorkers)
+      .def("getWorkers", &rpb::SplitterV1::getWorkers)
+      .def("setOrdered", &rpb::SplitterV1::setOrdered)
+      .def("getOrdered", &rpb::SplitterV1::getOrdered)
+   ;
 #endif
 }
 
 //! Creator
-rpb::SplitterV1::SplitterV1() : ris::Master(), ris::Slave() { }
+rpb::SplitterV1::SplitterV1() : ris::Master(), ris::Slave() {
+   ordered_ = true;
+}
 
 //! Deconstructor
-rpb::SplitterV1::~SplitterV1() {}
+rpb::SplitterV1::~SplitterV1() {
+   rogue::GilRelease noGil;
+   workers_.stop();
+}
+
+//! Set number of worker threads, 0 splits in the caller's thread
+void rpb::SplitterV1::setWorkers(uint32_t count) {
+   rogue::GilRelease noGil;
+
+   // Hold the lock so no frame is dispatched while workers change
+   std::lock_guard<std::mutex> lock(mtx_);
+   workers_.start(count, "SplitterV1", &rpb::SplitterV1::runWorker, this);
+}
+
+//! Get number of worker threads
+uint32_t rpb::SplitterV1::getWorkers() {
+   return(workers_.count());
+}
+
+//! Preserve record order across super-frames when using workers
+void rpb::SplitterV1::setOrdered(bool ordered) {
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+   ordered_ = ordered;
+}
+
+//! Get ordered state
+bool rpb::SplitterV1::getOrdered() {
+   return(ordered_);
+}
+
+// Worker thread
+void rpb::SplitterV1::runWorker() {
+   ris::FramePtr frame;
+   uint64_t index;
+   rpb::CoreV1 core;
+
+   while ( workers_.pop(frame,index) ) {
+
+      // Parse outside of the ordering lock
+      ris::FrameLockPtr flock = frame->lock();
+      core.processFrame(frame);
+
+      // Wait for earlier super-frames to be sent
+      workers_.wait(index);
+      process(core,frame);
+      flock->unlock();
+      workers_.done(index);
+
+      frame.reset();
+   }
+}
+
+//! Create a frame referencing part of a super-frame buffer
+ris::FramePtr rpb::SplitterV1::subFrame ( ris::BufferPtr parent, uint32_t offset, uint32_t size ) {
+   ris::FramePtr  nFrame;
+   ris::BufferPtr buff;
+   uint32_t slot;
+
+   // Slot holds the super-frame buffer until the record buffer is returned
+   {
+      std::lock_guard<std::mutex> lock(slotMtx_);
+
+      if ( free_.empty() ) {
+         slot = slots_.size();
+         slots_.push_back(parent);
+      }
+      else {
+         slot = free_.back();
+         free_.pop_back();
+         slots_[slot] = parent;
+      }
+   }
+
+   // Bit 31 marks a zero copy record buffer
+   buff = createBuffer(parent->begin() + offset, 0x80000000 | slot, size, size);
+
+   nFrame = ris::Frame::create();
+   nFrame->appendBuffer(buff);
+   nFrame->setPayload(size);
+   return(nFrame);
+}
+
+//! Return a buffer, releasing super-frame buffer for zero copy records
+void rpb::SplitterV1::retBuffer(uint8_t * data, uint32_t meta, uint32_t size) {
+   ris::BufferPtr parent;
+
+   // Zero copy record as indicated by bit 31
+   if ( (meta & 0x80000000) != 0 ) {
+      rogue::GilRelease noGil;
+      {
+         std::lock_guard<std::mutex> lock(slotMtx_);
+         parent.swap(slots_[meta & 0x7FFFFFFF]);
+         free_.push_back(meta & 0x7FFFFFFF);
+      }
+      decCounter(size);
+
+      // Super-frame buffer is released outside of the lock
+      parent.reset();
+   }
+
+   // Buffer is allocated from Pool class
+   else Pool::retBuffer(data,meta,size);
+}
 
 //! Accept a frame from master
 void rpb::SplitterV1::acceptFrame ( ris::FramePtr frame ) {
-   rpb::CoreV1   core;
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+
+   // Split in the caller's thread
+   if ( ! workers_.active() ) {
+      ris::FrameLockPtr flock = frame->lock();
+      core_.processFrame(frame);
+      process(core_,frame);
+      return;
+   }
+
+   // Dispatch to the worker pool
+   workers_.push(frame,ordered_);
+}
+
+//! Parse a super-frame and send its records, called with frame locked
+void rpb::SplitterV1::process ( rpb::CoreV1 & core, ris::FramePtr frame ) {
+   ris::Frame::BufferIterator bIt;
    ris::FramePtr nFrame;
-   rpb::DataPtr  data;
+   uint32_t bStart;
    uint32_t x;
 
-   // Lock frame
-   rogue::GilRelease noGil;
-   ris::FrameLockPtr lock = frame->lock();
-
-   core.processFrame(frame);
+   bIt    = frame->beginBuffer();
+   bStart = 0;
 
    for (x=0; x < core.count(); x++) {
-      data = core.record(x);
+      const rpb::CoreV1::Entry & e = core.entry(x);
+
+      // Advance to the buffer holding the start of the record
+      while ( bIt != frame->endBuffer() && e.offset >= (bStart + (*bIt)->getPayload()) ) {
+         bStart += (*bIt)->getPayload();
+         ++bIt;
+      }
+
+      // Records within a single buffer are passed without a copy, compare
+      // against the space left in the buffer so offset + size can not wrap
+      if ( bIt != frame->endBuffer() && e.size <= ((*bIt)->getPayload() - (e.offset - bStart)) )
+         nFrame = subFrame(*bIt, e.offset - bStart, e.size);
 
-      // Create a new frame
-      nFrame = reqFrame(data->size(),true);
-      nFrame->setPayload(data->size());
+      // Records spanning buffers are copied into a new frame
+      else {
+         nFrame = reqFrame(e.size,true);
+         nFrame->setPayload(e.size);
 
-      ris::FrameIterator fIter = nFrame->begin();
-      ris::FrameIterator dIter = data->begin();
-      ris::copyFrame(dIter, data->size(), fIter);
+         if ( e.size > 0 ) {
+            ris::FrameIterator fIter = nFrame->begin();
+            ris::FrameIterator dIter = frame->begin() + e.offset;
+            ris::copyFrame(dIter, e.size, fIter);
+         }
+      }
 
       // Set flags
-      nFrame->setFirstUser(data->fUser());
-      nFrame->setLastUser(data->lUser());
-      nFrame->setChannel(data->dest());
+      nFrame->setFirstUser(e.fUser);
+      nFrame->setLastUser(e.lUser);
+      nFrame->setChannel(e.dest);
 
       sendFrame(nFrame);
    }
-}
 
+   // Release the super-frame, table capacity is kept
+   core.reset();
+}
@@ -30,6 +30,7 @@
 #include <rogue/protocols/batcher/Data.h>
 #include <rogue/protocols/batcher/SplitterV1.h>
 #include <rogue/protocols/batcher/InverterV1.h>
+#include <rogue/protocols/batcher/CombinerV1.h>
 
 namespace bp  = boost::python;
 
@@ -48,6 +49,7 @@ void rogue::protocols::batcher::setup_module() {
    rogue::protocols::batcher::Data::setup_python();
    rogue::protocols::batcher::SplitterV1::setup_python();
    rogue::protocols::batcher::InverterV1::setup_python();
+   rogue::protocols::batcher::CombinerV1::setup_python();
 
 }
 
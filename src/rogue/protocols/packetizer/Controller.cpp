@@ -73,12 +73,15 @@ void rpp::Controller::stopQueue() {
 }
 
 //! Transport frame allocation request
-// Needs to be updated to support cascaded packetizers
+// Every buffer returned upstream is used, allowing packetizers to be cascaded
+// over each other or over RSSI without copying the payload.
 ris::FramePtr rpp::Controller::reqFrame ( uint32_t size ) {
+   ris::Frame::BufferIterator it;
    ris::FramePtr  lFrame;
    ris::FramePtr  rFrame;
    ris::BufferPtr buff;
    uint32_t fSize;
+   uint32_t bCount;
 
    // Create frame container for request response
    lFrame = ris::Frame::create();
@@ -94,27 +97,35 @@ ris::FramePtr rpp::Controller::reqFrame ( uint32_t size ) {
 
       // Pass request
       rFrame = tran_->reqFrame (fSize, false);
-
-      // Take only the first buffer. This will break a cascaded packetizer
-      // system. We need to fix this!
-      buff = *(rFrame->beginBuffer());
-
-      // Use buffer tail reservation to align available payload
-      if (((buff->getAvailable()-tailSize_) % alignSize_) != 0)
-         buff->adjustTail((buff->getAvailable()-tailSize_) % alignSize_);
-
-      // Buffer should support our header/tail plus at least one payload byte
-      if ( buff->getAvailable() < (headSize_ + tailSize_ + 1) )
-         throw(rogue::GeneralError::create("packetizer::Controller::reqFrame",
-                  "Buffer size %i is less than min size required %i",
-                  buff->getAvailable(), (headSize_ + tailSize_ + 1)));
-
-      // Add 8 bytes to head and tail reservation
-      buff->adjustHeader(headSize_);
-      buff->adjustTail(tailSize_);
-
-      // Add buffer to return frame
-      lFrame->appendBuffer(buff);
+      bCount = 0;
+
+      // Each upstream buffer becomes one packetizer segment
+      for (it=rFrame->beginBuffer(); it != rFrame->endBuffer(); ++it) {
+         buff = *it;
+
+         // Use buffer tail reservation to align available payload
+         if ( buff->getAvailable() > tailSize_ && ((buff->getAvailable()-tailSize_) % alignSize_) != 0)
+            buff->adjustTail((buff->getAvailable()-tailSize_) % alignSize_);
+
+         // Buffer should support our header/tail plus at least one payload byte,
+         // short trailing buffers are released back upstream
+         if ( buff->getAvailable() < (headSize_ + tailSize_ + 1) ) {
+            if ( bCount > 0 ) continue;
+
+            throw(rogue::GeneralError::create("packetizer::Controller::reqFrame",
+                     "Buffer size %i is less than min size required %i",
+                     buff->getAvailable(), (headSize_ + tailSize_ + 1)));
+         }
+
+         // Add header and tail reservation on top of those made upstream
+         buff->adjustHeader(headSize_);
+         buff->adjustTail(tailSize_);
+
+         // Add buffer to return frame
+         lFrame->appendBuffer(buff);
+         bCount++;
+      }
+      rFrame->clear();
    }
    return(lFrame);
 }
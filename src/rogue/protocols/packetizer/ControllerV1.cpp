@@ -159,12 +159,7 @@ void rpp::ControllerV1::applicationRx ( ris::FramePtr frame, uint8_t tDest ) {
    uint32_t size;
    uint8_t  fUser;
    uint8_t  lUser;
-   struct timeval startTime;
-   struct timeval currTime;
-   struct timeval endTime;
-
-   gettimeofday(&startTime,NULL);
-   timeradd(&startTime,&timeout_,&endTime);
+   uint64_t tout;
 
    if ( frame->isEmpty() )
       log_->warning("Empty frame received at application");
@@ -175,16 +170,10 @@ void rpp::ControllerV1::applicationRx ( ris::FramePtr frame, uint8_t tDest ) {
    ris::FrameLockPtr flock = frame->lock();
    std::lock_guard<std::mutex> lock(appMtx_);
 
-   // Wait while queue is busy
-   while ( tranQueue_.busy() ) {
-      usleep(10);
-      gettimeofday(&currTime,NULL);
-      if ( timercmp(&currTime,&endTime,>)) {
-         log_->critical("ControllerV1::applicationRx: Timeout waiting for outbound queue after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
-         gettimeofday(&startTime,NULL);
-         timeradd(&startTime,&timeout_,&endTime);
-      }
-   }
+   // Block while queue is busy, woken as the transport drains it
+   tout = (uint64_t)timeout_.tv_sec * 1000000 + timeout_.tv_usec;
+   while ( ! tranQueue_.waitIdle(tout) )
+      log_->critical("ControllerV1::applicationRx: Timeout waiting for outbound queue after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
 
    // User fields
    fUser = frame->getFirstUser();
@@ -23,6 +23,7 @@
 #include <rogue/protocols/packetizer/ControllerV2.h>
 #include <rogue/protocols/packetizer/Transport.h>
 #include <rogue/protocols/packetizer/Application.h>
+#include <rogue/utilities/Crc32.h>
 #include <rogue/GeneralError.h>
 #include <memory>
 #include <rogue/GilRelease.h>
@@ -33,13 +34,8 @@
 
 namespace rpp = rogue::protocols::packetizer;
 namespace ris = rogue::interfaces::stream;
+namespace ru  = rogue::utilities;
 
-// Local CRC library
-#define CRCPP_USE_CPP11
-#include <rogue/protocols/packetizer/CRC.h>
-
-// CRC Lookup table for later use
-static const CRC::Table<uint32_t, 32> crcTable_(CRC::CRC_32());
 
 //! Class creation
 rpp::ControllerV2Ptr rpp::ControllerV2::create ( bool enIbCrc, bool enObCrc, bool enSsi, rpp::TransportPtr tran, rpp::ApplicationPtr * app ) {
@@ -55,10 +51,97 @@ rpp::ControllerV2::ControllerV2 ( bool enIbCrc, bool enObCrc, bool enSsi, rpp::T
 }
 
 //! Destructor
-rpp::ControllerV2::~ControllerV2() { }
+rpp::ControllerV2::~ControllerV2() {
+   stopShards();
+}
+
+//! Set number of reassembly threads, 0 reassembles in the transport thread
+void rpp::ControllerV2::setRxShards(uint32_t shards) {
+   uint32_t x;
+
+   rogue::GilRelease noGil;
+
+   // Hold the transport lock so no frame is dispatched while shards change
+   std::lock_guard<std::mutex> lock(tranMtx_);
+
+   stopShards();
+
+   for (x=0; x < shards; x++) {
+      shardQueue_.push_back(std::make_shared<rogue::Queue<ris::FramePtr>>());
+      shardQueue_.back()->setMax(ShardQueueMax);
+   }
+
+   for (x=0; x < shards; x++) {
+      shardThreads_.push_back(new std::thread(&rpp::ControllerV2::runShard, this, x));
+#ifndef __MACH__
+      pthread_setname_np( shardThreads_.back()->native_handle(), "PackRxShard" );
+#endif
+   }
+}
+
+//! Get number of reassembly threads
+uint32_t rpp::ControllerV2::getRxShards() {
+   return(shardThreads_.size());
+}
+
+// Stop reassembly shard threads
+void rpp::ControllerV2::stopShards() {
+   uint32_t x;
+
+   for (x=0; x < shardQueue_.size(); x++) shardQueue_[x]->stop();
+
+   for (x=0; x < shardThreads_.size(); x++) {
+      shardThreads_[x]->join();
+      delete shardThreads_[x];
+   }
+
+   shardThreads_.clear();
+   shardQueue_.clear();
+}
+
+// Reassembly shard thread
+void rpp::ControllerV2::runShard(uint32_t idx) {
+   std::shared_ptr<rogue::Queue<ris::FramePtr>> queue;
+   ris::FramePtr frame;
+
+   log_->logThreadId();
+   queue = shardQueue_[idx];
+
+   // Pop returns an empty frame once the queue is stopped
+   while ( (frame = queue->pop()) != NULL ) rxProcess(frame);
+}
 
 //! Frame received at transport interface
 void rpp::ControllerV2::transportRx( ris::FramePtr frame ) {
+   ris::BufferPtr buff;
+   uint8_t tmpDest;
+
+   if ( frame->isEmpty() ) {
+      log_->warning("Bad incoming transportRx frame, size=0");
+      return;
+   }
+
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(tranMtx_);
+
+   // Reassemble in the calling thread
+   if ( shardQueue_.empty() ) {
+      rxProcess(frame);
+      return;
+   }
+
+   // Dispatch by destination, each destination is always handled by the same shard
+   {
+      ris::FrameLockPtr flock = frame->lock();
+      buff = *(frame->beginBuffer());
+      tmpDest = ( buff->getPayload() > 2 ) ? buff->begin()[2] : 0;
+   }
+
+   shardQueue_[tmpDest % shardQueue_.size()]->push(frame);
+}
+
+// Check and reassemble a transport frame
+void rpp::ControllerV2::rxProcess( ris::FramePtr frame ) {
    ris::BufferPtr buff;
    uint32_t  size;
    uint32_t  tmpCount;
@@ -75,14 +158,7 @@ void rpp::ControllerV2::transportRx( ris::FramePtr frame ) {
    uint32_t  tmpCrc;
    uint8_t * data;
 
-   if ( frame->isEmpty() ) {
-      log_->warning("Bad incoming transportRx frame, size=0");
-      return;
-   }
-
-   rogue::GilRelease noGil;
    ris::FrameLockPtr flock = frame->lock();
-   std::lock_guard<std::mutex> lock(tranMtx_);
 
    buff = *(frame->beginBuffer());
    data = buff->begin();
@@ -123,8 +199,8 @@ void rpp::ControllerV2::transportRx( ris::FramePtr frame ) {
       tmpCrc |= uint32_t(data[size-4]) << 24;
 
       // Compute CRC
-      if ( tmpSof ) crc_[tmpDest] = CRC::Calculate(data, size-4, crcTable_);
-      else crc_[tmpDest] = CRC::Calculate(data, size-4, crcTable_, crc_[tmpDest]);
+      if ( tmpSof ) crc_[tmpDest] = ru::Crc32::compute(data, size-4);
+      else crc_[tmpDest] = ru::Crc32::compute(data, size-4, crc_[tmpDest]);
 
       crcErr = (tmpCrc != crc_[tmpDest]);
    }
@@ -205,12 +281,7 @@ void rpp::ControllerV2::applicationRx ( ris::FramePtr frame, uint8_t tDest ) {
    uint8_t  lUser;
    uint32_t crc;
    uint32_t last;
-   struct timeval startTime;
-   struct timeval currTime;
-   struct timeval endTime;
-
-   gettimeofday(&startTime,NULL);
-   timeradd(&startTime,&timeout_,&endTime);
+   uint64_t tout;
 
    if ( frame->isEmpty() ) {
       log_->warning("Bad incoming applicationRx frame, size=0");
@@ -223,16 +294,10 @@ void rpp::ControllerV2::applicationRx ( ris::FramePtr frame, uint8_t tDest ) {
    ris::FrameLockPtr flock = frame->lock();
    std::lock_guard<std::mutex> lock(appMtx_);
 
-   // Wait while queue is busy
-   while ( tranQueue_.busy() ) {
-      usleep(10);
-      gettimeofday(&currTime,NULL);
-      if ( timercmp(&currTime,&endTime,>)) {
-         log_->critical("ControllerV2::applicationRx: Timeout waiting for outbound queue after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
-         gettimeofday(&startTime,NULL);
-         timeradd(&startTime,&timeout_,&endTime);
-      }
-   }
+   // Block while queue is busy, woken as the transport drains it
+   tout = (uint64_t)timeout_.tv_sec * 1000000 + timeout_.tv_usec;
+   while ( ! tranQueue_.waitIdle(tout) )
+      log_->critical("ControllerV2::applicationRx: Timeout waiting for outbound queue after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
 
    fUser = frame->getFirstUser();
    lUser = frame->getLastUser();
@@ -282,8 +347,8 @@ void rpp::ControllerV2::applicationRx ( ris::FramePtr frame, uint8_t tDest ) {
       if(enObCrc_){
 
          // Compute CRC
-         if ( segment == 0 ) crc = CRC::Calculate(data, size-4, crcTable_);
-         else crc = CRC::Calculate(data, size-4, crcTable_, crc);
+         if ( segment == 0 ) crc = ru::Crc32::compute(data, size-4);
+         else crc = ru::Crc32::compute(data, size-4, crc);
 
          // Tail  word 1
          data[size-1] = (crc >>  0) & 0xFF;
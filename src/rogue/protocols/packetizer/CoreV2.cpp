@@ -47,6 +47,8 @@ void rpp::CoreV2::setup_python() {
       .def("transport",      &rpp::CoreV2::transport)
       .def("application",    &rpp::CoreV2::application)
       .def("getDropCount",   &rpp::CoreV2::getDropCount)
+      .def("setRxShards",    &rpp::CoreV2::setRxShards)
+      .def("getRxShards",    &rpp::CoreV2::getRxShards)
 
    ;
 #endif
@@ -93,3 +95,13 @@ void rpp::CoreV2::setTimeout(uint32_t timeout) {
    cntl_->setTimeout(timeout);
 }
 
+//! Set number of reassembly threads
+void rpp::CoreV2::setRxShards(uint32_t shards) {
+   cntl_->setRxShards(shards);
+}
+
+//! Get number of reassembly threads
+uint32_t rpp::CoreV2::getRxShards() {
+   return(cntl_->getRxShards());
+}
+
@@ -51,6 +51,12 @@ void rpr::Client::setup_python() {
       .def("getDownCount",     &rpr::Client::getDownCount)
       .def("getDropCount",     &rpr::Client::getDropCount)
       .def("getRetranCount",   &rpr::Client::getRetranCount)
+      .def("getFastRetranCount", &rpr::Client::getFastRetranCount)
+      .def("getRtt",           &rpr::Client::getRtt)
+      .def("getRttVar",        &rpr::Client::getRttVar)
+      .def("getRttMin",        &rpr::Client::getRttMin)
+      .def("getRttMax",        &rpr::Client::getRttMax)
+      .def("getRto",           &rpr::Client::getRto)
       .def("getLocBusy",       &rpr::Client::getLocBusy)
       .def("getLocBusyCnt",    &rpr::Client::getLocBusyCnt)
       .def("getRemBusy",       &rpr::Client::getRemBusy)
@@ -72,6 +78,10 @@ void rpr::Client::setup_python() {
       .def("setLocMaxCumAck",  &rpr::Client::setLocMaxCumAck)
       .def("getLocMaxCumAck",  &rpr::Client::getLocMaxCumAck)
       .def("curMaxBuffers",    &rpr::Client::curMaxBuffers)
+      .def("curWindowExt",     &rpr::Client::curWindowExt)
+      .def("curSack",          &rpr::Client::curSack)
+      .def("setLocSack",       &rpr::Client::setLocSack)
+      .def("getLocSack",       &rpr::Client::getLocSack)
       .def("curMaxSegment",    &rpr::Client::curMaxSegment)
       .def("curCumAckTout",    &rpr::Client::curCumAckTout)
       .def("curRetranTout",    &rpr::Client::curRetranTout)
@@ -130,6 +140,36 @@ uint32_t rpr::Client::getRetranCount() {
    return(cntl_->getRetranCount());
 }
 
+//! Get count of retransmissions triggered by selective acknowledgement
+uint32_t rpr::Client::getFastRetranCount() {
+   return(cntl_->getFastRetranCount());
+}
+
+//! Get smoothed round trip time in microseconds
+uint32_t rpr::Client::getRtt() {
+   return(cntl_->getRtt());
+}
+
+//! Get round trip time variation in microseconds
+uint32_t rpr::Client::getRttVar() {
+   return(cntl_->getRttVar());
+}
+
+//! Get minimum round trip time in microseconds
+uint32_t rpr::Client::getRttMin() {
+   return(cntl_->getRttMin());
+}
+
+//! Get maximum round trip time in microseconds
+uint32_t rpr::Client::getRttMax() {
+   return(cntl_->getRttMax());
+}
+
+//! Get current retransmission timeout in microseconds
+uint32_t rpr::Client::getRto() {
+   return(cntl_->getRto());
+}
+
 //! Get locBusy
 bool rpr::Client::getLocBusy() {
    return(cntl_->getLocBusy());
@@ -158,11 +198,11 @@ uint32_t rpr::Client::getLocTryPeriod() {
    return cntl_->getLocTryPeriod();
 }
 
-void rpr::Client::setLocMaxBuffers(uint8_t val) {
+void rpr::Client::setLocMaxBuffers(uint16_t val) {
    cntl_->setLocMaxBuffers(val);
 }
 
-uint8_t rpr::Client::getLocMaxBuffers() {
+uint16_t rpr::Client::getLocMaxBuffers() {
    return cntl_->getLocMaxBuffers();
 }
 
@@ -214,10 +254,26 @@ uint8_t  rpr::Client::getLocMaxCumAck() {
    return cntl_->getLocMaxCumAck();
 }
 
-uint8_t  rpr::Client::curMaxBuffers() {
+uint16_t rpr::Client::curMaxBuffers() {
    return cntl_->curMaxBuffers();
 }
 
+bool rpr::Client::curWindowExt() {
+   return cntl_->curWindowExt();
+}
+
+bool rpr::Client::curSack() {
+   return cntl_->curSack();
+}
+
+void rpr::Client::setLocSack(bool val) {
+   cntl_->setLocSack(val);
+}
+
+bool rpr::Client::getLocSack() {
+   return cntl_->getLocSack();
+}
+
 uint16_t rpr::Client::curMaxSegment() {
    return cntl_->curMaxSegment();
 }
@@ -70,6 +70,7 @@ rpr::Controller::Controller ( uint32_t segSize, rpr::TransportPtr tran, rpr::App
    ackSeqRx_    = 0;
 
    state_       = StClosed;
+   stEvent_     = false;
    gettimeofday(&stTime_,NULL);
    downCount_   = 0;
    retranCount_ = 0;
@@ -77,6 +78,13 @@ rpr::Controller::Controller ( uint32_t segSize, rpr::TransportPtr tran, rpr::App
    txListCount_ = 0;
    lastAckTx_   = 0;
    locSequence_ = 100;
+   windowExt_   = false;
+   seqMask_     = 0xFF;
+   locSack_     = true;
+   sack_        = false;
+   eackCount_   = 0;
+   fastRetranCount_ = 0;
+   txList_.resize(256);
    gettimeofday(&txTime_,NULL);
 
    locMaxBuffers_ = 32;   // MAX_NUM_OUTS_SEG_G in FW
@@ -106,12 +114,15 @@ rpr::Controller::Controller ( uint32_t segSize, rpr::TransportPtr tran, rpr::App
    convTime(cumAckToutD2_, curCumAckTout_ / 2);
 
    memset(&zeroTme_, 0, sizeof(struct timeval));
+   memset(&openWait_, 0, sizeof(struct timeval));
 
    rogue::defaultTimeout(timeout_);
 
    locBusyCnt_ = 0;
    remBusyCnt_ = 0;
 
+   rttReset();
+
    log_ = rogue::Logging::create("rssi.controller");
 
    thread_ = NULL;
@@ -132,6 +143,8 @@ void rpr::Controller::stop() {
    if ( thread_ != NULL ) {
       rogue::GilRelease noGil;
       threadEn_ = false;
+      stNotify();
+      txCond_.notify_all();
       thread_->join();
       thread_ = NULL;
       state_ = StClosed;
@@ -188,7 +201,10 @@ ris::FramePtr rpr::Controller::reqFrame ( uint32_t size ) {
 
 //! Frame received at transport interface
 void rpr::Controller::transportRx( ris::FramePtr frame ) {
-   std::map<uint8_t, rpr::HeaderPtr>::iterator it;
+   std::map<uint16_t, rpr::HeaderPtr>::iterator it;
+   struct timeval now;
+   struct timeval diff;
+   uint16_t dist;
 
    rpr::HeaderPtr head = rpr::Header::create(frame);
 
@@ -201,22 +217,50 @@ void rpr::Controller::transportRx( ris::FramePtr frame ) {
       return;
    }
 
+   // Upper sequence bits are only valid with the window extension
+   if ( ! head->syn ) {
+      head->sequence    &= seqMask_;
+      head->acknowledge &= seqMask_;
+   }
+
    log_->debug("RX frame: state=%i server=%i size=%i syn=%i ack=%i nul=%i, bst=%i, rst=%i, ack#=%i seq=%i, nxt=%i",
          state_, server_,frame->getPayload(),head->syn,head->ack,head->nul,head->busy,head->rst,
          head->acknowledge,head->sequence,nextSeqRx_);
 
-   // Ack set
+   // Ack set, ignore stale acks which are behind the last ack received
    if ( head->ack && (head->acknowledge != lastAckRx_) ) {
       std::unique_lock<std::mutex> lock(txMtx_);
 
-      do {
-         txList_[++lastAckRx_].reset();
+      dist = (head->acknowledge - lastAckRx_) & seqMask_;
+      if ( dist > ((locSequence_ - lastAckRx_) & seqMask_) ) {
+         log_->info("Ignoring out of window ack. server=%i, ack=%i, lastAckRx_=%i",server_,head->acknowledge,lastAckRx_);
+         dist = 0;
+      }
+
+      // Cumulative ack advanced, restart duplicate detection
+      if ( dist != 0 ) eackCount_ = 0;
+
+      // Sample round trip time from the newest acknowledged frame,
+      // frames which have been retransmitted are ambiguous and skipped
+      if ( dist != 0 && txList_[head->acknowledge] != NULL && txList_[head->acknowledge]->count() == 1 ) {
+         gettimeofday(&now,NULL);
+         timersub(&now,&(txList_[head->acknowledge]->getTime()),&diff);
+         rttSample(timeUs(diff));
+      }
+
+      while ( dist-- != 0 ) {
+         lastAckRx_ = (lastAckRx_ + 1) & seqMask_;
+         txList_[lastAckRx_].reset();
          if ( txListCount_ != 0 ) txListCount_--;
-      } while (lastAckRx_ != head->acknowledge);
+      }
+
+      // Wake transmitters waiting for window space
+      txCond_.notify_all();
    }
 
-   // Check for busy state transition
+   // Check for busy state transition, retransmissions resume when busy clears
    if (!remBusy_ && head->busy) remBusyCnt_++;
+   else if (remBusy_ && !head->busy) stNotify();
 
    // Update busy bit
    remBusy_ = head->busy;
@@ -225,6 +269,7 @@ void rpr::Controller::transportRx( ris::FramePtr frame ) {
    if ( head->rst ) {
       if ( state_ == StOpen || state_ == StWaitSyn ) {
          stQueue_.push(head);
+         stNotify();
       }
    }
 
@@ -233,11 +278,17 @@ void rpr::Controller::transportRx( ris::FramePtr frame ) {
    else if ( head->syn ) {
       if ( state_ == StOpen || state_ == StWaitSyn ) {
          lastSeqRx_ = head->sequence;
-         nextSeqRx_ = lastSeqRx_ + 1;
+         nextSeqRx_ = (lastSeqRx_ + 1) & seqMask_;
          stQueue_.push(head);
+         stNotify();
       }
    }
 
+   // Out of order list from the remote
+   else if ( head->eack ) {
+      if ( state_ == StOpen && sack_ ) recvEack(head);
+   }
+
    // Data or NULL in the correct sequence go to application
    else if ( state_ == StOpen && ( head->nul || frame->getPayload() > rpr::Header::HeaderSize ) ) {
 
@@ -245,7 +296,7 @@ void rpr::Controller::transportRx( ris::FramePtr frame ) {
          // log_->warning("Data or NULL in the correct sequence go to application: nextSeqRx_=0x%x", nextSeqRx_);
 
          lastSeqRx_ = nextSeqRx_;
-         nextSeqRx_ = nextSeqRx_ + 1;
+         nextSeqRx_ = (nextSeqRx_ + 1) & seqMask_;
          appQueue_.push(head);
 
          // There are elements in ooo (out-of-order) queue
@@ -264,7 +315,7 @@ void rpr::Controller::transportRx( ris::FramePtr frame ) {
             // otherwise this could be stale data from previous ids
             while ( ( it = oooQueue_.find(nextSeqRx_)) != oooQueue_.end() ) {
                lastSeqRx_ = nextSeqRx_;
-               nextSeqRx_ = nextSeqRx_ + 1;
+               nextSeqRx_ = (nextSeqRx_ + 1) & seqMask_;
 
                appQueue_.push(it->second);
                log_->info("Using frame from ooo queue. server=%i, head->sequence=%i", server_, (it->second)->sequence);
@@ -273,7 +324,7 @@ void rpr::Controller::transportRx( ris::FramePtr frame ) {
          }
 
          // Notify after the last sequence update
-         stCond_.notify_all();
+         stNotify();
       }
 
       // Check if received frame is already in out of order queue
@@ -284,24 +335,21 @@ void rpr::Controller::transportRx( ris::FramePtr frame ) {
       }
 
       // Add to out of order queue in case things arrive out of order
-      // Make sure received sequence is in window. There may be a better way
-      // to do this while handling the 8 bit rollover
+      // Make sure received sequence is in window, distance is taken modulo the sequence space
       else {
-         uint8_t x = nextSeqRx_;
-         uint8_t windowEnd = (nextSeqRx_ + curMaxBuffers_ + 1);
-
-         while ( ++x != windowEnd ) {
-            if (head->sequence == x) {
-               oooQueue_.insert(std::make_pair(head->sequence,head));
-               log_->info("Adding frame to ooo queue. server=%i, head->sequence=%i, nextSeqRx_=%i, windowsEnd=%i",
-                     server_, head->sequence, nextSeqRx_, windowEnd);
-               break;
-            }
-         }
+         dist = (head->sequence - nextSeqRx_) & seqMask_;
 
-         if ( x == windowEnd ) {
-            log_->warning("Dropping out of window frame. server=%i, head->sequence=%i, nextSeqRx_=%i, windowsEnd=%i",
-                  server_, head->sequence, nextSeqRx_, windowEnd);
+         if ( dist <= curMaxBuffers_ ) {
+            oooQueue_.insert(std::make_pair(head->sequence,head));
+            log_->info("Adding frame to ooo queue. server=%i, head->sequence=%i, nextSeqRx_=%i, window=%i",
+                  server_, head->sequence, nextSeqRx_, curMaxBuffers_);
+
+            // Report held frames so the remote only resends the holes
+            if ( sack_ ) sendEack();
+         }
+         else {
+            log_->warning("Dropping out of window frame. server=%i, head->sequence=%i, nextSeqRx_=%i, window=%i",
+                  server_, head->sequence, nextSeqRx_, curMaxBuffers_);
             dropCount_++;
          }
       }
@@ -318,7 +366,7 @@ ris::FramePtr rpr::Controller::applicationTx() {
 
    do {
       if ((head = appQueue_.pop()) == NULL) return(frame);
-      stCond_.notify_all();
+      stNotify();
 
       frame = head->getFrame();
       ris::FrameLockPtr flock = frame->lock();
@@ -340,9 +388,6 @@ ris::FramePtr rpr::Controller::applicationTx() {
 //! Frame received at application interface
 void rpr::Controller::applicationRx ( ris::FramePtr frame ) {
    ris::FramePtr tranFrame;
-   struct timeval startTime;
-
-   gettimeofday(&startTime,NULL);
 
    rogue::GilRelease noGil;
    ris::FrameLockPtr flock = frame->lock();
@@ -368,18 +413,23 @@ void rpr::Controller::applicationRx ( ris::FramePtr frame ) {
    // Connection is closed
    if ( state_ != StOpen ) return;
 
-   // Wait while busy either by flow control or buffer starvation
-   while ( txListCount_ >= curMaxBuffers_ ) {
-      usleep(10);
-      if ( timePassed(startTime,timeout_) ) {
-         gettimeofday(&startTime,NULL);
-         log_->critical("Controller::applicationRx: Timeout waiting for outbound queue after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
+   // Wait while busy either by flow control or buffer starvation, woken as acks free space
+   {
+      std::unique_lock<std::mutex> lock(txMtx_);
+
+      while ( threadEn_ && state_ == StOpen && txListCount_ >= curMaxBuffers_ ) {
+         if ( txCond_.wait_for(lock, std::chrono::microseconds(timeout_.tv_usec) +
+                                     std::chrono::seconds(timeout_.tv_sec)) == std::cv_status::timeout )
+            log_->critical("Controller::applicationRx: Timeout waiting for outbound queue after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
       }
    }
 
+   // Connection was lost while waiting
+   if ( state_ != StOpen ) return;
+
    // Transmit
    transportTx(head,true,false);
-   stCond_.notify_all();
+   stNotify();
 }
 
 //! Get state
@@ -402,6 +452,36 @@ uint32_t rpr::Controller::getRetranCount() {
    return(retranCount_);
 }
 
+//! Get count of retransmissions triggered by selective acknowledgement
+uint32_t rpr::Controller::getFastRetranCount() {
+   return(fastRetranCount_);
+}
+
+//! Get smoothed round trip time in microseconds
+uint32_t rpr::Controller::getRtt() {
+   return(srtt_);
+}
+
+//! Get round trip time variation in microseconds
+uint32_t rpr::Controller::getRttVar() {
+   return(rttVar_);
+}
+
+//! Get minimum round trip time in microseconds
+uint32_t rpr::Controller::getRttMin() {
+   return(rttMin_);
+}
+
+//! Get maximum round trip time in microseconds
+uint32_t rpr::Controller::getRttMax() {
+   return(rttMax_);
+}
+
+//! Get current retransmission timeout in microseconds
+uint32_t rpr::Controller::getRto() {
+   return(rto_);
+}
+
 //! Get locBusy
 bool rpr::Controller::getLocBusy() {
    bool queueBusy = appQueue_.busy();
@@ -438,15 +518,15 @@ uint32_t rpr::Controller::getLocTryPeriod() {
    return locTryPeriod_;
 }
 
-void rpr::Controller::setLocMaxBuffers(uint8_t val) {
-   if ( val == 0 )
+void rpr::Controller::setLocMaxBuffers(uint16_t val) {
+   if ( val == 0 || val > ExtMaxBuffers )
       throw rogue::GeneralError::create("Rssi::Controller::setLocMaxBuffers",
                                             "Invalid LocMaxBuffers Value = %i",val);
 
    locMaxBuffers_ = val;
 }
 
-uint8_t rpr::Controller::getLocMaxBuffers() {
+uint16_t rpr::Controller::getLocMaxBuffers() {
    return locMaxBuffers_;
 }
 
@@ -516,10 +596,26 @@ uint8_t  rpr::Controller::getLocMaxCumAck() {
    return locMaxCumAck_;
 }
 
-uint8_t  rpr::Controller::curMaxBuffers() {
+void rpr::Controller::setLocSack(bool val) {
+   locSack_ = val;
+}
+
+bool rpr::Controller::getLocSack() {
+   return locSack_;
+}
+
+uint16_t rpr::Controller::curMaxBuffers() {
    return curMaxBuffers_;
 }
 
+bool rpr::Controller::curWindowExt() {
+   return windowExt_;
+}
+
+bool rpr::Controller::curSack() {
+   return sack_;
+}
+
 uint16_t rpr::Controller::curMaxSegment() {
    return curMaxSegment_;
 }
@@ -554,13 +650,15 @@ void rpr::Controller::transportTx(rpr::HeaderPtr head, bool seqUpdate, bool txRe
    if ( seqUpdate ) {
       txList_[locSequence_] = head;
       txListCount_++;
-      locSequence_++;
+      locSequence_ = (locSequence_ + 1) & seqMask_;
    }
 
    // Reset tx list
    if ( txReset ) {
-      for (uint32_t x=0; x < 256; x++) txList_[x].reset();
+      for (uint32_t x=0; x < txList_.size(); x++) txList_[x].reset();
       txListCount_ = 0;
+      txHeap_ = std::priority_queue<TxDeadline, std::vector<TxDeadline>, std::greater<TxDeadline>>();
+      txCond_.notify_all();
    }
 
    if ( getLocBusy() ) {
@@ -579,6 +677,9 @@ void rpr::Controller::transportTx(rpr::HeaderPtr head, bool seqUpdate, bool txRe
    ris::FrameLockPtr flock = head->getFrame()->lock();
    head->update();
 
+   // Sequenced frames on an open link are retransmitted if not acked
+   if ( seqUpdate && (!txReset) && state_ == StOpen ) txDeadline(head);
+
    log_->log(rogue::Logging::Debug,
          "TX frame: state=%i server=%i size=%i syn=%i ack=%i nul=%i, bsy=%i, rst=%i, ack#=%i, seq=%i, recount=%i, ptr=%p",
          state_,server_,head->getFrame()->getPayload(),head->syn,head->ack,head->nul,head->busy,head->rst,
@@ -591,19 +692,48 @@ void rpr::Controller::transportTx(rpr::HeaderPtr head, bool seqUpdate, bool txRe
    tran_->sendFrame(head->getFrame());
 }
 
-// Method to retransmit a frame
-int8_t rpr::Controller::retransmit(uint8_t id) {
+// Retransmit frames with expired deadlines, next is lowered to the earliest pending deadline
+int8_t rpr::Controller::retransmit(struct timeval &next) {
+   std::vector<rpr::HeaderPtr> resend;
+   std::vector<rpr::HeaderPtr>::iterator it;
+   struct timeval now;
+   rpr::HeaderPtr head;
+   uint32_t count;
+
    std::unique_lock<std::mutex> lock(txMtx_);
 
-   rpr::HeaderPtr head = txList_[id];
-   if ( head == NULL ) return 0;
+   gettimeofday(&now,NULL);
+
+   while ( ! txHeap_.empty() ) {
+
+      // Earliest deadline is in the future
+      if ( timercmp(&(txHeap_.top().time),&now,>) ) {
+         if ( timercmp(&(txHeap_.top().time),&next,<) ) next = txHeap_.top().time;
+         break;
+      }
 
-   // retransmit timer has not expired
-   if ( ! timePassed(head->getTime(),retranToutD1_) ) return 0;
+      head  = txHeap_.top().head.lock();
+      count = txHeap_.top().count;
+      txHeap_.pop();
 
-   // max retransmission count has been reached
-   if ( head->count() >= curMaxRetran_ ) return -1;
+      // Frame has been acked, held by the remote or transmitted again since this deadline was set
+      if ( head == NULL || txList_[head->sequence] != head || head->count() != count || head->getSacked() ) continue;
+
+      // max retransmission count has been reached
+      if ( head->count() >= curMaxRetran_ ) return -1;
+
+      txResend(head);
+      resend.push_back(head);
+   }
+   lock.unlock();
 
+   // Send frames
+   for (it=resend.begin(); it != resend.end(); ++it) tran_->sendFrame((*it)->getFrame());
+   return((resend.empty()) ? 0 : 1);
+}
+
+// Prepare a frame for retransmission, called with txMtx_ held
+void rpr::Controller::txResend(rpr::HeaderPtr head) {
    retranCount_++;
 
    if ( getLocBusy() ) {
@@ -627,11 +757,201 @@ int8_t rpr::Controller::retransmit(uint8_t id) {
    ris::FrameLockPtr flock = head->getFrame()->lock();
    head->update();
    flock->unlock();
+
+   txDeadline(head);
+}
+
+// Send out of order sequence list to the remote
+void rpr::Controller::sendEack() {
+   std::map<uint16_t, rpr::HeaderPtr>::iterator it;
+   ris::FramePtr  frame;
+   ris::BufferPtr buff;
+   uint32_t count;
+   uint32_t max;
+   uint8_t * data;
+
+   // List is limited to one segment
+   max   = (curMaxSegment_ - rpr::Header::HeaderSize) / 2;
+   count = (oooQueue_.size() < max) ? oooQueue_.size() : max;
+   if ( count == 0 ) return;
+
+   frame = tran_->reqFrame(rpr::Header::HeaderSize + count * 2,false);
+   buff  = *(frame->beginBuffer());
+
+   if ( buff->getSize() < (rpr::Header::HeaderSize + count * 2) ) return;
+
+   data = buff->begin() + rpr::Header::HeaderSize;
+   for (it=oooQueue_.begin(); it != oooQueue_.end() && count > 0; ++it, --count) {
+      *(data++) = it->first >> 8;
+      *(data++) = it->first & 0xFF;
+   }
+   buff->setPayload(data - buff->begin());
+
+   rpr::HeaderPtr head = rpr::Header::create(frame);
+   head->ack  = true;
+   head->eack = true;
+   transportTx(head,false,false);
+}
+
+// Process an out of order sequence list from the remote
+void rpr::Controller::recvEack(rpr::HeaderPtr head) {
+   std::vector<rpr::HeaderPtr> resend;
+   std::vector<rpr::HeaderPtr>::iterator it;
+   rpr::HeaderPtr entry;
+   ris::BufferPtr buff;
+   struct timeval now;
+   struct timeval diff;
+   uint16_t outstanding;
+   uint16_t highest;
+   uint16_t dist;
+   uint16_t seq;
+   uint32_t count;
+   uint32_t min;
+   uint32_t x;
+   uint8_t * data;
+
+   buff  = *(head->getFrame()->beginBuffer());
+   data  = buff->begin() + rpr::Header::HeaderSize;
+   count = (buff->getPayload() - rpr::Header::HeaderSize) / 2;
+
+   std::unique_lock<std::mutex> lock(txMtx_);
+
+   // Mark held frames, tracking the furthest one
+   outstanding = (locSequence_ - lastAckRx_) & seqMask_;
+   highest = 0;
+
+   for (x=0; x < count; x++) {
+      seq  = ((data[x*2] << 8) | data[x*2+1]) & seqMask_;
+      dist = (seq - lastAckRx_) & seqMask_;
+
+      if ( dist == 0 || dist >= outstanding || txList_[seq] == NULL ) continue;
+
+      txList_[seq]->setSacked(true);
+      if ( dist > highest ) highest = dist;
+   }
+
+   // Wait for duplicate reports before treating a gap as loss, tolerating reordering
+   if ( ++eackCount_ < DupAckThold || remBusy_ ) return;
+
+   // Resend holes below the furthest held frame which have not been sent within a round trip
+   gettimeofday(&now,NULL);
+   min = (srtt_ > 1000) ? srtt_ : 1000;
+
+   for (dist=1; dist < highest; dist++) {
+      entry = txList_[(lastAckRx_ + dist) & seqMask_];
+      if ( entry == NULL || entry->getSacked() ) continue;
+
+      timersub(&now,&(entry->getTime()),&diff);
+      if ( timeUs(diff) < min || entry->count() >= curMaxRetran_ ) continue;
+
+      fastRetranCount_++;
+      txResend(entry);
+      resend.push_back(entry);
+   }
    lock.unlock();
 
-   // Send frame
-   tran_->sendFrame(head->getFrame());
-   return 1;
+   // Send frames
+   for (it=resend.begin(); it != resend.end(); ++it) tran_->sendFrame((*it)->getFrame());
+}
+
+// Add retransmit deadline for a transmitted frame, called with txMtx_ held
+void rpr::Controller::txDeadline(rpr::HeaderPtr head) {
+   TxDeadline dl;
+   struct timeval tout;
+   uint64_t max;
+   uint64_t usec;
+   uint32_t x;
+
+   // Estimated timeout doubles with each transmission of the frame,
+   // bounded by the negotiated retransmission timeout
+   max  = timeUs(retranToutD1_);
+   usec = rto_;
+   for (x=1; x < head->count() && usec < max; x++) usec *= 2;
+   if ( usec > max ) usec = max;
+
+   tout.tv_sec  = usec / 1000000;
+   tout.tv_usec = usec % 1000000;
+
+   timeradd(&(head->getTime()),&tout,&(dl.time));
+   dl.head  = head;
+   dl.count = head->count();
+   txHeap_.push(dl);
+}
+
+// Select the sequence space for a connection, syn frames use the standard space
+void rpr::Controller::setWindowExt(bool enable) {
+   std::unique_lock<std::mutex> lock(txMtx_);
+
+   windowExt_   = enable;
+   seqMask_     = (enable) ? 0xFFFF : 0xFF;
+   eackCount_   = 0;
+   locSequence_ = locSequence_ & 0xFF;
+
+   txList_.clear();
+   txList_.resize(seqMask_ + 1);
+   txListCount_ = 0;
+   txHeap_ = std::priority_queue<TxDeadline, std::vector<TxDeadline>, std::greater<TxDeadline>>();
+}
+
+// Wake the state thread
+void rpr::Controller::stNotify() {
+   {
+      std::lock_guard<std::mutex> lock(stMtx_);
+      stEvent_ = true;
+   }
+   stCond_.notify_all();
+}
+
+// Update round trip estimate with a new sample, called with txMtx_ held
+void rpr::Controller::rttSample(uint32_t rtt) {
+   uint32_t diff;
+   uint32_t min;
+   uint32_t max;
+   uint64_t rto;
+
+   // Jacobson/Karels estimator
+   if ( rttCount_ == 0 ) {
+      srtt_   = rtt;
+      rttVar_ = rtt / 2;
+      rttMin_ = rtt;
+      rttMax_ = rtt;
+   }
+   else {
+      diff    = (srtt_ > rtt) ? (srtt_ - rtt) : (rtt - srtt_);
+      rttVar_ = (3 * (uint64_t)rttVar_ + diff) / 4;
+      srtt_   = (7 * (uint64_t)srtt_ + rtt) / 8;
+      if ( rtt < rttMin_ ) rttMin_ = rtt;
+      if ( rtt > rttMax_ ) rttMax_ = rtt;
+   }
+   rttCount_++;
+
+   // Variation term is at least one timeout unit
+   rto = (uint64_t)srtt_ + ((4 * rttVar_ > 1000) ? (4 * rttVar_) : 1000);
+
+   // Never below twice the cumulative ack timeout, since the remote may hold
+   // an ack that long, and never above the negotiated retransmission timeout
+   max = timeUs(retranToutD1_);
+   min = 2 * timeUs(cumAckToutD1_);
+   if ( min > max ) min = max;
+
+   if ( rto < min ) rto = min;
+   if ( rto > max ) rto = max;
+   rto_ = rto;
+}
+
+// Reset round trip estimate to the negotiated retransmission timeout
+void rpr::Controller::rttReset() {
+   rttCount_ = 0;
+   srtt_     = 0;
+   rttVar_   = 0;
+   rttMin_   = 0;
+   rttMax_   = 0;
+   rto_      = timeUs(retranToutD1_);
+}
+
+//! Convert time structure to microseconds
+uint64_t rpr::Controller::timeUs ( struct timeval &tme ) {
+   return((uint64_t)tme.tv_sec * 1000000 + tme.tv_usec);
 }
 
 //! Convert rssi time to microseconds
@@ -667,12 +987,15 @@ void rpr::Controller::runThread() {
    while(threadEn_) {
 
       // Lock context
-      if ( wait.tv_sec != 0 || wait.tv_usec != 0 ) {
-         // Wait on condition or timeout
+      {
          std::unique_lock<std::mutex> lock(stMtx_);
 
-         // Adjustable wait
-         stCond_.wait_for(lock, std::chrono::microseconds(wait.tv_usec) + std::chrono::seconds(wait.tv_sec));
+         // Wait for an event or the next timer. Events posted while the
+         // state was being processed are kept in stEvent_ and are not lost.
+         if ( (wait.tv_sec != 0 || wait.tv_usec != 0) && (!stEvent_) && threadEn_ )
+            stCond_.wait_for(lock, std::chrono::microseconds(wait.tv_usec) + std::chrono::seconds(wait.tv_sec));
+
+         stEvent_ = false;
       }
 
       switch(state_) {
@@ -723,6 +1046,16 @@ struct timeval & rpr::Controller::stateClosedWait () {
       // Syn ack
       else if ( head->syn && (head->ack || server_) ) {
          curMaxBuffers_ = head->maxOutstandingSegments;
+
+         // Window extension is requested by a Rogue client and echoed by a Rogue server
+         if ( head->windowExt && head->maxOutstandingSegmentsExt > 0 ) {
+            curMaxBuffers_ = head->maxOutstandingSegmentsExt;
+            if ( curMaxBuffers_ > ExtMaxBuffers ) curMaxBuffers_ = ExtMaxBuffers;
+         }
+         setWindowExt(head->windowExt && head->maxOutstandingSegmentsExt > 0);
+         sack_ = head->sack && locSack_;
+         nextSeqRx_ = (lastSeqRx_ + 1) & seqMask_;
+
          curMaxSegment_ = head->maxSegmentSize;
          curCumAckTout_ = head->cumulativeAckTimeout;
          curRetranTout_ = head->retransmissionTimeout;
@@ -737,6 +1070,12 @@ struct timeval & rpr::Controller::stateClosedWait () {
          convTime(cumAckToutD2_, curCumAckTout_ / 2);
          convTime(nullToutD3_,   curNullTout_ / 3);
 
+         // Restart round trip estimation for the new connection
+         {
+            std::unique_lock<std::mutex> lock(txMtx_);
+            rttReset();
+         }
+
          if ( server_ ) {
             state_ = StSendSynAck;
             return(zeroTme_);
@@ -760,6 +1099,9 @@ struct timeval & rpr::Controller::stateClosedWait () {
    // Generate syn after try period passes
    else if ( (!server_) && timePassed(stTime_,tryPeriodD1_) ) {
 
+      // Syn is always sent in the standard sequence space
+      setWindowExt(false);
+
       // Allocate frame
       head = rpr::Header::create(tran_->reqFrame(rpr::Header::SynSize,false));
 
@@ -767,7 +1109,10 @@ struct timeval & rpr::Controller::stateClosedWait () {
       head->syn = true;
       head->version = Version;
       head->chk = true;
-      head->maxOutstandingSegments = locMaxBuffers_;
+      head->maxOutstandingSegments = (locMaxBuffers_ > StdMaxBuffers) ? StdMaxBuffers : locMaxBuffers_;
+      head->windowExt              = (locMaxBuffers_ > StdMaxBuffers);
+      head->maxOutstandingSegmentsExt = (head->windowExt) ? locMaxBuffers_ : 0;
+      head->sack                   = locSack_;
       head->maxSegmentSize         = locMaxSegment_;
       head->retransmissionTimeout  = locRetranTout_;
       head->cumulativeAckTimeout   = locCumAckTout_;
@@ -800,7 +1145,10 @@ struct timeval & rpr::Controller::stateSendSynAck () {
    head->ack = true;
    head->version = Version;
    head->chk = true;
-   head->maxOutstandingSegments = curMaxBuffers_;
+   head->maxOutstandingSegments = (curMaxBuffers_ > StdMaxBuffers) ? StdMaxBuffers : curMaxBuffers_;
+   head->windowExt              = windowExt_;
+   head->maxOutstandingSegmentsExt = (windowExt_) ? curMaxBuffers_ : 0;
+   head->sack                   = sack_;
    head->maxSegmentSize         = curMaxSegment_;
    head->retransmissionTimeout  = curRetranTout_;
    head->cumulativeAckTimeout   = curCumAckTout_;
@@ -812,6 +1160,12 @@ struct timeval & rpr::Controller::stateSendSynAck () {
 
    transportTx(head,true,true);
 
+   // Nothing is outstanding once the syn ack has been sent
+   {
+      std::unique_lock<std::mutex> lock(txMtx_);
+      lastAckRx_ = head->sequence;
+   }
+
    // Update state
    log_->warning("State is open. Server=%i",server_);
    state_ = StOpen;
@@ -841,10 +1195,12 @@ struct timeval & rpr::Controller::stateSendSeqAck () {
 //! Idle with open state
 struct timeval & rpr::Controller::stateOpen () {
    rpr::HeaderPtr head;
-   uint8_t idx;
    bool doNull;
-   uint8_t ackPend;
+   uint16_t ackPend;
    struct timeval locTime;
+   struct timeval next;
+   struct timeval tmp;
+   struct timeval now;
 
    // Pending frame may be reset
    while ( ! stQueue_.empty() ) {
@@ -862,7 +1218,7 @@ struct timeval & rpr::Controller::stateOpen () {
    {
       std::unique_lock<std::mutex> lock(txMtx_);
       locTime = txTime_;
-      ackPend = ackSeqRx_ - lastAckTx_;
+      ackPend = (ackSeqRx_ - lastAckTx_) & seqMask_;
    }
 
    // NULL required
@@ -877,19 +1233,42 @@ struct timeval & rpr::Controller::stateOpen () {
       head->ack = true;
       head->nul = doNull;
       transportTx(head,doNull,false);
+      ackPend = 0;
+   }
+
+   // Next timer event is the null timer, measured from the last transmission
+   {
+      std::unique_lock<std::mutex> lock(txMtx_);
+      locTime = txTime_;
+   }
+   timeradd(&locTime,&nullToutD3_,&next);
+
+   // Ack timer runs while an ack is owed to the remote
+   if ( ackPend > 0 || getLocBusy() ) {
+      timeradd(&locTime,&cumAckToutD1_,&tmp);
+      if ( timercmp(&tmp,&next,<) ) next = tmp;
    }
 
    // Retransmission processing, don't process when busy
-   idx = lastAckRx_;
-   while ( (! remBusy_) && (idx != locSequence_) ) {
-      if ( retransmit(idx++) < 0 ) {
-         state_ = StError;
-         gettimeofday(&stTime_,NULL);
-         return(zeroTme_);
-      }
+   if ( remBusy_ ) {
+      gettimeofday(&now,NULL);
+      timeradd(&now,&cumAckToutD2_,&tmp);
+      if ( timercmp(&tmp,&next,<) ) next = tmp;
+   }
+   else if ( retransmit(next) < 0 ) {
+      state_ = StError;
+      gettimeofday(&stTime_,NULL);
+      return(zeroTme_);
    }
 
-   return(cumAckToutD2_);
+   // Wait until the earliest timer, at least one microsecond
+   gettimeofday(&now,NULL);
+   if ( timercmp(&next,&now,>) ) timersub(&next,&now,&openWait_);
+   else {
+      openWait_.tv_sec  = 0;
+      openWait_.tv_usec = 1;
+   }
+   return(openWait_);
 }
 
 //! Error
@@ -75,14 +75,19 @@ rpr::HeaderPtr rpr::Header::create(ris::FramePtr frame) {
 
 //! Creator
 rpr::Header::Header(ris::FramePtr frame) {
-   frame_ = frame;
-   count_ = 0;
+   frame_  = frame;
+   count_  = 0;
+   sacked_ = false;
 
    syn = false;
    ack = false;
    rst = false;
    nul = false;
    busy = false;
+   eack = false;
+   sack = false;
+   windowExt = false;
+   maxOutstandingSegmentsExt = 0;
    //sequence = 0;
    //acknowledge = 0;
    //version = 0;
@@ -120,6 +125,7 @@ bool rpr::Header::verify() {
    syn  = data[0] & 0x80;
    ack  = data[0] & 0x40;
    rst  = data[0] & 0x10;
+   eack = data[0] & 0x20;
    nul  = data[0] & 0x08;
    busy = data[0] & 0x01;
 
@@ -130,7 +136,12 @@ bool rpr::Header::verify() {
    sequence    = data[2];
    acknowledge = data[3];
 
-   if ( ! syn ) return true;
+   // Reserved bytes carry the upper sequence bits when the window extension is in use
+   if ( ! syn ) {
+      sequence    |= ((uint16_t)data[4] << 8);
+      acknowledge |= ((uint16_t)data[5] << 8);
+      return true;
+   }
 
    version = data[4] >> 4;
    chk  = data[4] & 0x04;
@@ -144,6 +155,9 @@ bool rpr::Header::verify() {
    maxCumulativeAck = data[15];
    timeoutUnit = data[17];
    connectionId = data[18];
+   windowExt = data[16] & 0x01;
+   sack = data[16] & 0x02;
+   maxOutstandingSegmentsExt = getUInt16(data,20);
 
    return(true);
 }
@@ -171,12 +185,13 @@ void rpr::Header::update() {
    data[1] = size;
 
    if ( ack  ) data[0] |= 0x40;
+   if ( eack ) data[0] |= 0x20;
    if ( rst  ) data[0] |= 0x10;
    if ( nul  ) data[0] |= 0x08;
    if ( busy ) data[0] |= 0x01;
 
-   data[2] = sequence;
-   data[3] = acknowledge;
+   data[2] = sequence & 0xFF;
+   data[3] = acknowledge & 0xFF;
 
    if ( syn ) {
       data[0] |= 0x80;
@@ -195,6 +210,16 @@ void rpr::Header::update() {
       data[15] = maxCumulativeAck;
       data[17] = timeoutUnit;
       data[18] = connectionId;
+
+      if ( windowExt ) {
+         data[16] |= 0x01;
+         setUInt16(data,20,maxOutstandingSegmentsExt);
+      }
+      if ( sack ) data[16] |= 0x02;
+   }
+   else {
+      data[4] = sequence >> 8;
+      data[5] = acknowledge >> 8;
    }
 
    setUInt16(data,size-2,compSum(data,size));
@@ -217,6 +242,16 @@ void rpr::Header::rstTime() {
    gettimeofday(&time_,NULL);
 }
 
+//! Set selectively acknowledged state
+void rpr::Header::setSacked(bool sacked) {
+   sacked_ = sacked;
+}
+
+//! Get selectively acknowledged state
+bool rpr::Header::getSacked() {
+   return(sacked_);
+}
+
 //! Dump message
 std::string rpr::Header::dump() {
    uint32_t   x;
@@ -238,6 +273,7 @@ std::string rpr::Header::dump() {
 
    ret << "          Syn : " << std::dec << syn << std::endl;
    ret << "          Ack : " << std::dec << ack << std::endl;
+   ret << "         Eack : " << std::dec << eack << std::endl;
    ret << "          Rst : " << std::dec << rst << std::endl;
    ret << "          Nul : " << std::dec << nul << std::endl;
    ret << "         Busy : " << std::dec << busy << std::endl;
@@ -257,6 +293,9 @@ std::string rpr::Header::dump() {
    ret << "  Max Cum Ack : " << std::dec << (uint32_t)maxCumulativeAck << std::endl;
    ret << " Timeout Unit : " << std::dec << (uint32_t)timeoutUnit << std::endl;
    ret << "      Conn Id : " << std::dec << (uint32_t)connectionId << std::endl;
+   ret << "   Window Ext : " << std::dec << windowExt << std::endl;
+   ret << "  Max Out Ext : " << std::dec << (uint32_t)maxOutstandingSegmentsExt << std::endl;
+   ret << "         Sack : " << std::dec << sack << std::endl;
 
    return(ret.str());
 }
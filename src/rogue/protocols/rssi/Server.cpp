@@ -47,6 +47,12 @@ void rpr::Server::setup_python() {
       .def("getDownCount",     &rpr::Server::getDownCount)
       .def("getDropCount",     &rpr::Server::getDropCount)
       .def("getRetranCount",   &rpr::Server::getRetranCount)
+      .def("getFastRetranCount", &rpr::Server::getFastRetranCount)
+      .def("getRtt",           &rpr::Server::getRtt)
+      .def("getRttVar",        &rpr::Server::getRttVar)
+      .def("getRttMin",        &rpr::Server::getRttMin)
+      .def("getRttMax",        &rpr::Server::getRttMax)
+      .def("getRto",           &rpr::Server::getRto)
       .def("getLocBusy",       &rpr::Server::getLocBusy)
       .def("getLocBusyCnt",    &rpr::Server::getLocBusyCnt)
       .def("getRemBusy",       &rpr::Server::getRemBusy)
@@ -68,6 +74,10 @@ void rpr::Server::setup_python() {
       .def("setLocMaxCumAck",  &rpr::Server::setLocMaxCumAck)
       .def("getLocMaxCumAck",  &rpr::Server::getLocMaxCumAck)
       .def("curMaxBuffers",    &rpr::Server::curMaxBuffers)
+      .def("curWindowExt",     &rpr::Server::curWindowExt)
+      .def("curSack",          &rpr::Server::curSack)
+      .def("setLocSack",       &rpr::Server::setLocSack)
+      .def("getLocSack",       &rpr::Server::getLocSack)
       .def("curMaxSegment",    &rpr::Server::curMaxSegment)
       .def("curCumAckTout",    &rpr::Server::curCumAckTout)
       .def("curRetranTout",    &rpr::Server::curRetranTout)
@@ -126,6 +136,36 @@ uint32_t rpr::Server::getRetranCount() {
    return(cntl_->getRetranCount());
 }
 
+//! Get count of retransmissions triggered by selective acknowledgement
+uint32_t rpr::Server::getFastRetranCount() {
+   return(cntl_->getFastRetranCount());
+}
+
+//! Get smoothed round trip time in microseconds
+uint32_t rpr::Server::getRtt() {
+   return(cntl_->getRtt());
+}
+
+//! Get round trip time variation in microseconds
+uint32_t rpr::Server::getRttVar() {
+   return(cntl_->getRttVar());
+}
+
+//! Get minimum round trip time in microseconds
+uint32_t rpr::Server::getRttMin() {
+   return(cntl_->getRttMin());
+}
+
+//! Get maximum round trip time in microseconds
+uint32_t rpr::Server::getRttMax() {
+   return(cntl_->getRttMax());
+}
+
+//! Get current retransmission timeout in microseconds
+uint32_t rpr::Server::getRto() {
+   return(cntl_->getRto());
+}
+
 //! Get locBusy
 bool rpr::Server::getLocBusy() {
    return(cntl_->getLocBusy());
@@ -154,11 +194,11 @@ uint32_t rpr::Server::getLocTryPeriod() {
    return cntl_->getLocTryPeriod();
 }
 
-void rpr::Server::setLocMaxBuffers(uint8_t val) {
+void rpr::Server::setLocMaxBuffers(uint16_t val) {
    cntl_->setLocMaxBuffers(val);
 }
 
-uint8_t rpr::Server::getLocMaxBuffers() {
+uint16_t rpr::Server::getLocMaxBuffers() {
    return cntl_->getLocMaxBuffers();
 }
 
@@ -210,10 +250,26 @@ uint8_t  rpr::Server::getLocMaxCumAck() {
    return cntl_->getLocMaxCumAck();
 }
 
-uint8_t  rpr::Server::curMaxBuffers() {
+uint16_t rpr::Server::curMaxBuffers() {
    return cntl_->curMaxBuffers();
 }
 
+bool rpr::Server::curWindowExt() {
+   return cntl_->curWindowExt();
+}
+
+bool rpr::Server::curSack() {
+   return cntl_->curSack();
+}
+
+void rpr::Server::setLocSack(bool val) {
+   cntl_->setLocSack(val);
+}
+
+bool rpr::Server::getLocSack() {
+   return cntl_->getLocSack();
+}
+
 uint16_t rpr::Server::curMaxSegment() {
    return cntl_->curMaxSegment();
 }
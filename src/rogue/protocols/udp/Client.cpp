@@ -63,6 +63,8 @@ rpu::Client::Client ( std::string host, uint16_t port, bool jumbo) : rpu::Core(j
    if ( (fd_ = socket(AF_INET,SOCK_DGRAM,0)) < 0 )
       throw(rogue::GeneralError::create("Client::Client","Failed to create socket for port %i at address %s",port_,address_.c_str()));
 
+   rx_.fd = fd_;
+
    // Lookup host address
    bzero(&aiHints, sizeof(aiHints));
    aiHints.ai_flags    = AI_CANONNAME;
@@ -103,7 +105,12 @@ rpu::Client::~Client() {
 void rpu::Client::stop() {
   if (threadEn_)  {
       threadEn_ = false;
-      thread_->join();
+
+      if ( reactor_ ) reactor_->remove(this);
+      else {
+         rxWake();
+         thread_->join();
+      }
 
       ::close(fd_);
   }
@@ -111,23 +118,6 @@ void rpu::Client::stop() {
 
 //! Accept a frame from master
 void rpu::Client::acceptFrame ( ris::FramePtr frame ) {
-   ris::Frame::BufferIterator it;
-   int32_t          res;
-   fd_set           fds;
-   struct timeval   tout;
-   uint32_t         x;
-   struct msghdr    msg;
-   struct iovec     msg_iov[1];
-
-   // Setup message header
-   msg.msg_name       = &remAddr_;
-   msg.msg_namelen    = sizeof(struct sockaddr_in);
-   msg.msg_iov        = msg_iov;
-   msg.msg_iovlen     = 1;
-   msg.msg_control    = NULL;
-   msg.msg_controllen = 0;
-   msg.msg_flags      = 0;
-
    rogue::GilRelease noGil;
    ris::FrameLockPtr frLock = frame->lock();
    std::lock_guard<std::mutex> lock(udpMtx_);
@@ -138,85 +128,30 @@ void rpu::Client::acceptFrame ( ris::FramePtr frame ) {
       return;
    }
 
-   // Go through each buffer in the frame
-   for (it=frame->beginBuffer(); it != frame->endBuffer(); ++it) {
-      if ( (*it)->getPayload() == 0 ) break;
-
-      // Setup IOVs
-      msg_iov[0].iov_base = (*it)->begin();
-      msg_iov[0].iov_len  = (*it)->getPayload();
-
-      // Keep trying since select call can fire
-      // but write fails because we did not win the (*it)er lock
-      do {
+   // Send all buffers in as few calls as possible
+   txFrame(frame,&remAddr_);
+}
 
-         // Setup fds for select call
-         FD_ZERO(&fds);
-         FD_SET(fd_,&fds);
+//! Receive and forward one batch of datagrams
+bool rpu::Client::rxService() {
+   std::vector<ris::FramePtr> frames;
+   std::vector<ris::FramePtr>::iterator it;
 
-         // Setup select timeout
-         tout = timeout_;
+   if ( rxFrames(rx_,this,frames,NULL) == 0 ) return(false);
 
-         if ( select(fd_+1,NULL,&fds,NULL,&tout) <= 0 ) {
-            udpLog_->critical("Client::acceptFrame: Timeout waiting for outbound transmit after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
-            res = 0;
-         }
-         else if ( (res = sendmsg(fd_,&msg,0)) < 0 )
-            udpLog_->warning("UDP Write Call Failed");
-      }
-
-      // Continue while write result was zero
-      while ( res == 0 );
-   }
+   for (it=frames.begin(); it != frames.end(); ++it) sendFrame(*it);
+   return(true);
 }
 
 //! Run thread
 void rpu::Client::runThread() {
-   ris::BufferPtr buff;
-   ris::FramePtr  frame;
-   fd_set         fds;
-   int32_t        res;
-   struct timeval tout;
-   uint32_t       avail;
-
    udpLog_->logThreadId();
    usleep(1000);
 
-   // Preallocate frame
-   frame = ris::Pool::acceptReq(maxPayload(),false);
-
    while(threadEn_) {
 
-      // Attempt receive
-      buff = *(frame->beginBuffer());
-      avail = buff->getAvailable();
-      res = recvfrom(fd_, buff->begin(), avail, MSG_TRUNC, NULL, 0);
-
-      if ( res > 0 ) {
-
-         // Message was too big
-         if (res > avail ) udpLog_->warning("Receive data was too large. Dropping.");
-         else {
-         buff->setPayload(res);
-            sendFrame(frame);
-         }
-
-         // Get new frame
-         frame = ris::Pool::acceptReq(maxPayload(),false);
-      }
-      else {
-
-         // Setup fds for select call
-         FD_ZERO(&fds);
-         FD_SET(fd_,&fds);
-
-         // Setup select timeout
-         tout.tv_sec  = 0;
-         tout.tv_usec = 100;
-
-         // Select returns with available buffer
-         select(fd_+1,&fds,NULL,NULL,&tout);
-      }
+      // Block until data is available or stop is called
+      if ( ! rxService() ) rxWait(fd_);
    }
 }
 
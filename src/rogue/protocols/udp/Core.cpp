@@ -18,12 +18,36 @@
  * ----------------------------------------------------------------------------
 **/
 #include <rogue/protocols/udp/Core.h>
+#include <rogue/interfaces/stream/Frame.h>
+#include <rogue/interfaces/stream/Buffer.h>
 #include <rogue/Logging.h>
 #include <rogue/GeneralError.h>
 #include <rogue/Helpers.h>
+#include <rogue/GilRelease.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#ifndef __MACH__
+#include <netinet/udp.h>
+#endif
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
 
 namespace rpu = rogue::protocols::udp;
+namespace ris = rogue::interfaces::stream;
 
 #ifndef NO_PYTHON
 #define BOOST_BIND_GLOBAL_PLACEHOLDERS
@@ -34,11 +58,276 @@ namespace bp  = boost::python;
 //! Creator
 rpu::Core::Core (bool jumbo) {
    jumbo_   = jumbo;
+   gso_     = false;
+   gro_     = false;
+   rx_.fd   = -1;
    rogue::defaultTimeout(timeout_);
+
+   if ( pipe(wakeFd_) < 0 )
+      throw(rogue::GeneralError::create("Core::Core","Failed to create wake pipe"));
+
+   fcntl(wakeFd_[0], F_SETFL, O_NONBLOCK);
+   fcntl(wakeFd_[1], F_SETFL, O_NONBLOCK);
 }
 
 //! Destructor
-rpu::Core::~Core() { }
+rpu::Core::~Core() {
+   ::close(wakeFd_[0]);
+   ::close(wakeFd_[1]);
+}
+
+//! Transmit all buffers in a frame to the passed address, batched
+void rpu::Core::txFrame(ris::FramePtr frame, struct sockaddr_in * addr) {
+   ris::Frame::BufferIterator it;
+   std::vector<struct iovec> bufs;
+   struct mmsghdr   msgs[TxBatchSize];
+   uint32_t         first[TxBatchSize];
+   uint32_t         segs[TxBatchSize];
+   uint8_t          ctrl[TxBatchSize][CMSG_SPACE(sizeof(uint16_t))];
+   struct cmsghdr * cm;
+   struct pollfd    pfd;
+   int32_t          tout;
+   int32_t          res;
+   uint32_t         count;
+   uint32_t         sent;
+   uint32_t         total;
+   uint32_t         pos;
+
+   tout = (timeout_.tv_sec * 1000) + (timeout_.tv_usec / 1000);
+   if ( tout == 0 ) tout = 1;
+
+   // Collect buffers with payload
+   for (it=frame->beginBuffer(); it != frame->endBuffer() && (*it)->getPayload() != 0; ++it) {
+      bufs.push_back(iovec());
+      bufs.back().iov_base = (*it)->begin();
+      bufs.back().iov_len  = (*it)->getPayload();
+   }
+
+   pos = 0;
+   while ( pos < bufs.size() ) {
+
+      // Setup a batch of messages. Each message is one buffer, or with segmentation
+      // offload a run of equal size buffers where only the last may be shorter.
+      for (count=0; count < TxBatchSize && pos < bufs.size(); ++count) {
+         first[count] = pos;
+         segs[count]  = 1;
+         total        = bufs[pos].iov_len;
+
+         while ( gso_ && (pos + segs[count]) < bufs.size() && segs[count] < GsoMaxSegments &&
+                 bufs[pos + segs[count] - 1].iov_len == bufs[pos].iov_len &&
+                 bufs[pos + segs[count]].iov_len <= bufs[pos].iov_len &&
+                 (total + bufs[pos + segs[count]].iov_len) <= GsoMaxSize ) {
+            total += bufs[pos + segs[count]].iov_len;
+            segs[count]++;
+         }
+
+         memset(&(msgs[count]),0,sizeof(struct mmsghdr));
+         msgs[count].msg_hdr.msg_name    = addr;
+         msgs[count].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+         msgs[count].msg_hdr.msg_iov     = &(bufs[pos]);
+         msgs[count].msg_hdr.msg_iovlen  = segs[count];
+
+         // Segment size passed as ancillary data
+         if ( segs[count] > 1 ) {
+            memset(ctrl[count],0,sizeof(ctrl[count]));
+            msgs[count].msg_hdr.msg_control    = ctrl[count];
+            msgs[count].msg_hdr.msg_controllen = sizeof(ctrl[count]);
+
+            cm = CMSG_FIRSTHDR(&(msgs[count].msg_hdr));
+            cm->cmsg_level = SOL_UDP;
+            cm->cmsg_type  = UDP_SEGMENT;
+            cm->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+            *((uint16_t *)CMSG_DATA(cm)) = bufs[pos].iov_len;
+         }
+         pos += segs[count];
+      }
+
+      // Keep trying until the batch is sent, poll can fire
+      // but the write fails because we did not win the buffer space
+      sent = 0;
+      while ( sent < count ) {
+         pfd.fd      = fd_;
+         pfd.events  = POLLOUT;
+         pfd.revents = 0;
+
+         if ( poll(&pfd,1,tout) <= 0 ) {
+            udpLog_->critical("Core::txFrame: Timeout waiting for outbound transmit after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
+            continue;
+         }
+
+#ifdef __MACH__
+         res = (sendmsg(fd_,&(msgs[sent].msg_hdr),MSG_DONTWAIT) < 0) ? -1 : 1;
+#else
+         res = sendmmsg(fd_,&(msgs[sent]),count-sent,MSG_DONTWAIT);
+#endif
+
+         if ( res > 0 ) sent += res;
+
+         else if ( res < 0 && errno != EAGAIN && errno != EWOULDBLOCK ) {
+
+            // Segmented transmit is not supported on this path, fall back and
+            // rebuild the batch from the failed message
+            if ( segs[sent] > 1 ) {
+               udpLog_->warning("Segmentation offload transmit failed: %s. Disabling.",strerror(errno));
+               gso_ = false;
+               pos  = first[sent];
+               break;
+            }
+
+            // Drop the failed datagram
+            udpLog_->warning("UDP Write Call Failed");
+            sent++;
+         }
+      }
+   }
+}
+
+//! Receive a batch of datagrams without blocking, returns count or error
+int32_t rpu::Core::rxBatch(int32_t fd, struct mmsghdr * msgs, uint32_t count) {
+#ifdef __MACH__
+   int32_t  res;
+   uint32_t x;
+
+   for (x=0; x < count; x++) {
+      if ( (res = recvmsg(fd,&(msgs[x].msg_hdr),MSG_DONTWAIT | MSG_TRUNC)) < 0 ) break;
+      msgs[x].msg_len = res;
+   }
+   return((x == 0) ? -1 : x);
+#else
+   return(recvmmsg(fd,msgs,count,MSG_DONTWAIT,NULL));
+#endif
+}
+
+//! Receive a batch of frames without blocking, one per datagram
+uint32_t rpu::Core::rxFrames(rpu::Core::RxContext & ctx, ris::Pool * pool, std::vector<ris::FramePtr> & frames, struct sockaddr_in * addr) {
+   struct mmsghdr     msgs[RxBatchSize];
+   struct iovec       iovs[RxBatchSize];
+   struct sockaddr_in addrs[RxBatchSize];
+   uint8_t            ctrl[GroBatchSize][CMSG_SPACE(sizeof(int))];
+   struct cmsghdr   * cm;
+   ris::BufferPtr     buff;
+   ris::FramePtr      frame;
+   uint32_t           count;
+   uint32_t           seg;
+   uint32_t           off;
+   uint32_t           size;
+   uint32_t           ret;
+   int32_t            res;
+   int32_t            x;
+   bool               gro;
+
+   ret   = 0;
+   gro   = gro_;
+   count = (gro) ? GroBatchSize : RxBatchSize;
+
+   // Preallocate frames and buffers
+   while ( ctx.slot.size() < RxBatchSize ) ctx.slot.push_back(pool->acceptReq(maxPayload(),false));
+   if ( gro && ctx.groBuf.size() == 0 ) ctx.groBuf.resize(GroBatchSize * GroBufferSize);
+
+   // Setup receive headers
+   for (x=0; x < (int32_t)count; x++) {
+      memset(&(msgs[x]),0,sizeof(struct mmsghdr));
+      msgs[x].msg_hdr.msg_name    = &(addrs[x]);
+      msgs[x].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+      msgs[x].msg_hdr.msg_iov     = &(iovs[x]);
+      msgs[x].msg_hdr.msg_iovlen  = 1;
+
+      // Coalesced reads land in a large buffer with the segment size as ancillary data
+      if ( gro ) {
+         iovs[x].iov_base = ctx.groBuf.data() + (x * GroBufferSize);
+         iovs[x].iov_len  = GroBufferSize;
+         msgs[x].msg_hdr.msg_control    = ctrl[x];
+         msgs[x].msg_hdr.msg_controllen = sizeof(ctrl[x]);
+      }
+
+      // One pool buffer per datagram
+      else {
+         buff = *(ctx.slot[x]->beginBuffer());
+         iovs[x].iov_base = buff->begin();
+         iovs[x].iov_len  = buff->getAvailable();
+      }
+   }
+
+   if ( (res = rxBatch(ctx.fd,msgs,count)) <= 0 ) return(0);
+
+   for (x=0; x < res; x++) {
+
+      // Message was too big
+      if ( msgs[x].msg_hdr.msg_flags & MSG_TRUNC ) {
+         udpLog_->warning("Receive data was too large. Dropping.");
+         continue;
+      }
+
+      if ( gro ) {
+         seg = msgs[x].msg_len;
+
+         for (cm = CMSG_FIRSTHDR(&(msgs[x].msg_hdr)); cm != NULL; cm = CMSG_NXTHDR(&(msgs[x].msg_hdr),cm)) {
+            if ( cm->cmsg_level == SOL_UDP && cm->cmsg_type == UDP_GRO ) seg = *((int *)CMSG_DATA(cm));
+         }
+
+         // Split back into one frame per datagram
+         for (off=0; off < msgs[x].msg_len; off += seg) {
+            size = ((msgs[x].msg_len - off) < seg) ? (msgs[x].msg_len - off) : seg;
+
+            if ( size > maxPayload() ) {
+               udpLog_->warning("Receive data was too large. Dropping.");
+               continue;
+            }
+
+            frame = pool->acceptReq(maxPayload(),false);
+            buff  = *(frame->beginBuffer());
+            memcpy(buff->begin(),ctx.groBuf.data() + (x * GroBufferSize) + off,size);
+            buff->setPayload(size);
+            frames.push_back(frame);
+            ret++;
+         }
+      }
+      else {
+         (*(ctx.slot[x]->beginBuffer()))->setPayload(msgs[x].msg_len);
+         frames.push_back(ctx.slot[x]);
+         ctx.slot[x] = pool->acceptReq(maxPayload(),false);
+         ret++;
+      }
+   }
+
+   if ( addr != NULL ) *addr = addrs[res-1];
+   return(ret);
+}
+
+//! Block until receive data is available, returns false if woken for stop
+bool rpu::Core::rxWait(int32_t fd) {
+   struct pollfd pfd[2];
+
+   pfd[0].fd      = fd;
+   pfd[0].events  = POLLIN;
+   pfd[0].revents = 0;
+   pfd[1].fd      = wakeFd_[0];
+   pfd[1].events  = POLLIN;
+   pfd[1].revents = 0;
+
+   poll(pfd,2,-1);
+
+   // A stop request leaves the pipe readable so that every thread waiting
+   // on it wakes, any other wake is consumed here
+   if ( (pfd[1].revents & POLLIN) && threadEn_ ) rxDrain();
+
+   return(threadEn_);
+}
+
+//! Consume pending wake requests
+void rpu::Core::rxDrain() {
+   uint8_t buf[64];
+
+   while ( read(wakeFd_[0],buf,sizeof(buf)) > 0 ) {}
+}
+
+//! Wake the receive thread
+void rpu::Core::rxWake() {
+   uint8_t val = 0;
+
+   if ( write(wakeFd_[1],&val,1) < 0 )
+      udpLog_->warning("Failed to wake receive thread");
+}
 
 //! Return max payload
 uint32_t rpu::Core::maxPayload() {
@@ -74,12 +363,91 @@ void rpu::Core::setTimeout(uint32_t timeout) {
    timeout_.tv_usec = divResult.rem;
 }
 
+//! Enable or disable transmit segmentation offload (UDP_SEGMENT)
+bool rpu::Core::setGso(bool enable) {
+   int32_t   val;
+   socklen_t len = sizeof(val);
+
+   if ( enable ) {
+
+      // Probe for kernel support
+      if ( getsockopt(fd_, SOL_UDP, UDP_SEGMENT, &val, &len) < 0 ) {
+         udpLog_->warning("Segmentation offload is not supported: %s",strerror(errno));
+         gso_ = false;
+         return(false);
+      }
+   }
+   gso_ = enable;
+   return(true);
+}
+
+//! Get transmit segmentation offload state
+bool rpu::Core::getGso() {
+   return(gso_);
+}
+
+//! Enable or disable receive coalescing (UDP_GRO)
+bool rpu::Core::setGro(bool enable) {
+   if ( ! setSocketGro(fd_,enable) ) {
+      gro_ = false;
+      return(!enable);
+   }
+
+   gro_ = enable;
+   return(true);
+}
+
+//! Set receive coalescing option on a socket
+bool rpu::Core::setSocketGro(int32_t fd, bool enable) {
+   int32_t val = (enable) ? 1 : 0;
+
+   if ( setsockopt(fd, SOL_UDP, UDP_GRO, &val, sizeof(val)) < 0 ) {
+      if ( enable ) udpLog_->warning("Receive coalescing is not supported: %s",strerror(errno));
+      return(false);
+   }
+   return(true);
+}
+
+//! Get receive coalescing state
+bool rpu::Core::getGro() {
+   return(gro_);
+}
+
+//! Attach to a shared reactor
+void rpu::Core::setReactor(rpu::ReactorPtr reactor) {
+   rogue::GilRelease noGil;
+
+   if ( reactor_ )
+      throw(rogue::GeneralError::create("Core::setReactor","Endpoint is already attached to a reactor"));
+
+   if ( !threadEn_ )
+      throw(rogue::GeneralError::create("Core::setReactor","Endpoint is stopped"));
+
+   // Stop the dedicated receive thread
+   threadEn_ = false;
+   rxWake();
+   thread_->join();
+   delete thread_;
+   thread_ = NULL;
+
+   // Remove the stop request before re-enabling
+   rxDrain();
+   threadEn_ = true;
+   reactor_  = reactor;
+   reactor_->add(this);
+}
+
 void rpu::Core::setup_python () {
 #ifndef NO_PYTHON
    bp::class_<rpu::Core, rpu::CorePtr, boost::noncopyable >("Core",bp::no_init)
       .def("maxPayload",        &rpu::Core::maxPayload)
       .def("setRxBufferCount",  &rpu::Core::setRxBufferCount)
       .def("setTimeout",        &rpu::Core::setTimeout)
+      .def("setGso",            &rpu::Core::setGso)
+      .def("getGso",            &rpu::Core::getGso)
+      .def("setGro",            &rpu::Core::setGro)
+      .def("getGro",            &rpu::Core::getGro)
+      .def("setReactor",        &rpu::Core::setReactor)
    ;
 #endif
 }
@@ -0,0 +1,219 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : UDP Shared Reactor
+ * ----------------------------------------------------------------------------
+ * File       : Reactor.cpp
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Shared receive reactor which services multiple UDP endpoints.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#include <rogue/protocols/udp/Reactor.h>
+#include <rogue/protocols/udp/Core.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <rogue/Logging.h>
+#include <memory>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef __MACH__
+#include <sys/epoll.h>
+#endif
+
+namespace rpu = rogue::protocols::udp;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+//! Class creation
+rpu::ReactorPtr rpu::Reactor::create (uint32_t threads) {
+   rpu::ReactorPtr r = std::make_shared<rpu::Reactor>(threads);
+   return(r);
+}
+
+//! Creator
+rpu::Reactor::Reactor (uint32_t threads) {
+   uint32_t x;
+
+   log_      = rogue::Logging::create("udp.Reactor");
+   threadEn_ = false;
+
+#ifdef __MACH__
+   throw(rogue::GeneralError::create("Reactor::Reactor","Reactor is not supported on this platform"));
+#else
+   struct epoll_event ev;
+
+   if ( threads == 0 ) threads = 1;
+
+   if ( (efd_ = epoll_create1(0)) < 0 )
+      throw(rogue::GeneralError::create("Reactor::Reactor","Failed to create epoll descriptor: %s",strerror(errno)));
+
+   if ( pipe(stopFd_) < 0 )
+      throw(rogue::GeneralError::create("Reactor::Reactor","Failed to create stop pipe"));
+
+   // Stop pipe stays armed so every thread observes it
+   memset(&ev,0,sizeof(ev));
+   ev.events  = EPOLLIN;
+   ev.data.fd = stopFd_[0];
+   epoll_ctl(efd_, EPOLL_CTL_ADD, stopFd_[0], &ev);
+
+   threadEn_ = true;
+
+   for (x=0; x < threads; x++) {
+      threads_.push_back(new std::thread(&rpu::Reactor::runThread, this));
+      pthread_setname_np( threads_.back()->native_handle(), "UdpReactor" );
+   }
+
+   log_->info("Started reactor with %i threads",threads);
+#endif
+}
+
+//! Destructor
+rpu::Reactor::~Reactor() {
+   this->stop();
+}
+
+//! Stop the reactor threads
+void rpu::Reactor::stop() {
+   std::vector<std::thread *>::iterator it;
+   uint8_t val = 0;
+
+   if ( threadEn_ ) {
+      threadEn_ = false;
+
+      if ( write(stopFd_[1],&val,1) < 0 )
+         log_->warning("Failed to wake reactor threads");
+
+      for (it=threads_.begin(); it != threads_.end(); ++it) {
+         (*it)->join();
+         delete (*it);
+      }
+      threads_.clear();
+
+      ::close(efd_);
+      ::close(stopFd_[0]);
+      ::close(stopFd_[1]);
+   }
+}
+
+//! Attach an endpoint
+void rpu::Reactor::add(rpu::Core * core) {
+#ifndef __MACH__
+   struct epoll_event ev;
+
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+
+   if ( entries_.find(core->fd_) != entries_.end() )
+      throw(rogue::GeneralError::create("Reactor::add","Socket %i is already attached",core->fd_));
+
+   entries_[core->fd_].core    = core;
+   entries_[core->fd_].busy    = false;
+   entries_[core->fd_].removed = false;
+
+   // One shot so that a socket is only serviced by one thread at a time
+   memset(&ev,0,sizeof(ev));
+   ev.events  = EPOLLIN | EPOLLONESHOT;
+   ev.data.fd = core->fd_;
+
+   if ( epoll_ctl(efd_, EPOLL_CTL_ADD, core->fd_, &ev) < 0 ) {
+      entries_.erase(core->fd_);
+      throw(rogue::GeneralError::create("Reactor::add","Failed to attach socket %i: %s",core->fd_,strerror(errno)));
+   }
+#endif
+}
+
+//! Detach an endpoint, waits for any in progress service to complete
+void rpu::Reactor::remove(rpu::Core * core) {
+#ifndef __MACH__
+   std::map<int32_t, Entry>::iterator it;
+
+   rogue::GilRelease noGil;
+   std::unique_lock<std::mutex> lock(mtx_);
+
+   if ( (it = entries_.find(core->fd_)) == entries_.end() ) return;
+
+   epoll_ctl(efd_, EPOLL_CTL_DEL, core->fd_, NULL);
+   it->second.removed = true;
+
+   while ( it->second.busy ) cond_.wait(lock);
+   entries_.erase(it);
+#endif
+}
+
+//! Get the number of attached endpoints
+uint32_t rpu::Reactor::getCount() {
+   std::lock_guard<std::mutex> lock(mtx_);
+   return(entries_.size());
+}
+
+//! Thread background
+void rpu::Reactor::runThread() {
+#ifndef __MACH__
+   std::map<int32_t, Entry>::iterator it;
+   struct epoll_event evs[64];
+   struct epoll_event ev;
+   rpu::Core * core;
+   int32_t res;
+   int32_t x;
+
+   log_->logThreadId();
+
+   while ( threadEn_ ) {
+
+      if ( (res = epoll_wait(efd_, evs, 64, -1)) <= 0 ) continue;
+
+      for (x=0; x < res; x++) {
+         if ( evs[x].data.fd == stopFd_[0] ) return;
+
+         // Mark busy so removal waits for the service call
+         {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if ( (it = entries_.find(evs[x].data.fd)) == entries_.end() || it->second.removed ) continue;
+            it->second.busy = true;
+            core = it->second.core;
+         }
+
+         // Drain one batch
+         core->rxService();
+
+         // Re-arm or complete removal
+         {
+            std::lock_guard<std::mutex> lock(mtx_);
+            it->second.busy = false;
+
+            if ( it->second.removed ) cond_.notify_all();
+            else {
+               memset(&ev,0,sizeof(ev));
+               ev.events  = EPOLLIN | EPOLLONESHOT;
+               ev.data.fd = evs[x].data.fd;
+               epoll_ctl(efd_, EPOLL_CTL_MOD, evs[x].data.fd, &ev);
+            }
+         }
+      }
+   }
+#endif
+}
+
+void rpu::Reactor::setup_python () {
+#ifndef NO_PYTHON
+
+   bp::class_<rpu::Reactor, rpu::ReactorPtr, boost::noncopyable >("Reactor",bp::init<uint32_t>())
+      .def("stop",     &rpu::Reactor::stop)
+      .def("getCount", &rpu::Reactor::getCount)
+   ;
+#endif
+}
@@ -30,6 +30,11 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#ifndef __MACH__
+#include <sched.h>
+#include <linux/filter.h>
+#endif
 
 namespace rpu = rogue::protocols::udp;
 namespace ris = rogue::interfaces::stream;
@@ -41,23 +46,20 @@ namespace bp  = boost::python;
 #endif
 
 //! Class creation
-rpu::ServerPtr rpu::Server::create (uint16_t port, bool jumbo) {
-   rpu::ServerPtr r = std::make_shared<rpu::Server>(port,jumbo);
+rpu::ServerPtr rpu::Server::create (uint16_t port, bool jumbo, uint32_t shards) {
+   rpu::ServerPtr r = std::make_shared<rpu::Server>(port,jumbo,shards);
    return(r);
 }
 
 //! Creator
-rpu::Server::Server (uint16_t port, bool jumbo) : rpu::Core(jumbo) {
+rpu::Server::Server (uint16_t port, bool jumbo, uint32_t shards) : rpu::Core(jumbo) {
    uint32_t len;
-   int32_t  val;
-   uint32_t  size;
+   uint32_t x;
 
    port_    = port;
    udpLog_ = rogue::Logging::create("udp.Server");
 
-   // Create socket
-   if ( (fd_ = socket(AF_INET,SOCK_DGRAM,0)) < 0 )
-      throw(rogue::GeneralError::create("Server::Server","Failed to create socket for port %i",port_));
+   if ( shards == 0 ) shards = 1;
 
    // Setup Remote Address
    memset(&locAddr_,0,sizeof(struct sockaddr_in));
@@ -67,8 +69,9 @@ rpu::Server::Server (uint16_t port, bool jumbo) : rpu::Core(jumbo) {
 
    memset(&remAddr_,0,sizeof(struct sockaddr_in));
 
-   if (bind(fd_, (struct sockaddr *) &locAddr_, sizeof(locAddr_))<0)
-      throw(rogue::GeneralError::create("Server::Server","Failed to bind to local port %i. Another process may be using it",port_));
+   // Create primary socket
+   fd_    = openSocket(shards > 1);
+   rx_.fd = fd_;
 
    // Kernel assigns port
    if ( port_ == 0 ) {
@@ -78,6 +81,15 @@ rpu::Server::Server (uint16_t port, bool jumbo) : rpu::Core(jumbo) {
       port_ = ntohs(locAddr_.sin_port);
    }
 
+   // Additional shard sockets share the port
+   shards_.resize(shards-1);
+   for (x=0; x < shards_.size(); x++) {
+      shards_[x].fd = openSocket(true);
+      shardPorts_.push_back(rpu::ServerShard::create(this,x+1));
+   }
+
+   if ( shards > 1 ) attachSteering();
+
    // Fixed size buffer pool
    setFixedSize(maxPayload());
    setPoolSize(10000); // Initial value, 10K frames
@@ -90,6 +102,14 @@ rpu::Server::Server (uint16_t port, bool jumbo) : rpu::Core(jumbo) {
 #ifndef __MACH__
    pthread_setname_np( thread_->native_handle(), "UdpServer" );
 #endif
+
+   // Start shard threads
+   for (x=0; x < shards_.size(); x++) {
+      shardThreads_.push_back(new std::thread(&rpu::Server::runShard, this, x));
+#ifndef __MACH__
+      pthread_setname_np( shardThreads_.back()->native_handle(), "UdpServer" );
+#endif
+   }
 }
 
 //! Destructor
@@ -98,31 +118,159 @@ rpu::Server::~Server() {
 }
 
 void rpu::Server::stop() {
+  std::vector<std::thread *>::iterator it;
+  uint32_t x;
+
   if (threadEn_)  {
       threadEn_ = false;
-      thread_->join();
 
+      // Wake the primary and shard threads, they share the wake pipe
+      rxWake();
+
+      if ( reactor_ ) reactor_->remove(this);
+      else {
+         thread_->join();
+         delete thread_;
+         thread_ = NULL;
+      }
+
+      for (it=shardThreads_.begin(); it != shardThreads_.end(); ++it) {
+         (*it)->join();
+         delete (*it);
+      }
+      shardThreads_.clear();
+
+      for (x=0; x < shards_.size(); x++) {
+         shardPorts_[x]->close();
+         ::close(shards_[x].fd);
+      }
       ::close(fd_);
   }
 }
 
+//! Create and bind a socket
+int32_t rpu::Server::openSocket(bool reuse) {
+   int32_t fd;
+   int32_t val = 1;
+
+   // Create socket
+   if ( (fd = socket(AF_INET,SOCK_DGRAM,0)) < 0 )
+      throw(rogue::GeneralError::create("Server::Server","Failed to create socket for port %i",port_));
+
+   if ( reuse && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &val, sizeof(val)) < 0 )
+      throw(rogue::GeneralError::create("Server::Server","Failed to enable port reuse for port %i",port_));
+
+   if (bind(fd, (struct sockaddr *) &locAddr_, sizeof(locAddr_))<0)
+      throw(rogue::GeneralError::create("Server::Server","Failed to bind to local port %i. Another process may be using it",port_));
+
+   return(fd);
+}
+
+//! Attach steering program keyed on source address and port
+void rpu::Server::attachSteering() {
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+   struct sock_fprog prog;
+
+   // Select socket index from the IPv4 source address xor the UDP source port,
+   // modulo the shard count. The port follows the variable length IP header.
+   struct sock_filter code[] = {
+      { BPF_LDX | BPF_B   | BPF_MSH, 0, 0, (uint32_t)SKF_NET_OFF },
+      { BPF_LD  | BPF_H   | BPF_IND, 0, 0, (uint32_t)SKF_NET_OFF },
+      { BPF_ST,                      0, 0, 0 },
+      { BPF_LD  | BPF_W   | BPF_ABS, 0, 0, (uint32_t)(SKF_NET_OFF + 12) },
+      { BPF_LDX | BPF_W   | BPF_MEM, 0, 0, 0 },
+      { BPF_ALU | BPF_XOR | BPF_X,   0, 0, 0 },
+      { BPF_ALU | BPF_MOD | BPF_K,   0, 0, (uint32_t)(shards_.size() + 1) },
+      { BPF_RET | BPF_A,             0, 0, 0 },
+   };
+
+   prog.len    = sizeof(code) / sizeof(code[0]);
+   prog.filter = code;
+
+   if ( setsockopt(fd_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == 0 ) return;
+#endif
+
+   // Kernel flow hash still keeps each source on a single socket
+   udpLog_->warning("Source address steering is not supported, using kernel flow hash");
+}
+
 //! Get port number
 uint32_t rpu::Server::getPort() {
    return(port_);
 }
 
+//! Get the number of receive shards
+uint32_t rpu::Server::getShardCount() {
+   return(shards_.size() + 1);
+}
+
+//! Get the stream endpoint of an additional shard
+rpu::ServerShardPtr rpu::Server::getShard(uint32_t shard) {
+   if ( shard == 0 || shard > shards_.size() )
+      throw(rogue::GeneralError::create("Server::getShard","Invalid shard %i, valid range is 1 to %i",shard,shards_.size()));
+
+   return(shardPorts_[shard-1]);
+}
+
+//! Pin the receive thread of a shard to a CPU
+bool rpu::Server::setShardCpu(uint32_t shard, uint32_t cpu) {
+#ifndef __MACH__
+   std::thread * thr;
+   cpu_set_t     set;
+
+   if ( shard > shards_.size() )
+      throw(rogue::GeneralError::create("Server::setShardCpu","Invalid shard %i",shard));
+
+   thr = ( shard == 0 ) ? thread_ : shardThreads_[shard-1];
+
+   if ( thr == NULL ) return(false);
+
+   CPU_ZERO(&set);
+   CPU_SET(cpu,&set);
+   return(pthread_setaffinity_np(thr->native_handle(), sizeof(set), &set) == 0);
+#else
+   return(false);
+#endif
+}
+
+//! Enable or disable receive coalescing on all shard sockets
+bool rpu::Server::setGro(bool enable) {
+   bool     ret;
+   uint32_t x;
+
+   ret = setSocketGro(fd_,enable);
+   for (x=0; x < shards_.size(); x++) ret = setSocketGro(shards_[x].fd,enable) && ret;
+
+   // All sockets must agree
+   if ( ! ret ) {
+      setSocketGro(fd_,false);
+      for (x=0; x < shards_.size(); x++) setSocketGro(shards_[x].fd,false);
+      gro_ = false;
+      return(!enable);
+   }
+
+   gro_ = enable;
+   return(true);
+}
+
+//! Attach to a shared reactor
+void rpu::Server::setReactor(rpu::ReactorPtr reactor) {
+   if ( getShardCount() > 1 )
+      throw(rogue::GeneralError::create("Server::setReactor","A server with %i shards can not be attached to a reactor",getShardCount()));
+
+   rpu::Core::setReactor(reactor);
+}
+
 //! Accept a frame from master
 void rpu::Server::acceptFrame ( ris::FramePtr frame ) {
-   ris::Frame::BufferIterator it;
-   int32_t          res;
-   fd_set           fds;
-   struct timeval   tout;
-   uint32_t         x;
-   struct msghdr    msg;
-   struct iovec     msg_iov[1];
-
    rogue::GilRelease noGil;
    ris::FrameLockPtr frLock = frame->lock();
+
+   txShard(frame,&remAddr_);
+}
+
+//! Transmit a frame to the passed address
+void rpu::Server::txShard ( ris::FramePtr frame, struct sockaddr_in * addr ) {
    std::lock_guard<std::mutex> lock(udpMtx_);
 
    // Drop errored frames
@@ -131,111 +279,72 @@ void rpu::Server::acceptFrame ( ris::FramePtr frame ) {
       return;
    }
 
-   // Setup message header
-   msg.msg_name       = &remAddr_;
-   msg.msg_namelen    = sizeof(struct sockaddr_in);
-   msg.msg_iov        = msg_iov;
-   msg.msg_iovlen     = 1;
-   msg.msg_control    = NULL;
-   msg.msg_controllen = 0;
-   msg.msg_flags      = 0;
-
-   // Go through each buffer in the frame
-   for (it=frame->beginBuffer(); it != frame->endBuffer(); ++it) {
-      if ( (*it)->getPayload() == 0 ) break;
-
-      // Setup IOVs
-      msg_iov[0].iov_base = (*it)->begin();
-      msg_iov[0].iov_len  = (*it)->getPayload();
-
-      // Keep trying since select call can fire
-      // but write fails because we did not win the buffer lock
-      do {
-
-         // Setup fds for select call
-         FD_ZERO(&fds);
-         FD_SET(fd_,&fds);
-
-         // Setup select timeout
-         tout = timeout_;
-
-         if ( select(fd_+1,NULL,&fds,NULL,&tout) <= 0 ) {
-            udpLog_->critical("Server::acceptFrame: Timeout waiting for outbound transmit after %i.%i seconds! May be caused by outbound backpressure.", timeout_.tv_sec, timeout_.tv_usec);
-            res = 0;
-         }
-         else if ( (res = sendmsg(fd_,&msg,0)) < 0 )
-            udpLog_->warning("UDP Write Call Failed");
-      }
+   // Send all buffers in as few calls as possible, all shard sockets share the local port
+   txFrame(frame,addr);
+}
 
-      // Continue while write result was zero
-      while ( res == 0 );
-   }
+//! Receive and forward one batch of datagrams
+bool rpu::Server::rxService() {
+   std::vector<ris::FramePtr> frames;
+   std::vector<ris::FramePtr>::iterator it;
+   struct sockaddr_in tmpAddr;
+
+   if ( rxFrames(rx_,this,frames,&tmpAddr) == 0 ) return(false);
+
+   for (it=frames.begin(); it != frames.end(); ++it) sendFrame(*it);
+
+   // Lock before updating address
+   std::lock_guard<std::mutex> lock(udpMtx_);
+   if ( memcmp(&remAddr_, &tmpAddr, sizeof(remAddr_)) != 0 ) remAddr_ = tmpAddr;
+   return(true);
 }
 
-//! Run thread
-void rpu::Server::runThread() {
-   ris::BufferPtr     buff;
-   ris::FramePtr      frame;
-   fd_set             fds;
-   int32_t            res;
-   struct timeval     tout;
+//! Receive and forward one batch of datagrams from an additional shard socket
+bool rpu::Server::rxShard(uint32_t idx) {
+   std::vector<ris::FramePtr> frames;
+   std::vector<ris::FramePtr>::iterator it;
    struct sockaddr_in tmpAddr;
-   uint32_t           tmpLen;
-   uint32_t           avail;
 
+   if ( rxFrames(shards_[idx],this,frames,&tmpAddr) == 0 ) return(false);
+
+   for (it=frames.begin(); it != frames.end(); ++it) shardPorts_[idx]->sendFrame(*it);
+
+   shardPorts_[idx]->setRemote(&tmpAddr);
+   return(true);
+}
+
+//! Run thread
+void rpu::Server::runThread() {
    udpLog_->logThreadId();
    usleep(1000);
 
-   // Preallocate frame
-   frame = ris::Pool::acceptReq(maxPayload(),false);
-
    while(threadEn_) {
 
-      // Attempt receive
-      buff = *(frame->beginBuffer());
-      avail = buff->getAvailable();
-      tmpLen = sizeof(struct sockaddr_in);
-      res = recvfrom(fd_, buff->begin(), avail, MSG_TRUNC, (struct sockaddr *)&tmpAddr, &tmpLen);
-
-      if ( res > 0 ) {
-
-         // Message was too big
-         if (res > avail ) udpLog_->warning("Receive data was too large. Dropping.");
-         else {
-            buff->setPayload(res);
-            sendFrame(frame);
-         }
-
-         // Get new frame
-         frame = ris::Pool::acceptReq(maxPayload(),false);
-
-         // Lock before updating address
-         if ( memcmp(&remAddr_, &tmpAddr, sizeof(remAddr_)) != 0 ) {
-            std::lock_guard<std::mutex> lock(udpMtx_);
-            remAddr_ = tmpAddr;
-         }
-      }
-      else {
+      // Block until data is available or stop is called
+      if ( ! rxService() ) rxWait(fd_);
+   }
+}
 
-         // Setup fds for select call
-         FD_ZERO(&fds);
-         FD_SET(fd_,&fds);
+//! Thread background for additional shard sockets
+void rpu::Server::runShard(uint32_t idx) {
+   udpLog_->logThreadId();
+   usleep(1000);
 
-         // Setup select timeout
-         tout.tv_sec  = 0;
-         tout.tv_usec = 100;
+   while(threadEn_) {
 
-         // Select returns with available buffer
-         select(fd_+1,&fds,NULL,NULL,&tout);
-      }
+      // Block until data is available or stop is called
+      if ( ! rxShard(idx) ) rxWait(shards_[idx].fd);
    }
 }
 
 void rpu::Server::setup_python () {
 #ifndef NO_PYTHON
 
-   bp::class_<rpu::Server, rpu::ServerPtr, bp::bases<rpu::Core,ris::Master,ris::Slave>, boost::noncopyable >("Server",bp::init<uint16_t,bool>())
+   bp::class_<rpu::Server, rpu::ServerPtr, bp::bases<rpu::Core,ris::Master,ris::Slave>, boost::noncopyable >("Server",bp::init<uint16_t,bool,bp::optional<uint32_t>>())
       .def("getPort",        &rpu::Server::getPort)
+      .def("getShardCount",  &rpu::Server::getShardCount)
+      .def("getShard",       &rpu::Server::getShard)
+      .def("setShardCpu",    &rpu::Server::setShardCpu)
    ;
 
    bp::implicitly_convertible<rpu::ServerPtr, rpu::CorePtr>();
@@ -0,0 +1,91 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title      : UDP Server Shard
+ * ----------------------------------------------------------------------------
+ * File       : ServerShard.cpp
+ * ----------------------------------------------------------------------------
+ * Description:
+ * Stream endpoint for an additional receive shard of a UDP Server.
+ * ----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ * ----------------------------------------------------------------------------
+**/
+#include <rogue/protocols/udp/Core.h>
+#include <rogue/protocols/udp/ServerShard.h>
+#include <rogue/protocols/udp/Server.h>
+#include <rogue/interfaces/stream/Frame.h>
+#include <rogue/interfaces/stream/FrameLock.h>
+#include <rogue/GilRelease.h>
+#include <memory>
+#include <string.h>
+
+namespace rpu = rogue::protocols::udp;
+namespace ris = rogue::interfaces::stream;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+//! Class creation
+rpu::ServerShardPtr rpu::ServerShard::create (rpu::Server * server, uint32_t index) {
+   rpu::ServerShardPtr r = std::make_shared<rpu::ServerShard>(server,index);
+   return(r);
+}
+
+//! Creator
+rpu::ServerShard::ServerShard (rpu::Server * server, uint32_t index) {
+   server_ = server;
+   index_  = index;
+   memset(&remAddr_,0,sizeof(struct sockaddr_in));
+}
+
+//! Destructor
+rpu::ServerShard::~ServerShard() { }
+
+//! Get shard index
+uint32_t rpu::ServerShard::getIndex() {
+   return(index_);
+}
+
+//! Update the remote address from a received datagram
+void rpu::ServerShard::setRemote(struct sockaddr_in * addr) {
+   std::lock_guard<std::mutex> lock(mtx_);
+   if ( memcmp(&remAddr_, addr, sizeof(remAddr_)) != 0 ) remAddr_ = *addr;
+}
+
+//! Detach from the server
+void rpu::ServerShard::close() {
+   std::lock_guard<std::mutex> lock(mtx_);
+   server_ = NULL;
+}
+
+//! Accept a frame from master
+void rpu::ServerShard::acceptFrame ( ris::FramePtr frame ) {
+   rogue::GilRelease noGil;
+   ris::FrameLockPtr frLock = frame->lock();
+   std::lock_guard<std::mutex> lock(mtx_);
+
+   if ( server_ == NULL ) return;
+
+   server_->txShard(frame,&remAddr_);
+}
+
+void rpu::ServerShard::setup_python () {
+#ifndef NO_PYTHON
+
+   bp::class_<rpu::ServerShard, rpu::ServerShardPtr, bp::bases<ris::Master,ris::Slave>, boost::noncopyable >("ServerShard",bp::no_init)
+      .def("getIndex", &rpu::ServerShard::getIndex)
+   ;
+
+   bp::implicitly_convertible<rpu::ServerShardPtr, ris::MasterPtr>();
+   bp::implicitly_convertible<rpu::ServerShardPtr, ris::SlavePtr>();
+#endif
+}
@@ -27,6 +27,8 @@
 #include <rogue/protocols/udp/Core.h>
 #include <rogue/protocols/udp/Client.h>
 #include <rogue/protocols/udp/Server.h>
+#include <rogue/protocols/udp/ServerShard.h>
+#include <rogue/protocols/udp/Reactor.h>
 
 namespace bp  = boost::python;
 namespace rpu = rogue::protocols::udp;
@@ -45,5 +47,7 @@ void rpu::setup_module() {
    rpu::Core::setup_python();
    rpu::Client::setup_python();
    rpu::Server::setup_python();
+   rpu::ServerShard::setup_python();
+   rpu::Reactor::setup_python();
 }
 
@@ -0,0 +1,363 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title         : CRC-32 Checksum Library
+ *-----------------------------------------------------------------------------
+ * Description :
+ *    CRC-32 (IEEE 802.3, reflected 0xEDB88320) with table, slicing-by-16
+ *    and carry-less multiply / CRC instruction implementations selected at
+ *    run time.
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#include <rogue/utilities/Crc32.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <string.h>
+
+// Reference table implementation
+#define CRCPP_USE_CPP11
+#include <rogue/protocols/packetizer/CRC.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CRC32_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#define CRC32_ARM
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace ru = rogue::utilities;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp  = boost::python;
+#endif
+
+// Reference byte table, shared with the packetizer
+static const CRC::Table<uint32_t, 32> crcTable_(CRC::CRC_32());
+
+// Slicing by 16 tables
+struct Slice16Tables {
+   uint32_t t[16][256];
+
+   Slice16Tables() {
+      uint32_t i;
+      uint32_t j;
+      uint32_t c;
+
+      for (i=0; i < 256; i++) {
+         c = i;
+         for (j=0; j < 8; j++) c = (c >> 1) ^ ((c & 1) ? 0xEDB88320 : 0);
+         t[0][i] = c;
+      }
+
+      for (i=0; i < 256; i++)
+         for (j=1; j < 16; j++) t[j][i] = (t[j-1][i] >> 8) ^ t[0][t[j-1][i] & 0xFF];
+   }
+};
+
+static const Slice16Tables slice_;
+
+// Byte at a time using the first slice table, crc is the raw register
+static inline uint32_t crcBytes(uint32_t crc, const uint8_t *data, size_t size) {
+   while ( size-- ) crc = (crc >> 8) ^ slice_.t[0][(crc ^ *data++) & 0xFF];
+   return crc;
+}
+
+// Slicing by 16, crc is the raw register
+static uint32_t crcSlice16(uint32_t crc, const uint8_t *data, size_t size) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+   uint32_t w[4];
+
+   while ( size >= 16 ) {
+      memcpy(w,data,16);
+      w[0] ^= crc;
+
+      crc = slice_.t[15][ w[0]        & 0xFF] ^ slice_.t[14][(w[0] >>  8) & 0xFF] ^
+            slice_.t[13][(w[0] >> 16) & 0xFF] ^ slice_.t[12][ w[0] >> 24        ] ^
+            slice_.t[11][ w[1]        & 0xFF] ^ slice_.t[10][(w[1] >>  8) & 0xFF] ^
+            slice_.t[ 9][(w[1] >> 16) & 0xFF] ^ slice_.t[ 8][ w[1] >> 24        ] ^
+            slice_.t[ 7][ w[2]        & 0xFF] ^ slice_.t[ 6][(w[2] >>  8) & 0xFF] ^
+            slice_.t[ 5][(w[2] >> 16) & 0xFF] ^ slice_.t[ 4][ w[2] >> 24        ] ^
+            slice_.t[ 3][ w[3]        & 0xFF] ^ slice_.t[ 2][(w[3] >>  8) & 0xFF] ^
+            slice_.t[ 1][(w[3] >> 16) & 0xFF] ^ slice_.t[ 0][ w[3] >> 24        ];
+
+      data += 16;
+      size -= 16;
+   }
+#endif
+   return crcBytes(crc,data,size);
+}
+
+#ifdef CRC32_X86
+
+// PCLMULQDQ folding over a multiple of 16 bytes, at least 64. crc is the raw register.
+// Folding and Barrett constants for the reflected polynomial from Intel's
+// "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crcClmulBlocks(uint32_t crc, const uint8_t *data, size_t size) {
+   static const uint64_t k1k2[] __attribute__((aligned(16))) = { 0x0154442bd4, 0x01c6e41596 };
+   static const uint64_t k3k4[] __attribute__((aligned(16))) = { 0x01751997d0, 0x00ccaa009e };
+   static const uint64_t k5k0[] __attribute__((aligned(16))) = { 0x0163cd6124, 0x0000000000 };
+   static const uint64_t poly[] __attribute__((aligned(16))) = { 0x01db710641, 0x01f7011641 };
+
+   __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+   x1 = _mm_loadu_si128((const __m128i *)(data + 0x00));
+   x2 = _mm_loadu_si128((const __m128i *)(data + 0x10));
+   x3 = _mm_loadu_si128((const __m128i *)(data + 0x20));
+   x4 = _mm_loadu_si128((const __m128i *)(data + 0x30));
+
+   x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+   x0 = _mm_load_si128((const __m128i *)k1k2);
+
+   data += 64;
+   size -= 64;
+
+   // Fold four lanes in parallel
+   while ( size >= 64 ) {
+      x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+      x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+      x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+      x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+      x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+      x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+      x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+      x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+      y5 = _mm_loadu_si128((const __m128i *)(data + 0x00));
+      y6 = _mm_loadu_si128((const __m128i *)(data + 0x10));
+      y7 = _mm_loadu_si128((const __m128i *)(data + 0x20));
+      y8 = _mm_loadu_si128((const __m128i *)(data + 0x30));
+
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+      x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+      x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+      x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+      data += 64;
+      size -= 64;
+   }
+
+   // Fold the four lanes into one
+   x0 = _mm_load_si128((const __m128i *)k3k4);
+
+   x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+   x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+   x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+   x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+   x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+   x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+   x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+   x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+   x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+   // Remaining 16 byte blocks
+   while ( size >= 16 ) {
+      x2 = _mm_loadu_si128((const __m128i *)data);
+
+      x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+      data += 16;
+      size -= 16;
+   }
+
+   // Fold 128 bits to 64 bits
+   x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+   x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+   x1 = _mm_srli_si128(x1, 8);
+   x1 = _mm_xor_si128(x1, x2);
+
+   x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+
+   x2 = _mm_srli_si128(x1, 4);
+   x1 = _mm_and_si128(x1, x3);
+   x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+   x1 = _mm_xor_si128(x1, x2);
+
+   // Barrett reduction to 32 bits
+   x0 = _mm_load_si128((const __m128i *)poly);
+
+   x2 = _mm_and_si128(x1, x3);
+   x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+   x2 = _mm_and_si128(x2, x3);
+   x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+   x1 = _mm_xor_si128(x1, x2);
+
+   return _mm_extract_epi32(x1, 1);
+}
+
+// Folding for the bulk of the data, slicing for the remainder
+static uint32_t crcClmul(uint32_t crc, const uint8_t *data, size_t size) {
+   size_t bulk;
+
+   if ( size >= 64 ) {
+      bulk = size & ~((size_t)15);
+      crc  = crcClmulBlocks(crc,data,bulk);
+      data += bulk;
+      size -= bulk;
+   }
+   return crcSlice16(crc,data,size);
+}
+
+static bool clmulSupported() {
+   uint32_t a, b, c, d;
+
+   if ( ! __get_cpuid(1,&a,&b,&c,&d) ) return false;
+   return ((c & bit_PCLMUL) != 0) && ((c & bit_SSE4_1) != 0);
+}
+
+#endif
+
+#ifdef CRC32_ARM
+
+// ARMv8 CRC32 instructions, crc is the raw register
+__attribute__((target("+crc")))
+static uint32_t crcArm(uint32_t crc, const uint8_t *data, size_t size) {
+   uint64_t w;
+
+   while ( size >= 8 ) {
+      memcpy(&w,data,8);
+      crc = __crc32d(crc,w);
+      data += 8;
+      size -= 8;
+   }
+   while ( size-- ) crc = __crc32b(crc,*data++);
+   return crc;
+}
+
+static bool armSupported() {
+   return((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0);
+}
+
+#endif
+
+// Implementation selected at load time
+static uint32_t selectImpl() {
+#ifdef CRC32_X86
+   if ( clmulSupported() ) return ru::Crc32::Clmul;
+#endif
+#ifdef CRC32_ARM
+   if ( armSupported() ) return ru::Crc32::ArmCrc;
+#endif
+   return ru::Crc32::Slice16;
+}
+
+static const uint32_t autoImpl_ = selectImpl();
+
+//! Compute with the fastest supported implementation
+uint32_t ru::Crc32::compute(const uint8_t *data, size_t size, uint32_t crc) {
+   return compute(autoImpl_,data,size,crc);
+}
+
+//! Compute with a specific implementation
+uint32_t ru::Crc32::compute(uint32_t impl, const uint8_t *data, size_t size, uint32_t crc) {
+   if ( impl == Auto ) impl = autoImpl_;
+
+   switch (impl) {
+      case Table   : return CRC::Calculate(data, size, crcTable_, crc);
+      case Slice16 : return ~crcSlice16(~crc,data,size);
+#ifdef CRC32_X86
+      case Clmul   : if ( clmulSupported() ) return ~crcClmul(~crc,data,size); break;
+#endif
+#ifdef CRC32_ARM
+      case ArmCrc  : if ( armSupported() ) return ~crcArm(~crc,data,size); break;
+#endif
+      default : break;
+   }
+   throw(rogue::GeneralError::create("Crc32::compute","Implementation %i is not supported",impl));
+}
+
+//! Return true if implementation is supported by this cpu
+bool ru::Crc32::supported(uint32_t impl) {
+   switch (impl) {
+      case Auto    :
+      case Table   :
+      case Slice16 : return true;
+#ifdef CRC32_X86
+      case Clmul   : return clmulSupported();
+#endif
+#ifdef CRC32_ARM
+      case ArmCrc  : return armSupported();
+#endif
+      default : return false;
+   }
+}
+
+//! Get the name of the implementation selected by Auto
+std::string ru::Crc32::implName() {
+   switch (autoImpl_) {
+      case Clmul  : return "clmul";
+      case ArmCrc : return "armcrc";
+      default     : return "slice16";
+   }
+}
+
+#ifndef NO_PYTHON
+
+//! Compute over a python buffer
+uint32_t ru::Crc32::computePy(boost::python::object p, uint32_t crc) {
+   return computeImplPy(Auto,p,crc);
+}
+
+//! Compute over a python buffer with a specific implementation
+uint32_t ru::Crc32::computeImplPy(uint32_t impl, boost::python::object p, uint32_t crc) {
+   Py_buffer pyBuf;
+   uint32_t ret;
+
+   if ( PyObject_GetBuffer(p.ptr(),&pyBuf,PyBUF_SIMPLE) < 0 )
+      throw(rogue::GeneralError("Crc32::computePy","Python Buffer Error"));
+
+   try {
+      rogue::GilRelease noGil;
+      ret = compute(impl,(const uint8_t *)pyBuf.buf,pyBuf.len,crc);
+   } catch (...) {
+      PyBuffer_Release(&pyBuf);
+      throw;
+   }
+
+   PyBuffer_Release(&pyBuf);
+   return ret;
+}
+
+#endif
+
+void ru::Crc32::setup_python() {
+#ifndef NO_PYTHON
+   bp::class_<ru::Crc32> cls("Crc32",bp::no_init);
+
+   cls.def("compute",     &ru::Crc32::computePy, (bp::arg("data"), bp::arg("crc")=0))
+      .staticmethod("compute")
+      .def("computeImpl", &ru::Crc32::computeImplPy, (bp::arg("impl"), bp::arg("data"), bp::arg("crc")=0))
+      .staticmethod("computeImpl")
+      .def("supported",   &ru::Crc32::supported)
+      .staticmethod("supported")
+      .def("implName",    &ru::Crc32::implName)
+      .staticmethod("implName")
+   ;
+
+   cls.attr("Auto")    = (uint32_t)ru::Crc32::Auto;
+   cls.attr("Table")   = (uint32_t)ru::Crc32::Table;
+   cls.attr("Slice16") = (uint32_t)ru::Crc32::Slice16;
+   cls.attr("Clmul")   = (uint32_t)ru::Crc32::Clmul;
+   cls.attr("ArmCrc")  = (uint32_t)ru::Crc32::ArmCrc;
+#endif
+}
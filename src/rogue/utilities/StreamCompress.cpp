@@ -0,0 +1,406 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title         : Rogue stream compressor, LZ4 and Zstd
+ * ----------------------------------------------------------------------------
+ * File          : StreamCompress.cpp
+ *-----------------------------------------------------------------------------
+ * Description :
+ *    Stream module to compress a data stream with LZ4 or Zstd
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#include <unistd.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <rogue/interfaces/stream/Slave.h>
+#include <rogue/interfaces/stream/Master.h>
+#include <rogue/interfaces/stream/Frame.h>
+#include <rogue/interfaces/stream/FrameLock.h>
+#include <rogue/interfaces/stream/FrameIterator.h>
+#include <rogue/interfaces/stream/Buffer.h>
+#include <rogue/utilities/StreamCompress.h>
+#include <rogue/utilities/Crc32.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <memory>
+#include <lz4.h>
+#include <zstd.h>
+
+namespace ris = rogue::interfaces::stream;
+namespace ru  = rogue::utilities;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp = boost::python;
+#endif
+
+//! Dictionary, shared by the contexts created while it is current
+struct ru::StreamCompress::Dict {
+   std::vector<uint8_t> data;
+   ZSTD_CDict * cdict;
+   uint32_t id;
+
+   Dict() : cdict(NULL), id(0) { }
+   ~Dict() { ZSTD_freeCDict(cdict); }
+};
+
+//! Compression context
+struct ru::StreamCompress::Context {
+   uint32_t gen;
+
+   // Dictionary is held until the context is discarded
+   std::shared_ptr<ru::StreamCompress::Dict> dict;
+
+   // Zstd context
+   ZSTD_CCtx * zstd;
+
+   // LZ4 state, with a copy of the state after the dictionary is loaded
+   LZ4_stream_t * lz4;
+   LZ4_stream_t * lz4Dict;
+
+   // Scratch buffers for frames which span buffers
+   std::vector<uint8_t> in;
+   std::vector<uint8_t> out;
+
+   Context() : gen(0), zstd(NULL), lz4(NULL), lz4Dict(NULL) { }
+
+   ~Context() {
+      ZSTD_freeCCtx(zstd);
+      LZ4_freeStream(lz4);
+      LZ4_freeStream(lz4Dict);
+   }
+};
+
+//! Class creation
+ru::StreamCompressPtr ru::StreamCompress::create (uint32_t codec, int32_t level) {
+   ru::StreamCompressPtr p = std::make_shared<ru::StreamCompress>(codec,level);
+   return(p);
+}
+
+//! Creator
+ru::StreamCompress::StreamCompress(uint32_t codec, int32_t level) : ris::Slave(), ris::Master() {
+   if ( codec != Lz4 && codec != Zstd )
+      throw(rogue::GeneralError::create("StreamCompress::StreamCompress","Invalid codec %i",codec));
+
+   log_ = rogue::Logging::create("utilities.StreamCompress");
+
+   codec_       = codec;
+   level_       = level;
+   gen_         = 1;
+   inBytes_     = 0;
+   outBytes_    = 0;
+}
+
+//! Deconstructor
+ru::StreamCompress::~StreamCompress() {
+   uint32_t x;
+
+   rogue::GilRelease noGil;
+   workers_.stop();
+
+   for (x=0; x < free_.size(); x++) delete free_[x];
+}
+
+//! Set level, Zstd level or LZ4 acceleration
+void ru::StreamCompress::setLevel(int32_t level) {
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(ctxMtx_);
+   level_ = level;
+
+   // Zstd dictionary is digested for the level
+   if ( dict_ && codec_ == Zstd ) {
+      std::shared_ptr<ru::StreamCompress::Dict> dict = std::make_shared<ru::StreamCompress::Dict>();
+      dict->data  = dict_->data;
+      dict->id    = dict_->id;
+      dict->cdict = ZSTD_createCDict(dict->data.data(),dict->data.size(),level_);
+      dict_ = dict;
+   }
+   gen_++;
+}
+
+//! Get level
+int32_t ru::StreamCompress::getLevel() {
+   return(level_);
+}
+
+//! Load a dictionary file, an empty name disables the dictionary
+void ru::StreamCompress::setDictionary(std::string file) {
+   std::shared_ptr<ru::StreamCompress::Dict> dict;
+
+   rogue::GilRelease noGil;
+
+   if ( file != "" ) {
+      std::ifstream ifs(file.c_str(), std::ios::binary);
+
+      if ( ! ifs.is_open() )
+         throw(rogue::GeneralError::create("StreamCompress::setDictionary","Failed to open dictionary file: %s",file.c_str()));
+
+      dict = std::make_shared<ru::StreamCompress::Dict>();
+      dict->data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+      if ( dict->data.size() == 0 )
+         throw(rogue::GeneralError::create("StreamCompress::setDictionary","Dictionary file is empty: %s",file.c_str()));
+
+      // Id stored in LZ4 frames, Zstd frames carry the id from the dictionary header
+      dict->id = ru::Crc32::compute(dict->data.data(),dict->data.size());
+      if ( dict->id == 0 ) dict->id = 1;
+
+      if ( codec_ == Zstd ) {
+         std::lock_guard<std::mutex> lock(ctxMtx_);
+         dict->cdict = ZSTD_createCDict(dict->data.data(),dict->data.size(),level_);
+      }
+
+      log_->info("Loaded %lu byte dictionary from %s",dict->data.size(),file.c_str());
+   }
+
+   std::lock_guard<std::mutex> lock(ctxMtx_);
+   dict_ = dict;
+   gen_++;
+}
+
+//! Set number of worker threads, 0 compresses in the caller's thread
+void ru::StreamCompress::setWorkers(uint32_t count) {
+   rogue::GilRelease noGil;
+
+   // Hold the lock so no frame is dispatched while workers change
+   std::lock_guard<std::mutex> lock(mtx_);
+   workers_.start(count, "StreamCompress", &ru::StreamCompress::runWorker, this);
+}
+
+//! Get number of worker threads
+uint32_t ru::StreamCompress::getWorkers() {
+   return(workers_.count());
+}
+
+//! Get number of bytes received
+uint64_t ru::StreamCompress::getInBytes() {
+   return(inBytes_);
+}
+
+//! Get number of bytes sent
+uint64_t ru::StreamCompress::getOutBytes() {
+   return(outBytes_);
+}
+
+// Worker thread
+void ru::StreamCompress::runWorker() {
+   ru::StreamCompress::Context * ctx;
+   ris::FramePtr frame;
+   ris::FramePtr newFrame;
+   uint64_t index;
+
+   while ( workers_.pop(frame,index) ) {
+      newFrame.reset();
+
+      // Compress outside of the ordering lock
+      ctx = getContext();
+      try {
+         newFrame = compress(ctx,frame);
+      } catch (rogue::GeneralError & e) {
+         log_->error("%s",e.what());
+      }
+      putContext(ctx);
+      frame.reset();
+
+      // Wait for earlier frames to be sent
+      workers_.wait(index);
+      if ( newFrame ) sendFrame(newFrame);
+      workers_.done(index);
+   }
+}
+
+//! Get a context from the pool
+ru::StreamCompress::Context * ru::StreamCompress::getContext() {
+   ru::StreamCompress::Context * ctx;
+
+   std::lock_guard<std::mutex> lock(ctxMtx_);
+
+   while ( ! free_.empty() ) {
+      ctx = free_.back();
+      free_.pop_back();
+
+      if ( ctx->gen == gen_ ) return(ctx);
+      delete ctx;
+   }
+
+   ctx = new ru::StreamCompress::Context();
+   ctx->gen  = gen_;
+   ctx->dict = dict_;
+
+   if ( codec_ == Zstd ) {
+      ctx->zstd = ZSTD_createCCtx();
+
+      // Parameters are kept across frames
+      if ( ctx->dict ) ZSTD_CCtx_refCDict(ctx->zstd,ctx->dict->cdict);
+      else ZSTD_CCtx_setParameter(ctx->zstd,ZSTD_c_compressionLevel,level_);
+   }
+   else {
+      ctx->lz4 = LZ4_createStream();
+
+      // Dictionary is loaded once, the loaded state is copied for each frame
+      if ( ctx->dict ) {
+         ctx->lz4Dict = LZ4_createStream();
+         LZ4_loadDict(ctx->lz4Dict,(const char *)ctx->dict->data.data(),ctx->dict->data.size());
+      }
+   }
+   return(ctx);
+}
+
+//! Return a context to the pool
+void ru::StreamCompress::putContext(ru::StreamCompress::Context * ctx) {
+   std::lock_guard<std::mutex> lock(ctxMtx_);
+   free_.push_back(ctx);
+}
+
+//! Compress a frame
+ris::FramePtr ru::StreamCompress::compress ( ru::StreamCompress::Context * ctx, ris::FramePtr frame ) {
+   ris::FrameIterator iter;
+   ris::FramePtr newFrame;
+   const uint8_t * src;
+   uint8_t * dst;
+   uint32_t size;
+   uint32_t bound;
+   uint32_t nSize;
+   uint32_t header[3];
+   size_t ret;
+   int32_t accel;
+
+   ris::FrameLockPtr lock = frame->lock();
+
+   size = frame->getPayload();
+
+   // Frames spanning buffers are gathered into the scratch buffer
+   if ( frame->bufferCount() == 1 ) src = (*frame->beginBuffer())->begin();
+   else {
+      if ( ctx->in.size() < size ) ctx->in.resize(size);
+      if ( size > 0 ) {
+         iter = frame->begin();
+         ris::fromFrame(iter,size,ctx->in.data());
+      }
+      src = ctx->in.data();
+   }
+
+   if ( codec_ == Zstd ) bound = ZSTD_compressBound(size);
+   else bound = Lz4Header + LZ4_compressBound(size);
+
+   newFrame = reqFrame(bound,true);
+
+   // Compress directly into the new frame when its first buffer is large enough
+   if ( (*newFrame->beginBuffer())->getAvailable() >= bound ) dst = (*newFrame->beginBuffer())->begin();
+   else {
+      if ( ctx->out.size() < bound ) ctx->out.resize(bound);
+      dst = ctx->out.data();
+   }
+
+   if ( codec_ == Zstd ) {
+      ret = ZSTD_compress2(ctx->zstd,dst,bound,src,size);
+
+      if ( ZSTD_isError(ret) )
+         throw(rogue::GeneralError::create("StreamCompress::compress","Zstd compression error: %s",ZSTD_getErrorName(ret)));
+
+      nSize = ret;
+   }
+   else {
+      accel = (level_ < 1) ? 1 : level_;
+
+      // Each frame is a new stream, starting from the dictionary when one is loaded
+      if ( ctx->lz4Dict ) memcpy(ctx->lz4,ctx->lz4Dict,sizeof(LZ4_stream_t));
+      else LZ4_resetStream_fast(ctx->lz4);
+
+      ret = LZ4_compress_fast_continue(ctx->lz4,(const char *)src,(char *)dst+Lz4Header,size,bound-Lz4Header,accel);
+
+      if ( size > 0 && ret == 0 )
+         throw(rogue::GeneralError::create("StreamCompress::compress","LZ4 compression error"));
+
+      header[0] = Lz4Magic;
+      header[1] = size;
+      header[2] = ctx->lz4Dict ? ctx->dict->id : 0;
+      memcpy(dst,header,Lz4Header);
+
+      nSize = Lz4Header + ret;
+   }
+
+   // Copy from the scratch buffer
+   newFrame->setPayload(nSize);
+   if ( nSize > 0 && dst == ctx->out.data() ) {
+      iter = newFrame->begin();
+      ris::toFrame(iter,nSize,dst);
+   }
+
+   // Update output frame
+   newFrame->setError(frame->getError());
+   newFrame->setChannel(frame->getChannel());
+   newFrame->setFlags(frame->getFlags());
+
+   inBytes_  += size;
+   outBytes_ += nSize;
+
+   return(newFrame);
+}
+
+//! Accept a frame from master
+void ru::StreamCompress::acceptFrame ( ris::FramePtr frame ) {
+   ru::StreamCompress::Context * ctx;
+   ris::FramePtr newFrame;
+
+   rogue::GilRelease noGil;
+   std::unique_lock<std::mutex> lock(mtx_);
+
+   // Compress in the caller's thread
+   if ( ! workers_.active() ) {
+      lock.unlock();
+
+      ctx = getContext();
+      try {
+         newFrame = compress(ctx,frame);
+      } catch (...) {
+         putContext(ctx);
+         throw;
+      }
+      putContext(ctx);
+
+      this->sendFrame(newFrame);
+      return;
+   }
+
+   // Dispatch to the worker pool
+   workers_.push(frame,true);
+}
+
+//! Accept a new frame request. Forward request.
+ris::FramePtr ru::StreamCompress::acceptReq ( uint32_t size, bool zeroCopyEn ) {
+   return(this->reqFrame(size,zeroCopyEn));
+}
+
+void ru::StreamCompress::setup_python() {
+#ifndef NO_PYTHON
+
+   bp::class_<ru::StreamCompress, ru::StreamCompressPtr, bp::bases<ris::Master,ris::Slave>, boost::noncopyable >
+      cls("StreamCompress",bp::init<uint32_t, bp::optional<int32_t>>());
+
+   cls.def("setLevel",      &ru::StreamCompress::setLevel)
+      .def("getLevel",      &ru::StreamCompress::getLevel)
+      .def("setDictionary", &ru::StreamCompress::setDictionary)
+      .def("setWorkers",    &ru::StreamCompress::setWorkers)
+      .def("getWorkers",    &ru::StreamCompress::getWorkers)
+      .def("getInBytes",    &ru::StreamCompress::getInBytes)
+      .def("getOutBytes",   &ru::StreamCompress::getOutBytes)
+   ;
+
+   cls.attr("Lz4")  = (uint32_t)ru::StreamCompress::Lz4;
+   cls.attr("Zstd") = (uint32_t)ru::StreamCompress::Zstd;
+
+   bp::implicitly_convertible<ru::StreamCompressPtr, ris::SlavePtr>();
+   bp::implicitly_convertible<ru::StreamCompressPtr, ris::MasterPtr>();
+#endif
+}
+
@@ -0,0 +1,366 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title         : Rogue stream decompressor, LZ4 and Zstd
+ * ----------------------------------------------------------------------------
+ * File          : StreamDecompress.cpp
+ *-----------------------------------------------------------------------------
+ * Description :
+ *    Stream module to decompress a data stream compressed by StreamCompress
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#include <unistd.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <rogue/interfaces/stream/Slave.h>
+#include <rogue/interfaces/stream/Master.h>
+#include <rogue/interfaces/stream/Frame.h>
+#include <rogue/interfaces/stream/FrameLock.h>
+#include <rogue/interfaces/stream/FrameIterator.h>
+#include <rogue/interfaces/stream/Buffer.h>
+#include <rogue/utilities/StreamDecompress.h>
+#include <rogue/utilities/StreamCompress.h>
+#include <rogue/utilities/Crc32.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <memory>
+#include <lz4.h>
+#include <zstd.h>
+
+namespace ris = rogue::interfaces::stream;
+namespace ru  = rogue::utilities;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp = boost::python;
+#endif
+
+//! Dictionary, shared by the contexts created while it is current
+struct ru::StreamDecompress::Dict {
+   std::vector<uint8_t> data;
+   ZSTD_DDict * ddict;
+   uint32_t id;
+
+   Dict() : ddict(NULL), id(0) { }
+   ~Dict() { ZSTD_freeDDict(ddict); }
+};
+
+//! Decompression context
+struct ru::StreamDecompress::Context {
+   uint32_t gen;
+
+   // Dictionary is held until the context is discarded
+   std::shared_ptr<ru::StreamDecompress::Dict> dict;
+
+   // Zstd context
+   ZSTD_DCtx * zstd;
+
+   // Scratch buffers for frames which span buffers
+   std::vector<uint8_t> in;
+   std::vector<uint8_t> out;
+
+   Context() : gen(0), zstd(NULL) { }
+   ~Context() { ZSTD_freeDCtx(zstd); }
+};
+
+//! Class creation
+ru::StreamDecompressPtr ru::StreamDecompress::create () {
+   ru::StreamDecompressPtr p = std::make_shared<ru::StreamDecompress>();
+   return(p);
+}
+
+//! Creator
+ru::StreamDecompress::StreamDecompress() : ris::Slave(), ris::Master() {
+   log_ = rogue::Logging::create("utilities.StreamDecompress");
+
+   gen_         = 1;
+   maxSize_     = DefaultMaxSize;
+}
+
+//! Deconstructor
+ru::StreamDecompress::~StreamDecompress() {
+   uint32_t x;
+
+   rogue::GilRelease noGil;
+   workers_.stop();
+
+   for (x=0; x < free_.size(); x++) delete free_[x];
+}
+
+//! Load a dictionary file, an empty name disables the dictionary
+void ru::StreamDecompress::setDictionary(std::string file) {
+   std::shared_ptr<ru::StreamDecompress::Dict> dict;
+
+   rogue::GilRelease noGil;
+
+   if ( file != "" ) {
+      std::ifstream ifs(file.c_str(), std::ios::binary);
+
+      if ( ! ifs.is_open() )
+         throw(rogue::GeneralError::create("StreamDecompress::setDictionary","Failed to open dictionary file: %s",file.c_str()));
+
+      dict = std::make_shared<ru::StreamDecompress::Dict>();
+      dict->data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+      if ( dict->data.size() == 0 )
+         throw(rogue::GeneralError::create("StreamDecompress::setDictionary","Dictionary file is empty: %s",file.c_str()));
+
+      // Must match the id written by StreamCompress
+      dict->id = ru::Crc32::compute(dict->data.data(),dict->data.size());
+      if ( dict->id == 0 ) dict->id = 1;
+
+      dict->ddict = ZSTD_createDDict(dict->data.data(),dict->data.size());
+
+      log_->info("Loaded %lu byte dictionary from %s",dict->data.size(),file.c_str());
+   }
+
+   std::lock_guard<std::mutex> lock(ctxMtx_);
+   dict_ = dict;
+   gen_++;
+}
+
+//! Set number of worker threads, 0 decompresses in the caller's thread
+void ru::StreamDecompress::setWorkers(uint32_t count) {
+   rogue::GilRelease noGil;
+
+   // Hold the lock so no frame is dispatched while workers change
+   std::lock_guard<std::mutex> lock(mtx_);
+   workers_.start(count, "StreamDecomp", &ru::StreamDecompress::runWorker, this);
+}
+
+//! Get number of worker threads
+uint32_t ru::StreamDecompress::getWorkers() {
+   return(workers_.count());
+}
+
+//! Set max decompressed frame size in bytes, larger frames are rejected
+void ru::StreamDecompress::setMaxSize(uint32_t size) {
+   maxSize_ = size;
+}
+
+//! Get max decompressed frame size in bytes
+uint32_t ru::StreamDecompress::getMaxSize() {
+   return(maxSize_);
+}
+
+// Worker thread
+void ru::StreamDecompress::runWorker() {
+   ru::StreamDecompress::Context * ctx;
+   ris::FramePtr frame;
+   ris::FramePtr newFrame;
+   uint64_t index;
+
+   while ( workers_.pop(frame,index) ) {
+      newFrame.reset();
+
+      // Decompress outside of the ordering lock
+      ctx = getContext();
+      try {
+         newFrame = decompress(ctx,frame);
+      } catch (rogue::GeneralError & e) {
+         log_->error("%s",e.what());
+      }
+      putContext(ctx);
+      frame.reset();
+
+      // Wait for earlier frames to be sent
+      workers_.wait(index);
+      if ( newFrame ) sendFrame(newFrame);
+      workers_.done(index);
+   }
+}
+
+//! Get a context from the pool
+ru::StreamDecompress::Context * ru::StreamDecompress::getContext() {
+   ru::StreamDecompress::Context * ctx;
+
+   std::lock_guard<std::mutex> lock(ctxMtx_);
+
+   while ( ! free_.empty() ) {
+      ctx = free_.back();
+      free_.pop_back();
+
+      if ( ctx->gen == gen_ ) return(ctx);
+      delete ctx;
+   }
+
+   ctx = new ru::StreamDecompress::Context();
+   ctx->gen  = gen_;
+   ctx->dict = dict_;
+   ctx->zstd = ZSTD_createDCtx();
+
+   // Dictionary reference is kept across frames
+   if ( ctx->dict ) ZSTD_DCtx_refDDict(ctx->zstd,ctx->dict->ddict);
+
+   return(ctx);
+}
+
+//! Return a context to the pool
+void ru::StreamDecompress::putContext(ru::StreamDecompress::Context * ctx) {
+   std::lock_guard<std::mutex> lock(ctxMtx_);
+   free_.push_back(ctx);
+}
+
+//! Decompress a frame
+ris::FramePtr ru::StreamDecompress::decompress ( ru::StreamDecompress::Context * ctx, ris::FramePtr frame ) {
+   ris::FrameIterator iter;
+   ris::FramePtr newFrame;
+   const uint8_t * src;
+   uint8_t * dst;
+   unsigned long long cSize;
+   uint32_t size;
+   uint32_t nSize;
+   uint32_t header[3];
+   uint32_t dictId;
+   size_t ret;
+   int32_t lRet;
+   bool zstd;
+
+   ris::FrameLockPtr lock = frame->lock();
+
+   size = frame->getPayload();
+
+   // Frames spanning buffers are gathered into the scratch buffer
+   if ( frame->bufferCount() == 1 ) src = (*frame->beginBuffer())->begin();
+   else {
+      if ( ctx->in.size() < size ) ctx->in.resize(size);
+      if ( size > 0 ) {
+         iter = frame->begin();
+         ris::fromFrame(iter,size,ctx->in.data());
+      }
+      src = ctx->in.data();
+   }
+
+   // Detect codec and get the uncompressed size
+   if ( size >= ru::StreamCompress::Lz4Header ) memcpy(header,src,ru::StreamCompress::Lz4Header);
+   else memset(header,0,sizeof(header));
+
+   if ( header[0] == ru::StreamCompress::Lz4Magic ) {
+      if ( size <= ru::StreamCompress::Lz4Header )
+         throw(rogue::GeneralError::create("StreamDecompress::decompress","LZ4 frame has no payload. Size=%i",size));
+
+      zstd  = false;
+      nSize = header[1];
+
+      dictId = ctx->dict ? ctx->dict->id : 0;
+      if ( header[2] != dictId )
+         throw(rogue::GeneralError::create("StreamDecompress::decompress",
+                  "LZ4 dictionary mismatch. Frame=0x%08x, Loaded=0x%08x",header[2],dictId));
+   }
+   else {
+      cSize = ZSTD_getFrameContentSize(src,size);
+
+      if ( cSize == ZSTD_CONTENTSIZE_ERROR || cSize == ZSTD_CONTENTSIZE_UNKNOWN || cSize > 0xFFFFFFFF )
+         throw(rogue::GeneralError::create("StreamDecompress::decompress","Unknown frame format"));
+
+      zstd  = true;
+      nSize = cSize;
+   }
+
+   // Size comes from the frame and is not trusted
+   if ( nSize > maxSize_ )
+      throw(rogue::GeneralError::create("StreamDecompress::decompress",
+               "Decompressed size %i exceeds max size %i",nSize,maxSize_.load()));
+
+   newFrame = reqFrame(nSize,true);
+
+   // Decompress directly into the new frame when its first buffer is large enough
+   if ( nSize > 0 && (*newFrame->beginBuffer())->getAvailable() >= nSize ) dst = (*newFrame->beginBuffer())->begin();
+   else {
+      if ( ctx->out.size() < nSize ) ctx->out.resize(nSize);
+      dst = ctx->out.data();
+   }
+
+   if ( zstd ) {
+      ret = ZSTD_decompressDCtx(ctx->zstd,dst,nSize,src,size);
+
+      if ( ZSTD_isError(ret) )
+         throw(rogue::GeneralError::create("StreamDecompress::decompress","Zstd decompression error: %s",ZSTD_getErrorName(ret)));
+   }
+   else {
+      if ( ctx->dict )
+         lRet = LZ4_decompress_safe_usingDict((const char *)src + ru::StreamCompress::Lz4Header, (char *)dst,
+                                              size - ru::StreamCompress::Lz4Header, nSize,
+                                              (const char *)ctx->dict->data.data(), ctx->dict->data.size());
+      else
+         lRet = LZ4_decompress_safe((const char *)src + ru::StreamCompress::Lz4Header, (char *)dst,
+                                    size - ru::StreamCompress::Lz4Header, nSize);
+
+      if ( lRet < 0 || (uint32_t)lRet != nSize )
+         throw(rogue::GeneralError::create("StreamDecompress::decompress","LZ4 decompression error %i",lRet));
+   }
+
+   // Copy from the scratch buffer
+   newFrame->setPayload(nSize);
+   if ( nSize > 0 && dst == ctx->out.data() ) {
+      iter = newFrame->begin();
+      ris::toFrame(iter,nSize,dst);
+   }
+
+   // Update output frame
+   newFrame->setError(frame->getError());
+   newFrame->setChannel(frame->getChannel());
+   newFrame->setFlags(frame->getFlags());
+
+   return(newFrame);
+}
+
+//! Accept a frame from master
+void ru::StreamDecompress::acceptFrame ( ris::FramePtr frame ) {
+   ru::StreamDecompress::Context * ctx;
+   ris::FramePtr newFrame;
+
+   rogue::GilRelease noGil;
+   std::unique_lock<std::mutex> lock(mtx_);
+
+   // Decompress in the caller's thread
+   if ( ! workers_.active() ) {
+      lock.unlock();
+
+      ctx = getContext();
+      try {
+         newFrame = decompress(ctx,frame);
+      } catch (...) {
+         putContext(ctx);
+         throw;
+      }
+      putContext(ctx);
+
+      this->sendFrame(newFrame);
+      return;
+   }
+
+   // Dispatch to the worker pool
+   workers_.push(frame,true);
+}
+
+//! Accept a new frame request. Forward request.
+ris::FramePtr ru::StreamDecompress::acceptReq ( uint32_t size, bool zeroCopyEn ) {
+   return(this->reqFrame(size,zeroCopyEn));
+}
+
+void ru::StreamDecompress::setup_python() {
+#ifndef NO_PYTHON
+
+   bp::class_<ru::StreamDecompress, ru::StreamDecompressPtr, bp::bases<ris::Master,ris::Slave>, boost::noncopyable >("StreamDecompress",bp::init<>())
+      .def("setDictionary", &ru::StreamDecompress::setDictionary)
+      .def("setWorkers",    &ru::StreamDecompress::setWorkers)
+      .def("getWorkers",    &ru::StreamDecompress::getWorkers)
+      .def("setMaxSize",    &ru::StreamDecompress::setMaxSize)
+      .def("getMaxSize",    &ru::StreamDecompress::getMaxSize)
+   ;
+
+   bp::implicitly_convertible<ru::StreamDecompressPtr, ris::SlavePtr>();
+   bp::implicitly_convertible<ru::StreamDecompressPtr, ris::MasterPtr>();
+#endif
+}
+
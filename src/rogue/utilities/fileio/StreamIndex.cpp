@@ -0,0 +1,250 @@
+/**
+ *-----------------------------------------------------------------------------
+ * Title         : Data file index
+ *-----------------------------------------------------------------------------
+ * Description :
+ *    Sidecar index for data files written by StreamWriter, see StreamIndex.h
+ *    for the format.
+ *-----------------------------------------------------------------------------
+ * This file is part of the rogue software platform. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+    * https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the rogue software platform, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ *-----------------------------------------------------------------------------
+**/
+#include <rogue/utilities/fileio/StreamIndex.h>
+#include <rogue/GeneralError.h>
+#include <rogue/GilRelease.h>
+#include <rogue/Logging.h>
+#include <stdint.h>
+#include <memory>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace ruf = rogue::utilities::fileio;
+
+#ifndef NO_PYTHON
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/python.hpp>
+namespace bp = boost::python;
+#endif
+
+//! Class creation
+ruf::StreamIndexPtr ruf::StreamIndex::create () {
+   ruf::StreamIndexPtr s = std::make_shared<ruf::StreamIndex>();
+   return(s);
+}
+
+//! Setup class in python
+void ruf::StreamIndex::setup_python() {
+#ifndef NO_PYTHON
+   bp::class_<ruf::StreamIndex, ruf::StreamIndexPtr, boost::noncopyable >("StreamIndex",bp::init<>())
+      .def("load",           &ruf::StreamIndex::load)
+      .def("getCount",       &ruf::StreamIndex::getCount)
+      .def("getEntry",       &ruf::StreamIndex::getEntryPy)
+      .def("find",           &ruf::StreamIndex::find)
+      .def("rebuild",        &ruf::StreamIndex::rebuild)
+      .staticmethod("rebuild")
+      .def("indexName",      &ruf::StreamIndex::indexName)
+      .staticmethod("indexName")
+   ;
+#endif
+}
+
+//! Creator
+ruf::StreamIndex::StreamIndex() { }
+
+//! Get the base name and first file index for a data file name
+std::string ruf::StreamIndex::baseName(std::string file, uint32_t & idx) {
+   size_t pos = file.find_last_of(".");
+
+   // Split data sets start at <base>.1
+   if ( pos != std::string::npos && file.substr(pos) == ".1" ) {
+      idx = 1;
+      return(file.substr(0,pos));
+   }
+
+   idx = 0;
+   return(file);
+}
+
+//! Get the data file name for a base name and file index
+std::string ruf::StreamIndex::fileName(std::string base, uint32_t idx) {
+   if ( idx == 0 ) return(base);
+   return(base + "." + std::to_string(idx));
+}
+
+//! Get the index file name for a data file name
+std::string ruf::StreamIndex::indexName(std::string file) {
+   uint32_t idx;
+   return(baseName(file,idx) + ".idx");
+}
+
+//! Write the index file header
+bool ruf::StreamIndex::writeHeader(int32_t fd) {
+   uint32_t header[2];
+
+   header[0] = Magic;
+   header[1] = Version;
+   return(write(fd,header,8) == 8);
+}
+
+//! Scan data files and write a new index, returns the number of frames
+uint64_t ruf::StreamIndex::rebuild(std::string file) {
+   std::vector<ruf::StreamIndex::Entry> entries;
+   ruf::StreamIndex::Entry entry;
+   struct stat st;
+   std::string base;
+   std::string name;
+   uint32_t header[2];
+   uint64_t frame;
+   uint64_t offset;
+   uint32_t idx;
+   int32_t  fd;
+   int32_t  ifd;
+   bool     done;
+
+   Logging log("fileio.StreamIndex");
+   rogue::GilRelease noGil;
+
+   base = baseName(file,idx);
+   name = base + ".idx";
+
+   if ( (ifd = ::open(name.c_str(),O_WRONLY|O_CREAT|O_TRUNC,S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH)) < 0 )
+      throw(rogue::GeneralError::create("StreamIndex::rebuild","Failed to open index file: %s",name.c_str()));
+
+   if ( ! writeHeader(ifd) ) {
+      ::close(ifd);
+      throw(rogue::GeneralError::create("StreamIndex::rebuild","Failed to write index file: %s",name.c_str()));
+   }
+
+   frame = 0;
+   done  = false;
+
+   // Scan each file in the data set, reading only the frame headers
+   do {
+      name = fileName(base,idx);
+
+      if ( (fd = ::open(name.c_str(),O_RDONLY)) < 0 ) {
+         if ( frame == 0 ) {
+            ::close(ifd);
+            throw(rogue::GeneralError::create("StreamIndex::rebuild","Failed to open data file: %s",name.c_str()));
+         }
+         break;
+      }
+
+      fstat(fd,&st);
+      offset = 0;
+
+      while ( pread(fd,header,8,offset) == 8 ) {
+         if ( header[0] < 4 || (offset + 4 + header[0]) > (uint64_t)st.st_size ) {
+            log.warning("Truncated frame at offset %lu in %s",offset,name.c_str());
+            done = true;
+            break;
+         }
+
+         entry.frame    = frame++;
+         entry.offset   = offset;
+         entry.size     = header[0];
+         entry.meta     = header[1];
+         entry.file     = idx;
+         entry.time     = 0;
+         entries.push_back(entry);
+
+         offset += 4 + header[0];
+
+         if ( entries.size() == 4096 ) {
+            if ( write(ifd,entries.data(),entries.size()*sizeof(Entry)) != (ssize_t)(entries.size()*sizeof(Entry)) ) {
+               ::close(fd);
+               ::close(ifd);
+               throw(rogue::GeneralError::create("StreamIndex::rebuild","Failed to write index for %s",file.c_str()));
+            }
+            entries.clear();
+         }
+      }
+      ::close(fd);
+
+   } while ( (! done) && (idx++ > 0) );
+
+   if ( write(ifd,entries.data(),entries.size()*sizeof(Entry)) != (ssize_t)(entries.size()*sizeof(Entry)) ) {
+      ::close(ifd);
+      throw(rogue::GeneralError::create("StreamIndex::rebuild","Failed to write index for %s",file.c_str()));
+   }
+   ::close(ifd);
+
+   log.info("Indexed %lu frames in %s",frame,base.c_str());
+   return(frame);
+}
+
+//! Load the index for a data file, returns false if there is no valid index
+bool ruf::StreamIndex::load(std::string file) {
+   struct stat st;
+   std::string name;
+   uint32_t header[2];
+   uint64_t count;
+   int32_t  fd;
+
+   rogue::GilRelease noGil;
+   entries_.clear();
+
+   name = indexName(file);
+   if ( (fd = ::open(name.c_str(),O_RDONLY)) < 0 ) return(false);
+
+   if ( fstat(fd,&st) != 0 || read(fd,header,8) != 8 || header[0] != Magic || header[1] != Version ) {
+      ::close(fd);
+      return(false);
+   }
+
+   // A partial entry at the end is from a writer which is still running
+   count = (st.st_size - 8) / sizeof(Entry);
+   entries_.resize(count);
+
+   if ( read(fd,entries_.data(),count*sizeof(Entry)) != (ssize_t)(count*sizeof(Entry)) ) {
+      entries_.clear();
+      ::close(fd);
+      return(false);
+   }
+
+   ::close(fd);
+   return(true);
+}
+
+//! Get number of entries
+uint64_t ruf::StreamIndex::getCount() {
+   return(entries_.size());
+}
+
+//! Get an entry
+const ruf::StreamIndex::Entry & ruf::StreamIndex::entry(uint64_t pos) {
+   if ( pos >= entries_.size() )
+      throw(rogue::GeneralError::create("StreamIndex::entry","Entry %lu is out of range",pos));
+   return(entries_[pos]);
+}
+
+//! Get position of the first entry at or after a frame number
+uint64_t ruf::StreamIndex::find(uint64_t frame) {
+   std::vector<ruf::StreamIndex::Entry>::iterator it;
+
+   it = std::lower_bound(entries_.begin(), entries_.end(), frame,
+         [](const ruf::StreamIndex::Entry & e, uint64_t f) { return e.frame < f; });
+
+   return(it - entries_.begin());
+}
+
+#ifndef NO_PYTHON
+
+//! Get an entry as (frame, channel, file, offset, size, flags, error)
+bp::tuple ruf::StreamIndex::getEntryPy(uint64_t pos) {
+   const ruf::StreamIndex::Entry & e = entry(pos);
+
+   return(bp::make_tuple(e.frame, (e.meta >> 24) & 0xFF, e.file, e.offset,
+                         e.size - 4, e.meta & 0xFFFF, (e.meta >> 16) & 0xFF));
+}
+
+#endif
+
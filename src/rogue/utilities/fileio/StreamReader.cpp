@@ -20,6 +20,7 @@
  *-----------------------------------------------------------------------------
 **/
 #include <rogue/utilities/fileio/StreamReader.h>
+#include <rogue/utilities/fileio/StreamIndex.h>
 #include <rogue/interfaces/stream/Frame.h>
 #include <rogue/interfaces/stream/Buffer.h>
 #include <rogue/interfaces/stream/FrameIterator.h>
@@ -31,6 +32,9 @@
 #include <memory>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string.h>
 
 namespace ris = rogue::interfaces::stream;
 namespace ruf = rogue::utilities::fileio;
@@ -50,12 +54,25 @@ ruf::StreamReaderPtr ruf::StreamReader::create () {
 //! Setup class in python
 void ruf::StreamReader::setup_python() {
 #ifndef NO_PYTHON
-   bp::class_<ruf::StreamReader, ruf::StreamReaderPtr,bp::bases<ris::Master>, boost::noncopyable >("StreamReader",bp::init<>())
+   bp::class_<ruf::StreamReader, ruf::StreamReaderPtr,bp::bases<ris::Master,ris::Pool>, boost::noncopyable >("StreamReader",bp::init<>())
       .def("open",           &ruf::StreamReader::open)
       .def("close",          &ruf::StreamReader::close)
       .def("isOpen",         &ruf::StreamReader::isOpen)
       .def("closeWait",      &ruf::StreamReader::closeWait)
       .def("isActive",       &ruf::StreamReader::isActive)
+      .def("setRange",       &ruf::StreamReader::setRange)
+      .def("seek",           &ruf::StreamReader::seek)
+      .def("filterChannel",  &ruf::StreamReader::filterChannel)
+      .def("clearFilter",    &ruf::StreamReader::clearFilter)
+      .def("getIndexCount",  &ruf::StreamReader::getIndexCount)
+      .def("setMapped",      &ruf::StreamReader::setMapped)
+      .def("setRate",        &ruf::StreamReader::setRate)
+      .def("setTiming",      &ruf::StreamReader::setTiming)
+      .def("setPrefetchDepth",   &ruf::StreamReader::setPrefetchDepth)
+      .def("getPrefetchDepth",   &ruf::StreamReader::getPrefetchDepth)
+      .def("setPrefetchThreads", &ruf::StreamReader::setPrefetchThreads)
+      .def("getPrefetchThreads", &ruf::StreamReader::getPrefetchThreads)
+      .def("getPrefetchBytes",   &ruf::StreamReader::getPrefetchBytes)
    ;
 #endif
 }
@@ -64,7 +81,24 @@ void ruf::StreamReader::setup_python() {
 ruf::StreamReader::StreamReader() {
    baseName_   = "";
    readThread_ = NULL;
+   threadEn_   = false;
    active_     = false;
+   fd_         = -1;
+   fdIdx_      = 0;
+   firstIdx_   = 0;
+   start_      = 0;
+   end_        = 0;
+   filterEn_   = false;
+   mapped_     = false;
+   rate_       = 0;
+   timing_     = 0;
+   index_      = ruf::StreamIndex::create();
+
+   prefetchDepth_   = 0;
+   prefetchThreads_ = 1;
+   prefetchNext_    = 0;
+   prefetchEnd_     = true;
+   prefetchBytes_   = 0;
 }
 
 //! Deconstructor
@@ -79,20 +113,27 @@ void ruf::StreamReader::open(std::string file) {
    intClose();
 
    // Determine if we read a group of files
-   if ( file.substr(file.find_last_of(".")) == ".1" ) {
-      fdIdx_ = 1;
-      baseName_ = file.substr(0,file.find_last_of("."));
-   }
-   else {
-      fdIdx_ = 0;
-      baseName_ = file;
-   }
+   baseName_ = ruf::StreamIndex::baseName(file,firstIdx_);
+
+   // Sidecar index is optional
+   index_->load(file);
 
-   if ( (fd_ = ::open(file.c_str(),O_RDONLY)) < 0 )
-      throw(rogue::GeneralError::create("StreamReader::open","Failed to open data file: %s",file.c_str()));
+   intStart();
+}
+
+//! Open first file and start read thread
+void ruf::StreamReader::intStart() {
+   std::string name;
+
+   fdIdx_ = firstIdx_;
+   name   = ruf::StreamIndex::fileName(baseName_,fdIdx_);
+
+   if ( (fd_ = ::open(name.c_str(),O_RDONLY)) < 0 )
+      throw(rogue::GeneralError::create("StreamReader::open","Failed to open data file: %s",name.c_str()));
 
    active_ = true;
    threadEn_ = true;
+   startPrefetch();
    readThread_ = new std::thread(&StreamReader::runThread, this);
 
    // Set a thread name
@@ -117,6 +158,7 @@ bool ruf::StreamReader::nextFile() {
    name = baseName_ + "." + std::to_string(fdIdx_);
 
    if ( (fd_ = ::open(name.c_str(),O_RDONLY)) < 0 ) return(false);
+   prefetch(fdIdx_);
    return(true);
 }
 
@@ -136,11 +178,18 @@ bool ruf::StreamReader::isOpen() {
 void ruf::StreamReader::intClose() {
    if ( readThread_ != NULL ) {
       threadEn_ = false;
+
+      // Thread takes the lock when it exits
+      mtx_.unlock();
       readThread_->join();
+      stopPrefetch();
+      mtx_.lock();
+
       delete readThread_;
       readThread_ = NULL;
    }
    if ( fd_ >= 0 ) ::close(fd_);
+   fd_ = -1;
 }
 
 //! Close when done
@@ -157,83 +206,556 @@ bool ruf::StreamReader::isActive() {
    return (active_);
 }
 
+//! Set frame range for the next open or seek, zero count reads to the end
+void ruf::StreamReader::setRange(uint64_t first, uint64_t count) {
+   start_ = first;
+   end_   = (count == 0) ? 0 : first + count;
+}
+
+//! Restart reading at a frame number
+void ruf::StreamReader::seek(uint64_t frame) {
+   rogue::GilRelease noGil;
+   std::unique_lock<std::mutex> lock(mtx_);
+
+   if ( baseName_ == "" )
+      throw(rogue::GeneralError("StreamReader::seek","No file has been opened"));
+
+   intClose();
+   start_ = frame;
+   intStart();
+}
+
+//! Add a channel to the filter, only filtered channels are read
+void ruf::StreamReader::filterChannel(uint8_t channel) {
+   filter_.set(channel);
+   filterEn_ = true;
+}
+
+//! Clear the channel filter
+void ruf::StreamReader::clearFilter() {
+   filter_.reset();
+   filterEn_ = false;
+}
+
+//! Get number of frames in the index, zero when there is no index
+uint64_t ruf::StreamReader::getIndexCount() {
+   return(index_->getCount());
+}
+
+//! Emit frames referencing memory mapped files instead of copying
+void ruf::StreamReader::setMapped(bool mapped) {
+   mapped_ = mapped;
+}
+
+//! Set fixed replay rate in frames per second, zero to disable
+void ruf::StreamReader::setRate(double rate) {
+   rate_ = rate;
+}
+
+//! Set replay speed relative to the original timing in the index, zero to disable
+void ruf::StreamReader::setTiming(double speed) {
+   timing_ = speed;
+}
+
+//! Set number of files to prefetch beyond the current file, zero to disable
+void ruf::StreamReader::setPrefetchDepth(uint32_t depth) {
+   prefetchDepth_ = depth;
+}
+
+//! Get number of files to prefetch beyond the current file
+uint32_t ruf::StreamReader::getPrefetchDepth() {
+   return(prefetchDepth_);
+}
+
+//! Set number of prefetch threads
+void ruf::StreamReader::setPrefetchThreads(uint32_t count) {
+   if ( count == 0 )
+      throw(rogue::GeneralError("StreamReader::setPrefetchThreads","Thread count must be at least 1"));
+   prefetchThreads_ = count;
+}
+
+//! Get number of prefetch threads
+uint32_t ruf::StreamReader::getPrefetchThreads() {
+   return(prefetchThreads_);
+}
+
+//! Get number of bytes prefetched since the last open
+uint64_t ruf::StreamReader::getPrefetchBytes() {
+   return(prefetchBytes_);
+}
+
+//! Start prefetch threads, settings are applied when a file is opened
+void ruf::StreamReader::startPrefetch() {
+   std::thread * thread;
+   uint32_t x;
+
+   prefetchBytes_ = 0;
+   prefetchNext_  = fdIdx_;
+   prefetchEnd_   = (prefetchDepth_ == 0);
+
+   if ( prefetchEnd_ ) return;
+
+   prefetchQueue_ = std::make_shared<rogue::Queue<ruf::StreamReader::Prefetch>>();
+
+   for (x=0; x < prefetchThreads_; x++) {
+      thread = new std::thread(&ruf::StreamReader::runPrefetch, this);
+      prefetchWorkers_.push_back(thread);
+
+      // Set a thread name
+#ifndef __MACH__
+      pthread_setname_np( thread->native_handle(), "StreamPrefetch" );
+#endif
+   }
+}
+
+//! Stop prefetch threads
+void ruf::StreamReader::stopPrefetch() {
+   uint32_t x;
+
+   if ( prefetchQueue_ ) prefetchQueue_->stop();
+
+   for (x=0; x < prefetchWorkers_.size(); x++) {
+      prefetchWorkers_[x]->join();
+      delete prefetchWorkers_[x];
+   }
+   prefetchWorkers_.clear();
+   prefetchQueue_.reset();
+   prefetchEnd_ = true;
+}
+
+//! Queue files for prefetch up to the depth beyond a file
+void ruf::StreamReader::prefetch(uint32_t idx) {
+   ruf::StreamReader::Prefetch req;
+   struct stat st;
+   std::string name;
+
+   // Files before a seek are not needed
+   if ( prefetchNext_ < idx ) prefetchNext_ = idx;
+
+   while ( (! prefetchEnd_) && prefetchNext_ <= (idx + prefetchDepth_) ) {
+      name = ruf::StreamIndex::fileName(baseName_,prefetchNext_);
+
+      if ( stat(name.c_str(),&st) != 0 ) {
+         prefetchEnd_ = true;
+         break;
+      }
+
+      // Each file is split into requests so threads share large files
+      req.file  = prefetchNext_;
+      req.valid = true;
+
+      for (req.offset=0; req.offset < (uint64_t)st.st_size; req.offset += PrefetchSize) {
+         req.size = ((req.offset + PrefetchSize) > (uint64_t)st.st_size) ? (st.st_size - req.offset) : PrefetchSize;
+         prefetchQueue_->push(req);
+      }
+
+      // Un-split data set is a single file
+      if ( prefetchNext_++ == 0 ) prefetchEnd_ = true;
+   }
+}
+
+//! Prefetch thread, reads file data into the page cache ahead of the read thread
+void ruf::StreamReader::runPrefetch() {
+   std::shared_ptr<rogue::Queue<ruf::StreamReader::Prefetch>> queue;
+   ruf::StreamReader::Prefetch req;
+   std::string name;
+   uint8_t * buff;
+   uint64_t pos;
+   uint64_t len;
+   int32_t  fd;
+
+   queue = prefetchQueue_;
+
+   if ( (buff = (uint8_t *)malloc(PrefetchRead)) == NULL ) return;
+
+   // Pop returns an invalid request once the queue is stopped
+   while ( (req = queue->pop()).valid ) {
+      name = ruf::StreamIndex::fileName(baseName_,req.file);
+
+      if ( (fd = ::open(name.c_str(),O_RDONLY)) < 0 ) continue;
+
+      for (pos=0; threadEn_ && pos < req.size; pos += PrefetchRead) {
+         len = ((req.size - pos) > PrefetchRead) ? PrefetchRead : (req.size - pos);
+
+#ifdef __linux__
+         // Blocks until the range is in the page cache, without a copy
+         if ( readahead(fd,req.offset + pos,len) == 0 ) {
+            prefetchBytes_ += len;
+            continue;
+         }
+#endif
+         if ( pread(fd,buff,len,req.offset + pos) <= 0 ) break;
+         prefetchBytes_ += len;
+      }
+      ::close(fd);
+   }
+   free(buff);
+}
+
+//! Return a buffer, releasing mapped files for zero copy buffers
+void ruf::StreamReader::retBuffer(uint8_t * data, uint32_t meta, uint32_t size) {
+   std::shared_ptr<ruf::StreamReader::Mapping> map;
+
+   // Zero copy buffer as indicated by bit 31
+   if ( (meta & 0x80000000) != 0 ) {
+      rogue::GilRelease noGil;
+      {
+         std::lock_guard<std::mutex> lock(slotMtx_);
+         map.swap(slots_[meta & 0x7FFFFFFF]);
+         free_.push_back(meta & 0x7FFFFFFF);
+      }
+      decCounter(size);
+
+      // File is unmapped outside of the lock
+      map.reset();
+   }
+
+   // Buffer is allocated from Pool class
+   else ris::Pool::retBuffer(data,meta,size);
+}
+
 //! Thread background
 void ruf::StreamReader::runThread() {
-   int32_t  ret;
+   Logging log("streamReader");
+
+   frame_ = 0;
+   next_  = std::chrono::steady_clock::now();
+
+   // Index is only needed to skip frames, a full replay reads the files in order
+   if ( mapped_ ) readMapped(log);
+   else if ( index_->getCount() > 0 && (start_ > 0 || end_ > 0 || filterEn_) ) readIndex(log);
+   else {
+      prefetch(fdIdx_);
+      while ( readFiles(log) && threadEn_ && nextFile() );
+   }
+
+   std::unique_lock<std::mutex> lock(mtx_);
+   if ( fd_ >= 0 ) ::close(fd_);
+   fd_ = -1;
+   active_ = false;
+   cond_.notify_all();
+}
+
+//! Read frames sequentially from the current data file, returns false when done
+bool ruf::StreamReader::readFiles(rogue::Logging & log) {
    uint32_t size;
    uint32_t meta;
-   uint16_t flags;
-   uint8_t  error;
-   uint8_t  chan;
-   uint32_t bSize;
-   bool     err;
-   ris::FramePtr frame;
-   ris::Frame::BufferIterator it;
-   char * bData;
-   Logging log("streamReader");
+   uint64_t frame;
+
+   // Read size of each frame
+   while ( threadEn_ && (fd_ >= 0) && (read(fd_,&size,4) == 4) ) {
+      if ( size == 0 ) {
+         log.warning("Bad size read %i",size);
+         return(false);
+      }
+
+      // Read flags
+      if ( read(fd_,&meta, 4) != 4 ) {
+         log.warning("Failed to read flags");
+         return(false);
+      }
+      frame = frame_++;
+
+      // Past end of range
+      if ( end_ != 0 && frame >= end_ ) return(false);
+
+      // Skip next step if frame is empty
+      if ( size <= 4 ) continue;
+      size -= 4;
+
+      // Skip frames before the range or outside the channel filter without reading the data
+      if ( frame < start_ ) {
+         lseek(fd_,size,SEEK_CUR);
+         continue;
+      }
+      if ( filterEn_ && ! filter_.test((meta >> 24) & 0xFF) ) {
+         pace(frame,false);
+         lseek(fd_,size,SEEK_CUR);
+         continue;
+      }
+      pace(frame,true);
+
+      if ( ! readFrame(size,meta,log) ) return(false);
+   }
+   return(true);
+}
+
+//! Read frames located with the index
+void ruf::StreamReader::readIndex(rogue::Logging & log) {
+   std::string name;
+   uint64_t pos;
+
+   for (pos = index_->find(start_); threadEn_ && pos < index_->getCount(); pos++) {
+      const ruf::StreamIndex::Entry & entry = index_->entry(pos);
+
+      if ( end_ != 0 && entry.frame >= end_ ) break;
+      if ( entry.size <= 4 ) continue;
+
+      if ( filterEn_ && ! filter_.test((entry.meta >> 24) & 0xFF) ) {
+         pace(entry.frame,false);
+         continue;
+      }
+
+      // Switch to the file holding the frame
+      if ( entry.file != fdIdx_ || fd_ < 0 ) {
+         std::unique_lock<std::mutex> lock(mtx_);
+
+         if ( fd_ >= 0 ) ::close(fd_);
+         fdIdx_ = entry.file;
+         name   = ruf::StreamIndex::fileName(baseName_,fdIdx_);
+
+         if ( (fd_ = ::open(name.c_str(),O_RDONLY)) < 0 ) {
+            log.warning("Failed to open data file %s",name.c_str());
+            break;
+         }
+      }
+      prefetch(fdIdx_);
+
+      if ( lseek(fd_,entry.offset + 8,SEEK_SET) < 0 ) {
+         log.warning("Failed to seek to frame %lu",entry.frame);
+         break;
+      }
+
+      pace(entry.frame,true);
+      if ( ! readFrame(entry.size - 4,entry.meta,log) ) break;
+   }
+}
+
+//! Memory mapped file
+ruf::StreamReader::Mapping::Mapping(uint8_t * data, size_t size) {
+   this->data = data;
+   this->size = size;
+}
+
+//! Unmap file when the last frame referencing it is released
+ruf::StreamReader::Mapping::~Mapping() {
+   munmap(data,size);
+}
+
+//! Read frames from memory mapped data files
+void ruf::StreamReader::readMapped(rogue::Logging & log) {
+   std::shared_ptr<ruf::StreamReader::Mapping> map;
+   struct stat st;
+   std::string name;
+   uint64_t fSize;
+   uint64_t base;
+   uint64_t pos;
+   uint64_t ahead;
+   uint64_t frame;
+   uint64_t idx;
+   uint64_t len;
+   uint32_t size;
+   uint32_t meta;
+   uint8_t * data;
+   bool     done;
+
+   pos  = 0;
+   done = false;
+
+   // Start from the indexed position of the first frame
+   if ( start_ > 0 && (idx = index_->find(start_)) < index_->getCount() ) {
+      const ruf::StreamIndex::Entry & entry = index_->entry(idx);
+
+      if ( entry.file != fdIdx_ ) {
+         std::unique_lock<std::mutex> lock(mtx_);
+
+         ::close(fd_);
+         fdIdx_ = entry.file;
+         name   = ruf::StreamIndex::fileName(baseName_,fdIdx_);
+
+         if ( (fd_ = ::open(name.c_str(),O_RDONLY)) < 0 ) {
+            log.warning("Failed to open data file %s",name.c_str());
+            return;
+         }
+      }
+      pos    = entry.offset;
+      frame_ = entry.frame;
+   }
+   prefetch(fdIdx_);
 
-   ret = 0;
-   err = false;
    do {
+      if ( fstat(fd_,&st) != 0 ) break;
+      fSize = st.st_size;
+      base  = 0;
+      ahead = 0;
+
+      while ( threadEn_ && (pos + 8) <= fSize ) {
+
+         // Map a new window when the next frame header is outside the current one
+         if ( (! map) || (pos + 8) > (base + map->size) ) {
+            map.reset();
+            base = pos - (pos % sysconf(_SC_PAGESIZE));
+            len  = ((base + MapSize) > fSize) ? (fSize - base) : MapSize;
+
+            // Private mapping, pages written by a receiver are copied
+            if ( (data = (uint8_t *)mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd_,base)) == MAP_FAILED ) {
+               log.warning("Failed to map data file, index %i",fdIdx_);
+               done = true;
+               break;
+            }
+            map = std::make_shared<ruf::StreamReader::Mapping>(data,len);
+            madvise(data,len,MADV_SEQUENTIAL);
+            ahead = base;
+         }
 
-      // Read size of each frame
-      while ( (fd_ >= 0) && (read(fd_,&size,4) == 4) ) {
-         if ( size == 0 ) {
-            log.warning("Bad size read %i",size);
-            err = true;
+         std::memcpy(&size,map->data+(pos-base),4);
+         std::memcpy(&meta,map->data+(pos-base)+4,4);
+
+         if ( size == 0 || (pos + 4 + size) > fSize ) {
+            log.warning("Bad size read %i at offset %lu",size,pos);
+            done = true;
             break;
          }
+         frame = frame_++;
 
-         // Read flags
-         if ( read(fd_,&meta, 4) != 4 ) {
-            log.warning("Failed to read flags");
-            err = true;
+         // Past end of range
+         if ( end_ != 0 && frame >= end_ ) {
+            done = true;
             break;
          }
 
-         // Skip next step if frame is empty
-         if ( size <= 4 ) continue;
-         size -= 4;
-
-         // Extract meta data
-         flags = meta & 0xFFFF;
-         error = (meta >> 16) & 0xFF;
-         chan  = (meta >> 24) & 0xFF;
-
-         // Request frame
-         frame = reqFrame(size,true);
-         frame->setFlags(flags);
-         frame->setError(error);
-         frame->setChannel(chan);
-         it = frame->beginBuffer();
-
-         while ( (err == false) && (size > 0) ) {
-            bSize = size;
-
-            // Adjust to buffer size, if necessary
-            if ( bSize > (*it)->getSize() ) bSize = (*it)->getSize();
-
-            if ( (ret = read(fd_,(*it)->begin(),bSize)) != bSize) {
-               log.warning("Short read. Ret = %i Req = %i after %i bytes",ret,bSize,frame->getPayload());
-               ::close(fd_);
-               fd_ = -1;
-               frame->setError(0x1);
-               err = true;
+         if ( frame >= start_ && size > 4 && ! (filterEn_ && ! filter_.test((meta >> 24) & 0xFF)) ) {
+
+            // Frame extends past the window, map a new window starting with this frame
+            if ( (pos + 4 + size) > (base + map->size) ) {
+               map.reset();
+               base = pos - (pos % sysconf(_SC_PAGESIZE));
+               len  = ((base + MapSize) > fSize) ? (fSize - base) : MapSize;
+               if ( len < (pos + 4 + size - base) ) len = pos + 4 + size - base;
+
+               if ( (data = (uint8_t *)mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd_,base)) == MAP_FAILED ) {
+                  log.warning("Failed to map data file, index %i",fdIdx_);
+                  done = true;
+                  break;
+               }
+               map = std::make_shared<ruf::StreamReader::Mapping>(data,len);
+               madvise(data,len,MADV_SEQUENTIAL);
+               ahead = base;
             }
-            else {
-               (*it)->setPayload(bSize);
-               ++it; // Next buffer
+
+            // Request the next window ahead of the frames being sent, populating
+            // the page tables when supported avoids a fault for every page
+            while ( (ahead - base) < map->size && ahead < (pos + size + MapAhead) ) {
+               len = ((ahead - base + MapAhead) > map->size) ? (map->size - (ahead - base)) : MapAhead;
+#ifdef MADV_POPULATE_READ
+               if ( madvise(map->data+(ahead-base),len,MADV_POPULATE_READ) != 0 )
+#endif
+               madvise(map->data+(ahead-base),len,MADV_WILLNEED);
+               ahead += len;
             }
-            size -= bSize;
+
+            pace(frame,true);
+            sendFrame(mapFrame(map,pos-base+8,size-4,meta));
          }
-         sendFrame(frame);
+         else if ( frame >= start_ && size > 4 ) pace(frame,false);
+
+         pos += 4 + size;
       }
-   } while ( threadEn_ && (err == false) && nextFile() );
 
-   std::unique_lock<std::mutex> lock(mtx_);
-   if ( fd_ >= 0 ) ::close(fd_);
-   fd_ = -1;
-   active_ = false;
-   cond_.notify_all();
+      // Each window is released when the last frame referencing it is returned
+      map.reset();
+      pos = 0;
+
+   } while ( (! done) && threadEn_ && nextFile() );
 }
 
+//! Create a frame referencing a memory mapped file
+ris::FramePtr ruf::StreamReader::mapFrame(std::shared_ptr<ruf::StreamReader::Mapping> map,
+                                           uint64_t offset, uint32_t size, uint32_t meta) {
+   ris::FramePtr  frame;
+   ris::BufferPtr buff;
+   uint32_t slot;
+
+   // Slot holds the mapping until the buffer is returned
+   {
+      std::lock_guard<std::mutex> lock(slotMtx_);
+
+      if ( free_.empty() ) {
+         slot = slots_.size();
+         slots_.push_back(map);
+      }
+      else {
+         slot = free_.back();
+         free_.pop_back();
+         slots_[slot] = map;
+      }
+   }
+
+   // Bit 31 marks a zero copy buffer
+   buff = createBuffer(map->data + offset, 0x80000000 | slot, size, size);
+
+   frame = ris::Frame::create();
+   frame->appendBuffer(buff);
+   frame->setPayload(size);
+   frame->setFlags(meta & 0xFFFF);
+   frame->setError((meta >> 16) & 0xFF);
+   frame->setChannel((meta >> 24) & 0xFF);
+   return(frame);
+}
+
+//! Replay pacing, called for each frame in range
+void ruf::StreamReader::pace(uint64_t frame, bool send) {
+
+   // Fixed rate counts sent frames only
+   if ( rate_ > 0 ) {
+      if ( send ) {
+         next_ += std::chrono::nanoseconds((uint64_t)(1e9 / rate_));
+         std::this_thread::sleep_until(next_);
+      }
+   }
+
+   // Original timing includes the gaps of filtered frames
+   else if ( timing_ > 0 && frame < index_->getCount() ) {
+      const ruf::StreamIndex::Entry & entry = index_->entry(frame);
+
+      if ( entry.frame == frame ) next_ += std::chrono::nanoseconds((uint64_t)(entry.time * 1000.0 / timing_));
+      if ( send ) std::this_thread::sleep_until(next_);
+   }
+}
+
+//! Read frame data at the current file position
+bool ruf::StreamReader::readFrame(uint32_t size, uint32_t meta, rogue::Logging & log) {
+   int32_t  ret;
+   uint16_t flags;
+   uint8_t  error;
+   uint8_t  chan;
+   uint32_t bSize;
+   bool     err;
+   ris::FramePtr frame;
+   ris::Frame::BufferIterator it;
+
+   // Extract meta data
+   flags = meta & 0xFFFF;
+   error = (meta >> 16) & 0xFF;
+   chan  = (meta >> 24) & 0xFF;
+
+   // Request frame
+   frame = reqFrame(size,true);
+   frame->setFlags(flags);
+   frame->setError(error);
+   frame->setChannel(chan);
+   it = frame->beginBuffer();
+
+   err = false;
+   while ( (err == false) && (size > 0) ) {
+      bSize = size;
+
+      // Adjust to buffer size, if necessary
+      if ( bSize > (*it)->getSize() ) bSize = (*it)->getSize();
+
+      if ( (ret = read(fd_,(*it)->begin(),bSize)) != bSize) {
+         log.warning("Short read. Ret = %i Req = %i after %i bytes",ret,bSize,frame->getPayload());
+         ::close(fd_);
+         fd_ = -1;
+         frame->setError(0x1);
+         err = true;
+      }
+      else {
+         (*it)->setPayload(bSize);
+         ++it; // Next buffer
+      }
+      size -= bSize;
+   }
+   sendFrame(frame);
+   return(! err);
+}
@@ -44,7 +44,10 @@
 #include <fcntl.h>
 #include <rogue/GilRelease.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/uio.h>
+#include <limits.h>
 #include <string.h>
 #include <cstring>
 
@@ -71,6 +74,12 @@ void ruf::StreamWriter::setup_python() {
       .def("close",          &ruf::StreamWriter::close)
       .def("isOpen",         &ruf::StreamWriter::isOpen)
       .def("setBufferSize",  &ruf::StreamWriter::setBufferSize)
+      .def("setAsync",       &ruf::StreamWriter::setAsync)
+      .def("setDirect",      &ruf::StreamWriter::setDirect)
+      .def("setDropFull",    &ruf::StreamWriter::setDropFull)
+      .def("getDropCount",   &ruf::StreamWriter::getDropCount)
+      .def("setVectored",    &ruf::StreamWriter::setVectored)
+      .def("setIndex",       &ruf::StreamWriter::setIndex)
       .def("setMaxSize",     &ruf::StreamWriter::setMaxSize)
       .def("setDropErrors",  &ruf::StreamWriter::setDropErrors)
       .def("getChannel",     &ruf::StreamWriter::getChannel)
@@ -95,6 +104,20 @@ ruf::StreamWriter::StreamWriter() {
    currBuffer_ = 0;
    dropErrors_ = false;
    isOpen_     = false;
+   asyncCount_ = 0;
+   direct_     = false;
+   dropFull_   = false;
+   dropCount_  = 0;
+   ioPending_  = 0;
+   ioThread_   = NULL;
+   ioErrorFd_  = -1;
+   vectored_   = false;
+   iovRef_     = 0;
+   index_      = false;
+   idxFd_      = -1;
+   idxFrame_   = 0;
+   split_      = false;
+   fileBase_   = 0;
 
    log_ = rogue::Logging::create("fileio.StreamWriter");
 }
@@ -102,6 +125,12 @@ ruf::StreamWriter::StreamWriter() {
 //! Deconstructor
 ruf::StreamWriter::~StreamWriter() {
    this->close();
+
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+   stopAsync();
+   if ( buffer_ != NULL ) free(buffer_);
+   buffer_ = NULL;
 }
 
 //! Open a data file
@@ -114,22 +143,39 @@ void ruf::StreamWriter::open(std::string file) {
    flush();
 
    // Close if open
-   if ( fd_ >= 0 ) ::close(fd_);
-   fd_ = -1;
+   closeFile();
+   idxFlush();
+   if ( idxFd_ >= 0 ) ::close(idxFd_);
+   idxFd_ = -1;
 
    baseName_ = file;
    name   = file;
    fdIdx_ = 1;
+   split_ = (sizeLimit_ > 0);
 
-   if ( sizeLimit_ > 0 ) name.append(".1");
+   if ( split_ ) name.append(".1");
 
-   if ( (fd_ = ::open(name.c_str(),O_RDWR|O_CREAT|O_APPEND,S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH)) < 0 )
+   if ( (fd_ = openFile(name)) < 0 )
       throw(rogue::GeneralError::create("StreamWriter::open","Failed to open data file: %s",name.c_str()));
 
+   // Index is appended to along with the data file, frame numbers continue from existing entries
+   if ( index_ ) {
+      struct stat st;
+
+      name = baseName_ + ".idx";
+      if ( (idxFd_ = ::open(name.c_str(),O_RDWR|O_CREAT|O_APPEND,S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH)) < 0 )
+         throw(rogue::GeneralError::create("StreamWriter::open","Failed to open index file: %s",name.c_str()));
+
+      fstat(idxFd_,&st);
+      if ( st.st_size == 0 ) ruf::StreamIndex::writeHeader(idxFd_);
+      idxFrame_ = (st.st_size <= 8) ? 0 : (st.st_size - 8) / sizeof(ruf::StreamIndex::Entry);
+      idxTime_  = std::chrono::steady_clock::now();
+   }
+
    totSize_    = 0;
    currSize_   = 0;
    frameCount_ = 0;
-   currBuffer_ = 0;
+   dropCount_  = 0;
 
    //Iterate over all channels and reset their frame counts
    for (std::map<uint32_t,ruf::StreamWriterChannelPtr>::iterator it=channelMap_.begin(); it!=channelMap_.end(); ++it) {
@@ -144,8 +190,19 @@ void ruf::StreamWriter::close() {
    std::lock_guard<std::mutex> lock(mtx_);
    isOpen_ = false;
    flush();
-   if ( fd_ >= 0 ) ::close(fd_);
-   fd_ = -1;
+   closeFile();
+
+   // Data is written when close returns
+   drainAsync();
+
+   idxFlush();
+   if ( idxFd_ >= 0 ) ::close(idxFd_);
+   idxFd_ = -1;
+}
+
+//! Write a sidecar index, applied when a file is opened
+void ruf::StreamWriter::setIndex(bool index) {
+   index_ = index;
 }
 
 //! Get open status
@@ -164,8 +221,17 @@ void ruf::StreamWriter::setBufferSize(uint32_t size) {
       // Flush data out of current buffer
       flush();
 
+      // Staging buffers are re-allocated with the new size
+      if ( asyncCount_ > 0 ) {
+         stopAsync();
+         buffSize_ = size;
+         startAsync();
+         return;
+      }
+
       // Free old buffer
       if ( buffer_ != NULL ) free(buffer_);
+      buffer_   = NULL;
       buffSize_ = 0;
 
       // Buffer is enabled
@@ -179,6 +245,54 @@ void ruf::StreamWriter::setBufferSize(uint32_t size) {
    }
 }
 
+//! Set number of staging buffers for asynchronous writes, 0 to disable
+void ruf::StreamWriter::setAsync(uint32_t count) {
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+
+   if ( count == asyncCount_ ) return;
+
+   flush();
+
+   // Leaving synchronous mode, staging buffers replace the write buffer
+   if ( asyncCount_ == 0 ) {
+      if ( buffer_ != NULL ) free(buffer_);
+      buffer_ = NULL;
+   }
+   else stopAsync();
+
+   asyncCount_ = count;
+
+   if ( asyncCount_ > 0 ) startAsync();
+
+   // Back to synchronous mode, restore write buffer
+   else if ( buffSize_ > 0 && (buffer_ = (uint8_t *)malloc(buffSize_)) == NULL )
+      throw(rogue::GeneralError::create("StreamWriter::setAsync","Failed to allocate buffer with size = %i",buffSize_));
+}
+
+//! Write frames with writev from the frame buffers instead of copying them
+void ruf::StreamWriter::setVectored(bool vectored) {
+   rogue::GilRelease noGil;
+   std::lock_guard<std::mutex> lock(mtx_);
+   flush();
+   vectored_ = vectored;
+}
+
+//! Use O_DIRECT for asynchronous writes, applied when a file is opened
+void ruf::StreamWriter::setDirect(bool direct) {
+   direct_ = direct;
+}
+
+//! Drop frames instead of blocking when the disk falls behind
+void ruf::StreamWriter::setDropFull(bool drop) {
+   dropFull_ = drop;
+}
+
+//! Get count of frames dropped when the disk falls behind
+uint32_t ruf::StreamWriter::getDropCount() {
+   return(dropCount_);
+}
+
 //! Set max file size, 0 for unlimited
 void ruf::StreamWriter::setMaxSize(uint64_t size) {
    rogue::GilRelease noGil;
@@ -205,14 +319,14 @@ ruf::StreamWriterChannelPtr ruf::StreamWriter::getChannel(uint8_t channel) {
 uint64_t ruf::StreamWriter::getTotalSize() {
    rogue::GilRelease noGil;
    std::lock_guard<std::mutex> lock(mtx_);
-   return(totSize_ + currBuffer_);
+   return(totSize_ + currBuffer_ + iovRef_);
 }
 
 //! Get current file size
 uint64_t ruf::StreamWriter::getCurrentSize() {
    rogue::GilRelease noGil;
    std::lock_guard<std::mutex> lock(mtx_);
-   return(currSize_ + currBuffer_);
+   return(currSize_ + currBuffer_ + iovRef_);
 }
 
 //! Get current frame count
@@ -261,21 +375,95 @@ void ruf::StreamWriter::writeFile ( uint8_t channel, std::shared_ptr<rogue::inte
    rogue::GilRelease noGil;
    std::unique_lock<std::mutex> lock(mtx_);
 
+   // Asynchronous write failed, close file as in synchronous mode
+   if ( asyncCount_ > 0 && fd_ >= 0 && ioErrorFd_ == fd_ ) {
+      ioErrorFd_ = -1;
+      if ( buffer_ != NULL ) {
+         std::lock_guard<std::mutex> ioLock(ioMtx_);
+         ioFree_.push_back(buffer_);
+      }
+      buffer_     = NULL;
+      currBuffer_ = 0;
+      closeFile();
+   }
+
    if ( fd_ >= 0 ) {
 
       // Written size has extra 4 bytes
       size = frame->getPayload() + 4;
 
+      // Drop if staging buffers can not hold the frame without waiting
+      if ( asyncCount_ > 0 && dropFull_ ) {
+         uint64_t avail = (buffer_ == NULL) ? 0 : (buffSize_ - currBuffer_);
+         {
+            std::lock_guard<std::mutex> ioLock(ioMtx_);
+            avail += (uint64_t)ioFree_.size() * buffSize_;
+         }
+         if ( (size + 4) > avail ) {
+            dropCount_++;
+            return;
+         }
+      }
+
       // Check file size, including size header
       checkSize(size+4);
 
-      // First write size
-      intWrite(&size,4);
-
       // Create EVIO header
       value  = frame->getFlags();
       value |= (frame->getError() << 16);
       value |= (channel << 24);
+
+      // Index entry points to the start of the frame in the current file
+      if ( idxFd_ >= 0 ) {
+         ruf::StreamIndex::Entry entry;
+         std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+         uint64_t delta = std::chrono::duration_cast<std::chrono::microseconds>(now - idxTime_).count();
+
+         entry.frame    = idxFrame_++;
+         entry.offset   = fileBase_ + currSize_ + currBuffer_ + iovRef_;
+         entry.size     = size;
+         entry.meta     = value;
+         entry.file     = (split_ || fdIdx_ > 1) ? fdIdx_ : 0;
+         entry.time     = (delta > 0xFFFFFFFF) ? 0xFFFFFFFF : delta;
+         idxBuff_.push_back(entry);
+         idxTime_ = now;
+
+         if ( idxBuff_.size() >= IndexBuffCount ) idxFlush();
+      }
+
+      // Headers and small buffers are copied, large buffers are written from the frame
+      if ( vectored_ && asyncCount_ == 0 ) {
+         bool ref = false;
+
+         if ( buffer_ != NULL && buffSize_ >= 8 ) {
+            if ( (currBuffer_ + 8) > buffSize_ ) iovFlush();
+            iovAdd(&size,4,true);
+            iovAdd(&value,4,true);
+         }
+         else {
+            iovHdr_[0] = size;
+            iovHdr_[1] = value;
+            iovAdd(iovHdr_,8,false);
+         }
+
+         for (it=frame->beginBuffer(); it != frame->endBuffer(); ++it)
+            ref |= iovAdd((*it)->begin(),(*it)->getPayload(),(*it)->getPayload() < VecCopySize);
+
+         // Hold frame until its buffers are written
+         if ( ref ) iovFrames_.push_back(frame);
+
+         // Without a write buffer the header storage is reused by the next frame
+         if ( buffer_ == NULL || buffSize_ < 8 || (currBuffer_ + iovRef_) >= buffSize_ ) iovFlush();
+
+         frameCount_ ++;
+         cond_.notify_all();
+         return;
+      }
+
+      // First write size
+      intWrite(&size,4);
+
+      // Write EVIO header
       intWrite(&value,4);
 
       // Write buffers
@@ -290,9 +478,29 @@ void ruf::StreamWriter::writeFile ( uint8_t channel, std::shared_ptr<rogue::inte
 
 //! Internal method for file writing with buffer and auto close and reopen
 void ruf::StreamWriter::intWrite(void *data, uint32_t size) {
+   uint8_t * ptr;
+   uint32_t  csize;
 
    if ( fd_ < 0 ) return;
 
+   // Copy into staging buffers, full buffers are queued to the I/O thread
+   if ( asyncCount_ > 0 ) {
+      ptr = (uint8_t *)data;
+
+      while ( size > 0 ) {
+         if ( buffer_ == NULL ) buffer_ = asyncBuffer();
+
+         csize = (size > (buffSize_ - currBuffer_)) ? (buffSize_ - currBuffer_) : size;
+         std::memcpy(buffer_ + currBuffer_, ptr, csize);
+         currBuffer_ += csize;
+         ptr  += csize;
+         size -= csize;
+
+         if ( currBuffer_ == buffSize_ ) asyncFlush();
+      }
+      return;
+   }
+
    // New size is larger than buffer size, flush
    if ( (size + currBuffer_) > buffSize_ ) flush();
 
@@ -328,17 +536,17 @@ void ruf::StreamWriter::checkSize(uint32_t size) {
       throw(rogue::GeneralError("StreamWriter::checkSize","Frame size is larger than file size limit"));
 
    // File size (including buffer) is larger than max size
-   if ( (size + currBuffer_ + currSize_) > sizeLimit_ ) {
+   if ( (size + currBuffer_ + iovRef_ + currSize_) > sizeLimit_ ) {
       flush();
 
       // Close and update index
-      ::close(fd_);
+      closeFile();
       fdIdx_++;
 
       name = baseName_ + "." + std::to_string(fdIdx_);
 
       // Open new file
-      if ( (fd_ = ::open(name.c_str(),O_RDWR|O_CREAT|O_APPEND,S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH)) < 0 )
+      if ( (fd_ = openFile(name)) < 0 )
          throw(rogue::GeneralError::create("StreamWriter::checkSize","Failed to open file %s",name.c_str()));
 
       currSize_ = 0;
@@ -347,7 +555,11 @@ void ruf::StreamWriter::checkSize(uint32_t size) {
 
 //! Flush file
 void ruf::StreamWriter::flush() {
-   if ( currBuffer_ > 0 ) {
+   if ( asyncCount_ > 0 ) asyncFlush();
+
+   else if ( ! iov_.empty() ) iovFlush();
+
+   else if ( currBuffer_ > 0 ) {
       if ( write(fd_,buffer_,currBuffer_) != (int32_t)currBuffer_ ) {
          ::close(fd_);
          fd_ = -1;
@@ -361,3 +573,295 @@ void ruf::StreamWriter::flush() {
    }
 }
 
+
+//! Write buffered index entries
+void ruf::StreamWriter::idxFlush() {
+   size_t size;
+
+   size = idxBuff_.size() * sizeof(ruf::StreamIndex::Entry);
+
+   if ( idxFd_ >= 0 && size > 0 && write(idxFd_,idxBuff_.data(),size) != (ssize_t)size ) {
+      ::close(idxFd_);
+      idxFd_ = -1;
+      log_->error("Index write failed, closing index!");
+   }
+   idxBuff_.clear();
+}
+
+//! Add data to the pending write vector, returns true if data is referenced
+bool ruf::StreamWriter::iovAdd(void *data, uint32_t size, bool copy) {
+   struct iovec vec;
+   uint8_t * dst;
+
+   if ( size == 0 ) return(false);
+
+   // Copy into write buffer, extending the previous entry when contiguous
+   if ( copy && buffer_ != NULL && (currBuffer_ + size) <= buffSize_ ) {
+      dst = buffer_ + currBuffer_;
+      std::memcpy(dst,data,size);
+      currBuffer_ += size;
+
+      if ( (! iov_.empty()) && ((uint8_t *)iov_.back().iov_base + iov_.back().iov_len) == dst )
+         iov_.back().iov_len += size;
+      else {
+         vec.iov_base = dst;
+         vec.iov_len  = size;
+         iov_.push_back(vec);
+      }
+      return(false);
+   }
+
+   vec.iov_base = data;
+   vec.iov_len  = size;
+   iov_.push_back(vec);
+   iovRef_ += size;
+   return(true);
+}
+
+//! Write the pending write vector
+void ruf::StreamWriter::iovFlush() {
+   struct iovec * vec;
+   uint64_t total;
+   size_t   cnt;
+   ssize_t  ret;
+
+   vec   = iov_.data();
+   cnt   = iov_.size();
+   total = currBuffer_ + iovRef_;
+
+   while ( cnt > 0 && fd_ >= 0 ) {
+      if ( (ret = writev(fd_,vec,(cnt > IOV_MAX) ? IOV_MAX : cnt)) <= 0 ) {
+         ::close(fd_);
+         fd_ = -1;
+         log_->error("Write failed, closing file!");
+         break;
+      }
+
+      // Skip written entries, a partial write leaves the remainder of an entry
+      while ( cnt > 0 && (size_t)ret >= vec->iov_len ) {
+         ret -= vec->iov_len;
+         vec++;
+         cnt--;
+      }
+      if ( ret > 0 ) {
+         vec->iov_base = (uint8_t *)vec->iov_base + ret;
+         vec->iov_len -= ret;
+      }
+   }
+
+   if ( fd_ >= 0 ) {
+      currSize_ += total;
+      totSize_  += total;
+   }
+
+   iov_.clear();
+   iovFrames_.clear();
+   currBuffer_ = 0;
+   iovRef_     = 0;
+}
+
+//! Open a file for writing
+int32_t ruf::StreamWriter::openFile(std::string name) {
+   struct stat st;
+   int32_t fd;
+   int32_t flags;
+
+   flags = O_RDWR|O_CREAT|O_APPEND;
+
+   fileBase_ = 0;
+
+#ifdef O_DIRECT
+   // Direct writes need an aligned starting offset and a file system which supports them
+   if ( asyncCount_ > 0 && direct_ ) {
+      if ( (fd = ::open(name.c_str(),flags|O_DIRECT,S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH)) >= 0 ) {
+         if ( fstat(fd,&st) == 0 && (st.st_size % DirectAlign) == 0 ) {
+            fileBase_ = st.st_size;
+            return(fd);
+         }
+         ::close(fd);
+      }
+      log_->warning("Direct I/O not available for %s, using buffered writes",name.c_str());
+   }
+#endif
+
+   // Frames are appended to an existing file
+   if ( (fd = ::open(name.c_str(),flags,S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH)) >= 0 && fstat(fd,&st) == 0 )
+      fileBase_ = st.st_size;
+
+   return(fd);
+}
+
+//! Close current file, deferred to the I/O thread in asynchronous mode
+void ruf::StreamWriter::closeFile() {
+   if ( fd_ < 0 ) return;
+
+   if ( asyncCount_ > 0 ) {
+      AsyncReq req;
+      req.fd   = fd_;
+      req.last = true;
+
+      {
+         std::lock_guard<std::mutex> lock(ioMtx_);
+         ioPending_++;
+      }
+      ioQueue_->push(req);
+   }
+   else ::close(fd_);
+
+   fd_ = -1;
+}
+
+//! Start I/O thread and allocate staging buffers
+void ruf::StreamWriter::startAsync() {
+   uint8_t * data;
+   uint32_t  x;
+
+   // Staging buffers are aligned for direct I/O
+   if ( buffSize_ == 0 ) buffSize_ = AsyncBuffSize;
+   if ( (buffSize_ % DirectAlign) != 0 ) buffSize_ += DirectAlign - (buffSize_ % DirectAlign);
+
+   for (x=0; x < asyncCount_; x++) {
+      if ( posix_memalign((void **)&data,DirectAlign,buffSize_) != 0 )
+         throw(rogue::GeneralError::create("StreamWriter::startAsync","Failed to allocate buffer with size = %i",buffSize_));
+      ioFree_.push_back(data);
+   }
+
+   ioPending_ = 0;
+   ioQueue_   = std::make_shared<rogue::Queue<ruf::StreamWriter::AsyncReq>>();
+   ioThread_  = new std::thread(&ruf::StreamWriter::runIo, this);
+
+   // Set a thread name
+#ifndef __MACH__
+   pthread_setname_np( ioThread_->native_handle(), "StreamWriter" );
+#endif
+}
+
+//! Drain and stop I/O thread, free staging buffers
+void ruf::StreamWriter::stopAsync() {
+   uint32_t x;
+
+   if ( ioThread_ == NULL ) return;
+
+   // Queue partial buffer, an open file stays open for synchronous writes
+   asyncFlush();
+   drainAsync();
+
+#ifdef O_DIRECT
+   if ( fd_ >= 0 ) fcntl(fd_,F_SETFL,fcntl(fd_,F_GETFL) & ~O_DIRECT);
+#endif
+
+   ioQueue_->stop();
+   ioThread_->join();
+   delete ioThread_;
+   ioThread_ = NULL;
+   ioQueue_.reset();
+
+   if ( buffer_ != NULL ) ioFree_.push_back(buffer_);
+   buffer_ = NULL;
+
+   for (x=0; x < ioFree_.size(); x++) free(ioFree_[x]);
+   ioFree_.clear();
+}
+
+//! Wait for queued staging buffers to be written
+void ruf::StreamWriter::drainAsync() {
+   std::unique_lock<std::mutex> lock(ioMtx_);
+   while ( ioPending_ > 0 ) ioCond_.wait(lock);
+}
+
+//! Get a free staging buffer, blocks while the disk falls behind
+uint8_t * ruf::StreamWriter::asyncBuffer() {
+   uint8_t * data;
+
+   std::unique_lock<std::mutex> lock(ioMtx_);
+   while ( ioFree_.empty() ) ioCond_.wait(lock);
+
+   data = ioFree_.back();
+   ioFree_.pop_back();
+   return(data);
+}
+
+//! Queue current staging buffer
+void ruf::StreamWriter::asyncFlush() {
+   AsyncReq req;
+
+   if ( buffer_ == NULL || currBuffer_ == 0 ) return;
+
+   req.data = buffer_;
+   req.size = currBuffer_;
+   req.fd   = fd_;
+
+   currSize_ += currBuffer_;
+   totSize_  += currBuffer_;
+   buffer_     = NULL;
+   currBuffer_ = 0;
+
+   {
+      std::lock_guard<std::mutex> lock(ioMtx_);
+      ioPending_++;
+   }
+   ioQueue_->push(req);
+}
+
+//! Write a staging buffer, called by I/O thread
+bool ruf::StreamWriter::ioWrite(ruf::StreamWriter::AsyncReq & req) {
+   uint32_t pos;
+   uint32_t aSize;
+   int32_t  ret;
+   int32_t  flags;
+
+   aSize = req.size;
+
+#ifdef O_DIRECT
+   // Only the last buffer of a file is partial, its tail is written without O_DIRECT
+   flags = 0;
+   if ( (req.size % DirectAlign) != 0 && ((flags = fcntl(req.fd,F_GETFL)) & O_DIRECT) != 0 )
+      aSize = req.size - (req.size % DirectAlign);
+#endif
+
+   for (pos=0; pos < req.size; pos += ret) {
+
+#ifdef O_DIRECT
+      if ( pos == aSize && (flags & O_DIRECT) != 0 ) fcntl(req.fd,F_SETFL,flags & ~O_DIRECT);
+#endif
+
+      if ( (ret = write(req.fd,req.data+pos,((pos < aSize) ? aSize : req.size) - pos)) <= 0 ) return(false);
+   }
+   return(true);
+}
+
+//! I/O thread
+void ruf::StreamWriter::runIo() {
+   std::shared_ptr<rogue::Queue<ruf::StreamWriter::AsyncReq>> queue;
+   AsyncReq req;
+   int32_t  badFd;
+
+   log_->logThreadId();
+
+   queue = ioQueue_;
+   badFd = -1;
+
+   // Pop returns an empty request once the queue is stopped
+   while ( (req = queue->pop()).fd >= 0 ) {
+
+      // Remaining buffers for a failed file are discarded, the writer closes it
+      if ( req.size > 0 && req.fd != badFd && ! ioWrite(req) ) {
+         log_->error("Write failed, closing file!");
+         badFd = req.fd;
+         ioErrorFd_ = req.fd;
+      }
+
+      // Clear the error before the descriptor can be reused
+      if ( req.last ) {
+         int32_t fd = req.fd;
+         ioErrorFd_.compare_exchange_strong(fd,-1);
+         ::close(req.fd);
+         badFd = -1;
+      }
+
+      std::lock_guard<std::mutex> lock(ioMtx_);
+      if ( req.data != NULL ) ioFree_.push_back(req.data);
+      ioPending_--;
+      ioCond_.notify_all();
+   }
+}
@@ -20,6 +20,7 @@
  * ----------------------------------------------------------------------------
 **/
 
+#include <rogue/utilities/fileio/StreamIndex.h>
 #include <rogue/utilities/fileio/StreamReader.h>
 #include <rogue/utilities/fileio/StreamWriterChannel.h>
 #include <rogue/utilities/fileio/StreamWriter.h>
@@ -44,6 +45,7 @@ void ruf::setup_module() {
    // set the current scope to the new sub-module
    bp::scope io_scope = module;
 
+   ruf::StreamIndex::setup_python();
    ruf::StreamReader::setup_python();
    ruf::LegacyStreamReader::setup_python();
    ruf::StreamWriter::setup_python();
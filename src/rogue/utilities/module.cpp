@@ -20,8 +20,10 @@
  * ----------------------------------------------------------------------------
 **/
 
+#include <RogueConfig.h>
 #include <rogue/utilities/module.h>
 #include <rogue/utilities/Prbs.h>
+#include <rogue/utilities/Crc32.h>
 #include <rogue/utilities/StreamZip.h>
 #include <rogue/utilities/StreamUnZip.h>
 #include <rogue/utilities/fileio/module.h>
@@ -31,6 +33,11 @@
 #define BOOST_BIND_GLOBAL_PLACEHOLDERS
 #include <boost/python.hpp>
 
+#if DO_COMPRESSION
+   #include <rogue/utilities/StreamCompress.h>
+   #include <rogue/utilities/StreamDecompress.h>
+#endif
+
 namespace bp  = boost::python;
 namespace ru  = rogue::utilities;
 namespace ris = rogue::interfaces::stream;
@@ -49,6 +56,11 @@ void ru::setup_module() {
    ru::Prbs::setup_python();
    ru::StreamZip::setup_python();
    ru::StreamUnZip::setup_python();
+#if DO_COMPRESSION
+   ru::StreamCompress::setup_python();
+   ru::StreamDecompress::setup_python();
+#endif
+   ru::Crc32::setup_python();
    ru::fileio::setup_module();
 }
 
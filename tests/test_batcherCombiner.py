@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Batcher combiner round trip and small frame benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.protocols.batcher
+import rogue.interfaces.stream
+import rogue.utilities
+import rogue
+import time
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+FrameCount = 100000
+FrameSize  = 64
+MaxSize    = 65536
+
+# Checks user fields and channel carried in the record tail
+class RecordCheck(rogue.interfaces.stream.Slave):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        self.count  = 0
+        self.errors = 0
+
+    def _acceptFrame(self,frame):
+        with frame.lock():
+            exp = self.count & 0xFF
+            size = frame.getPayload()
+            data = bytearray(size)
+            frame.read(data,0)
+
+        if (frame.getChannel() != exp or frame.getFirstUser() != exp or
+            frame.getLastUser() != (exp ^ 0xFF) or size != 1 + (self.count % 100) or
+            data != bytearray((self.count + i) & 0xFF for i in range(size))):
+            self.errors += 1
+
+        self.count += 1
+
+# Captures raw super-frames
+class SuperCapture(rogue.interfaces.stream.Slave):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        self.frames = []
+
+    def _acceptFrame(self,frame):
+        with frame.lock():
+            data = bytearray(frame.getPayload())
+            frame.read(data,0)
+            self.frames.append((bytes(data),frame.getFirstUser(),frame.getLastUser()))
+
+def send_record(src, data, channel, fUser, lUser):
+    frame = src._reqFrame(max(1,len(data)),True)
+    if len(data) > 0:
+        frame.write(bytearray(data),0)
+    frame.setPayload(len(data))
+    frame.setChannel(channel)
+    frame.setFirstUser(fUser)
+    frame.setLastUser(lUser)
+    src._sendFrame(frame)
+
+def test_combiner_golden():
+
+    # Width 4: 4 byte header, 8 byte tail
+    src  = rogue.interfaces.stream.Master()
+    comb = rogue.protocols.batcher.CombinerV1(4,4096)
+    cap  = SuperCapture()
+    comb.setTimeout(0)
+    src >> comb >> cap
+
+    send_record(src, [0x11, 0x12, 0x13, 0x14], 3, 0x05, 0x06)
+    send_record(src, [], 1, 0x00, 0x00)
+    send_record(src, [0xa0, 0xa1, 0xa2, 0xa3, 0xa4], 2, 0x00, 0x81)
+    comb.flush()
+
+    send_record(src, [0x55, 0x66], 0, 0x00, 0x00)
+    comb.flush()
+
+    exp = bytes([
+        0x11, 0x00, 0x00, 0x00,                          # Header: version 1, width code 1, sequence 0
+        0x11, 0x12, 0x13, 0x14,                          # Record 0, exact multiple of width
+        0x04, 0x00, 0x00, 0x00, 0x03, 0x05, 0x06, 0x04,  # Tail: size 4, chan 3, fUser, lUser, 4 valid bytes
+        0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,  # Record 1 tail: size 0, chan 1, 0 valid bytes
+        0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0x00, 0x00, 0x00,  # Record 2, padded to width
+        0x05, 0x00, 0x00, 0x00, 0x02, 0x00, 0x81, 0x01,  # Tail: size 5, chan 2, fUser, lUser, 1 valid byte
+    ])
+
+    if len(cap.frames) != 2:
+        raise AssertionError(f'Unexpected super-frame count {len(cap.frames)}')
+
+    data, fUser, lUser = cap.frames[0]
+
+    if data != exp:
+        raise AssertionError(f'Golden mismatch width 4:\n got {data.hex()}\n exp {exp.hex()}')
+
+    if fUser != 0x2 or lUser != 0x0:
+        raise AssertionError(f'Unexpected super-frame user fields: first={fUser:#x} last={lUser:#x}')
+
+    if cap.frames[1][0][0:2] != bytes([0x11, 0x01]):
+        raise AssertionError(f'Unexpected second super-frame header {cap.frames[1][0][0:4].hex()}')
+
+    # Width 16: header and tail are a full width, zero filled
+    src  = rogue.interfaces.stream.Master()
+    comb = rogue.protocols.batcher.CombinerV1(16,4096)
+    cap  = SuperCapture()
+    src >> comb >> cap
+
+    send_record(src, [0xa0, 0xa1, 0xa2, 0xa3, 0xa4], 7, 0x02, 0x03)
+    comb.flush()
+
+    exp = bytes([0x31] + [0x00] * 15 +
+                [0xa0, 0xa1, 0xa2, 0xa3, 0xa4] + [0x00] * 11 +
+                [0x05, 0x00, 0x00, 0x00, 0x07, 0x02, 0x03, 0x05] + [0x00] * 8)
+
+    if len(cap.frames) != 1 or cap.frames[0][0] != exp:
+        raise AssertionError(f'Golden mismatch width 16:\n got {cap.frames[0][0].hex() if cap.frames else None}\n exp {exp.hex()}')
+
+def test_combiner_round_trip():
+    src = rogue.interfaces.stream.Master()
+    chk = RecordCheck()
+
+    for width in [2, 4, 8, 16, 32, 64]:
+        comb = rogue.protocols.batcher.CombinerV1(width,4096)
+        split = rogue.protocols.batcher.SplitterV1()
+
+        chk.count = 0
+        src >> comb >> split >> chk
+
+        for i in range(1000):
+            size  = 1 + (i % 100)
+            frame = src._reqFrame(size,True)
+            frame.write(bytearray((i + j) & 0xFF for j in range(size)),0)
+            frame.setChannel(i & 0xFF)
+            frame.setFirstUser(i & 0xFF)
+            frame.setLastUser((i & 0xFF) ^ 0xFF)
+            src._sendFrame(frame)
+
+        comb.flush()
+
+        if chk.count != 1000 or chk.errors != 0:
+            raise AssertionError(f'Round trip error. Width={width} Count={chk.count} Errors={chk.errors}')
+
+        print(f"Combiner width={width}: records={comb.getRecordCount()} batches={comb.getBatchCount()}")
+
+        # Reconnect the source for the next width
+        src = rogue.interfaces.stream.Master()
+
+def bridge_rate(combine, port):
+
+    serv   = rogue.interfaces.stream.TcpServer("127.0.0.1",port)
+    client = rogue.interfaces.stream.TcpClient("127.0.0.1",port)
+
+    prbsTx = rogue.utilities.Prbs()
+    prbsRx = rogue.utilities.Prbs()
+
+    if combine:
+        comb  = rogue.protocols.batcher.CombinerV1(8,MaxSize)
+        split = rogue.protocols.batcher.SplitterV1()
+        prbsTx >> comb >> serv
+        client >> split >> prbsRx
+    else:
+        prbsTx >> serv
+        client >> prbsRx
+
+    time.sleep(2)
+
+    start = time.monotonic()
+    for _ in range(FrameCount):
+        prbsTx.genFrame(FrameSize)
+
+    if combine:
+        comb.flush()
+
+    cnt = 0
+    while prbsRx.getRxCount() != FrameCount and cnt < 600:
+        time.sleep(0.01)
+        cnt += 1
+
+    dur = time.monotonic() - start
+
+    print(f"TCP bridge combine={combine}: rx={prbsRx.getRxCount()} rate={prbsRx.getRxCount()/dur:.0f} Hz")
+
+    if prbsRx.getRxCount() != FrameCount:
+        raise AssertionError(f'Frame count error. Combine={combine} Got = {prbsRx.getRxCount()} expected = {FrameCount}')
+
+    if prbsRx.getRxErrors() != 0:
+        raise AssertionError(f'PRBS Frame errors detected! Combine={combine}')
+
+    serv._stop()
+    client._stop()
+
+def test_combiner_bridge():
+    bridge_rate(False,9010)
+    bridge_rate(True,9020)
+
+if __name__ == "__main__":
+    test_combiner_golden()
+    test_combiner_round_trip()
+    test_combiner_bridge()
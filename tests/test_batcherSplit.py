@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Batcher splitter small record benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.protocols.batcher
+import rogue.interfaces.stream
+import rogue.utilities
+import rogue
+import struct
+import time
+
+from test_batcherWorkers import FrameCapture, build_frames
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+RecordSize  = 64
+RecordCount = 14000
+SuperSize   = 1024 * 1024
+Repeat      = 100
+
+def test_batcher_tail():
+
+    # Width 8 super-frame: header, 8 byte record, tail with a crafted size
+    for size in [0xFFFFFFF9, 0xFFFFFFFF, 17]:
+        data = bytearray(24)
+        data[0] = 0x21
+        data[16:24] = struct.pack('<IBBBB', size, 1, 0, 0, 0)
+
+        # Contiguous frame, then a frame split across 8 byte buffers
+        for fixed in [0, 8]:
+            src   = rogue.interfaces.stream.Master()
+            split = rogue.protocols.batcher.SplitterV1()
+            cap   = FrameCapture()
+            src >> split >> cap
+
+            if fixed != 0:
+                split.setFixedSize(fixed)
+
+            frame = src._reqFrame(len(data),True)
+            frame.write(data,0)
+            src._sendFrame(frame)
+
+            if len(cap.frames) != 0:
+                raise AssertionError(f'Crafted tail accepted. Size={size:#x} Fixed={fixed} Records={len(cap.frames)}')
+
+def test_batcher_split():
+
+    # Build a 1 MB super-frame of PRBS records
+    frames = build_frames(RecordSize, RecordCount, SuperSize)
+
+    if len(frames) != 1:
+        raise AssertionError(f'Expected one super-frame, got {len(frames)}')
+
+    superFrame = frames[0]
+    src = rogue.interfaces.stream.Master()
+
+    # Single pass verifies the records
+    split  = rogue.protocols.batcher.SplitterV1()
+    prbsRx = rogue.utilities.Prbs()
+    hold   = FrameCapture()
+    src >> split >> prbsRx
+    split >> hold
+
+    src._sendFrame(superFrame)
+
+    if prbsRx.getRxCount() != RecordCount or prbsRx.getRxErrors() != 0:
+        raise AssertionError(f'Record error. Count={prbsRx.getRxCount()} Errors={prbsRx.getRxErrors()}')
+
+    if len(hold.frames) != RecordCount:
+        raise AssertionError(f'Held record count error. Got = {len(hold.frames)} expected = {RecordCount}')
+
+    # Held records reference the super-frame, a write to the first record
+    # after the 8 byte header is seen through the held frame
+    mark = bytearray([0xA5] * RecordSize)
+    superFrame.write(mark,8)
+
+    data = bytearray(RecordSize)
+    hold.frames[0].read(data,0)
+
+    if data != mark:
+        raise AssertionError('Record was copied from the super-frame')
+
+    # Record buffers are returned once released
+    hold.frames.clear()
+
+    if split.getAllocCount() != 0:
+        raise AssertionError(f'Record buffers not returned. Count={split.getAllocCount()}')
+
+    # Repeated super-frame, sequence errors are expected and ignored
+    src   = rogue.interfaces.stream.Master()
+    split = rogue.protocols.batcher.SplitterV1()
+    sink  = rogue.utilities.Prbs()
+    sink.checkPayload(False)
+    src >> split >> sink
+
+    start = time.monotonic()
+    for _ in range(Repeat):
+        src._sendFrame(superFrame)
+    dur = time.monotonic() - start
+
+    print(f"Batcher split records={RecordSize} bytes super={superFrame.getPayload()} bytes: " +
+          f"rate={Repeat*RecordCount/dur/1e6:.2f} M records/s")
+
+    if sink.getRxCount() != Repeat * RecordCount:
+        raise AssertionError(f'Record count error. Got = {sink.getRxCount()} expected = {Repeat * RecordCount}')
+
+if __name__ == "__main__":
+    test_batcher_split()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Batcher splitter worker pool test
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.protocols.batcher
+import rogue.interfaces.stream
+import rogue.utilities
+import rogue
+import time
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+RecordSize  = 256
+RecordCount = 50000
+SuperSize   = 64 * 1024
+Workers     = 4
+
+# Captures and holds received frames
+class FrameCapture(rogue.interfaces.stream.Slave):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        self.frames = []
+
+    def _acceptFrame(self,frame):
+        self.frames.append(frame)
+
+# Builds super-frames of PRBS records, also used by test_batcherSplit
+def build_frames(recordSize=RecordSize, recordCount=RecordCount, superSize=SuperSize):
+    prbsTx = rogue.utilities.Prbs()
+    comb   = rogue.protocols.batcher.CombinerV1(8,superSize)
+    cap    = FrameCapture()
+
+    comb.setTimeout(0)
+    prbsTx >> comb >> cap
+
+    for _ in range(recordCount):
+        prbsTx.genFrame(recordSize)
+
+    comb.flush()
+    return cap.frames
+
+def split_frames(frames, workers, ordered):
+    src    = rogue.interfaces.stream.Master()
+    split  = rogue.protocols.batcher.SplitterV1()
+    prbsRx = rogue.utilities.Prbs()
+
+    split.setOrdered(ordered)
+    split.setWorkers(workers)
+    src >> split >> prbsRx
+
+    if split.getWorkers() != workers:
+        raise AssertionError(f'Worker count mismatch {split.getWorkers()}')
+
+    # Time spent in the sending thread
+    start = time.monotonic()
+    for frame in frames:
+        src._sendFrame(frame)
+    sent = time.monotonic() - start
+
+    cnt = 0
+    while prbsRx.getRxCount() != RecordCount and cnt < 1000:
+        time.sleep(0.001)
+        cnt += 1
+
+    done = time.monotonic() - start
+    split.setWorkers(0)
+
+    print(f"Batcher split workers={workers} ordered={ordered}: super-frames={len(frames)} " +
+          f"caller={sent*1e3:.1f} ms total={done*1e3:.1f} ms rate={RecordCount/done/1e6:.2f} M records/s")
+
+    if prbsRx.getRxCount() != RecordCount:
+        raise AssertionError(f'Record count error. Workers={workers} Got = {prbsRx.getRxCount()} expected = {RecordCount}')
+
+    # PRBS sequence is only preserved in order
+    if ordered and prbsRx.getRxErrors() != 0:
+        raise AssertionError(f'Record order errors detected! Workers={workers} Errors={prbsRx.getRxErrors()}')
+
+def test_batcher_workers():
+    frames = build_frames()
+
+    split_frames(frames, 0,       True)
+    split_frames(frames, Workers, True)
+    split_frames(frames, Workers, False)
+
+if __name__ == "__main__":
+    test_batcher_workers()
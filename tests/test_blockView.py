@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Block numpy view test
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import pyrogue as pr
+import rogue.interfaces.memory
+import numpy as np
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+class ViewDev(pr.Device):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+
+        # All registers share a single block
+        self.addCustomBlock(rogue.interfaces.memory.Block(0,64))
+
+        for i in range(16):
+            self.add(pr.RemoteVariable(
+                name      = f'Reg[{i}]',
+                offset    = 4*i,
+                bitSize   = 32,
+                bitOffset = 0,
+                base      = pr.UInt,
+                mode      = 'RW',
+            ))
+
+
+class ViewTree(pr.Root):
+
+    def __init__(self):
+        pr.Root.__init__(self,
+                         name='viewTree',
+                         description="Block view tree",
+                         timeout=2.0,
+                         pollEn=False,
+                         serverPort=None)
+
+        self.sim = rogue.interfaces.memory.Emulate(4,0x1000)
+        self.addInterface(self.sim)
+
+        self.add(ViewDev(name='ViewDev', offset=0, memBase=self.sim))
+
+
+def test_block_view():
+
+    with ViewTree() as root:
+        blk = root.ViewDev.Reg[0]._block
+
+        data = blk.data
+        vData = blk.verifyData
+        vMask = blk.verifyMask
+
+        for view in [data, vData, vMask]:
+            if view.dtype != np.uint8 or len(view) != blk.size or view.flags.writeable:
+                raise AssertionError(f'Unexpected view dtype={view.dtype}, len={len(view)}, writeable={view.flags.writeable}')
+
+        # Views reference the block buffers, not copies
+        if not np.shares_memory(data, blk.data):
+            raise AssertionError('Block data view is not aliased to the block buffer')
+
+        if np.shares_memory(data, vData) or np.shares_memory(data, vMask):
+            raise AssertionError('Block data view overlaps verify buffers')
+
+        # Write through the block is visible in the existing view
+        root.ViewDev.Reg[3].set(0x11223344)
+
+        if bytes(data[12:16]) != (0x11223344).to_bytes(4,'little'):
+            raise AssertionError(f'Write not visible in data view: {bytes(data[12:16]).hex()}')
+
+        # Verify read back of the written register lands in the verify buffer
+        if bytes(vMask[12:16]) != b'\xff\xff\xff\xff':
+            raise AssertionError(f'Unexpected verify mask {bytes(vMask[12:16]).hex()}')
+
+        if bytes(vData[12:16]) != bytes(data[12:16]):
+            raise AssertionError(f'Verify data mismatch {bytes(vData[12:16]).hex()}')
+
+        # Data written behind the block is visible after a read, still without a new view
+        mast = rogue.interfaces.memory.Master()
+        mast._setSlave(root.sim)
+        mast._reqTransaction(20, bytearray((0xdeadbeef).to_bytes(4,'little')), 4, 0, rogue.interfaces.memory.Write)
+        mast._waitTransaction(0)
+
+        # Each completed transaction increments the version
+        ver = blk.version
+
+        for i in range(5):
+            root.ViewDev.Reg[5].get()
+
+        if blk.version != ver + 5:
+            raise AssertionError(f'Unexpected version {blk.version}, expected {ver + 5}')
+
+        # Checks without a started transaction leave the version unchanged
+        ver = blk.version
+        blk._checkTransaction()
+        root.ViewDev.writeBlocks(force=False)
+        root.ViewDev.checkBlocks()
+
+        if blk.version != ver:
+            raise AssertionError(f'Version changed without a transaction {blk.version}, expected {ver}')
+
+        # Write and verify sequence completes with a single check
+        root.ViewDev.Reg[5].set(0xdeadbeef)
+
+        if blk.version != ver + 1:
+            raise AssertionError(f'Unexpected version after write {blk.version}, expected {ver + 1}')
+
+        if bytes(data[20:24]) != (0xdeadbeef).to_bytes(4,'little'):
+            raise AssertionError(f'Read not visible in data view: {bytes(data[20:24]).hex()}')
+
+    # Views keep the block buffer alive after the tree is gone
+    del root
+    if bytes(data[12:16]) != (0x11223344).to_bytes(4,'little'):
+        raise AssertionError('Block data view invalid after tree was released')
+
+
+if __name__ == "__main__":
+    test_block_view()
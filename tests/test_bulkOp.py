@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Concurrent bulk block operation test
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import pyrogue as pr
+import pyrogue.interfaces.simulation
+import rogue.interfaces.memory
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+class BulkDev(pr.Device):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+
+        for i in range(256):
+            self.add(pr.RemoteVariable(
+                name      = f'Reg[{i}]',
+                offset    = 4*i,
+                bitSize   = 32,
+                bitOffset = 0,
+                base      = pr.UInt,
+                mode      = 'RW',
+            ))
+
+
+class CountVariable(pr.RemoteVariable):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+        self.updateCount = 0
+
+    def _queueUpdate(self):
+        self.updateCount += 1
+        super()._queueUpdate()
+
+
+class CountDev(pr.Device):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+
+        for i in range(8):
+            self.add(CountVariable(
+                name      = f'Reg[{i}]',
+                offset    = 4*i,
+                bitSize   = 32,
+                bitOffset = 0,
+                base      = pr.UInt,
+                mode      = 'RW',
+            ))
+
+
+class FailEmulate(pyrogue.interfaces.simulation.MemEmulate):
+    """Memory emulator which fails writes to a single address and records verify transactions"""
+
+    def __init__(self, failAddr):
+        super().__init__()
+        self.failAddr = failAddr
+        self.verified = []
+
+    def _doTransaction(self,transaction):
+        if transaction.type() == rogue.interfaces.memory.Write and transaction.address() == self.failAddr:
+            transaction.error(f"Write failure at {self.failAddr:#x}")
+            return
+
+        if transaction.type() == rogue.interfaces.memory.Verify:
+            self.verified.append(transaction.address())
+
+        super()._doTransaction(transaction)
+
+
+class BulkTree(pr.Root):
+
+    def __init__(self, bulkDepth):
+        pr.Root.__init__(self,
+                         name='bulkTree',
+                         description="Bulk operation tree",
+                         timeout=2.0,
+                         pollEn=False,
+                         bulkDepth=bulkDepth,
+                         serverPort=None)
+
+        # Two independent slaves, each served by its own bulk group
+        self.simA = rogue.interfaces.memory.Emulate(4,0x1000)
+        self.addInterface(self.simA)
+
+        self.simB = rogue.interfaces.memory.Emulate(4,0x1000)
+        self.addInterface(self.simB)
+
+        for i in range(4):
+            self.add(BulkDev(
+                name    = f'BulkDev[{i}]',
+                offset  = i*0x10000,
+                memBase = self.simA if i < 2 else self.simB,
+            ))
+
+        # Device which checks each transaction stays on the python path
+        self.add(BulkDev(
+            name    = 'CheckDev',
+            offset  = 0x40000,
+            memBase = self.simA,
+        ))
+        self.CheckDev.forceCheckEach = True
+
+
+class CheckTree(pr.Root):
+
+    def __init__(self):
+        pr.Root.__init__(self,
+                         name='checkTree',
+                         description="Bulk operation check tree",
+                         timeout=2.0,
+                         pollEn=False,
+                         bulkDepth=4,
+                         serverPort=None)
+
+        self.sim = FailEmulate(failAddr=0x8)
+        self.addInterface(self.sim)
+
+        self.add(CountDev(
+            name    = 'CountDev',
+            offset  = 0,
+            memBase = self.sim,
+        ))
+
+
+def test_bulk_op():
+
+    with BulkTree(bulkDepth=8) as root:
+
+        if root._bulk.getGroupCount() != 2:
+            raise AssertionError(f'Unexpected bulk group count {root._bulk.getGroupCount()}')
+
+        if root._bulkDevices != [root.CheckDev]:
+            raise AssertionError('forceCheckEach device not handled in python')
+
+        for i in range(256):
+            root.CheckDev.Reg[i].set(i,write=False)
+
+        for dev in range(4):
+            for i in range(256):
+                root.BulkDev[dev].Reg[i].set(dev*1000+i,write=False)
+
+        root.WriteAll()
+
+        root.ReadAll()
+
+        for dev in range(4):
+            for i in range(256):
+                ret = root.BulkDev[dev].Reg[i].value()
+                if ret != dev*1000+i:
+                    raise AssertionError(f'Bulk verification failure: dev={dev}, i={i}, ret={ret}')
+
+        for i in range(256):
+            ret = root.CheckDev.Reg[i].value()
+            if ret != i:
+                raise AssertionError(f'Python path verification failure: i={i}, ret={ret}')
+
+        for sim in [root.simA, root.simB]:
+            if sim.getTransactionCount() == 0:
+                raise AssertionError('Bulk operation did not reach both slaves')
+
+            if sim.getPageCount() != 2:
+                raise AssertionError(f'Unexpected page count {sim.getPageCount()}')
+
+
+def test_bulk_check():
+
+    with CheckTree() as root:
+
+        # Each block generates a single update for the write and verify sequence
+        for i in range(8):
+            root.CountDev.Reg[i].set(i+1,write=False)
+            root.CountDev.Reg[i].updateCount = 0
+
+        err = None
+        try:
+            root.WriteAll()
+        except Exception as e:
+            err = e
+
+        if err is None:
+            raise AssertionError('Write error was not reported')
+
+        for i in range(8):
+            cnt = root.CountDev.Reg[i].updateCount
+            exp = 0 if i == 2 else 1
+            if cnt != exp:
+                raise AssertionError(f'Unexpected update count {cnt} for register {i}, expected {exp}')
+
+        # Block with the failed write is not verified
+        if 0x8 in root.sim.verified:
+            raise AssertionError('Block with failed write was verified')
+
+        if sorted(root.sim.verified) != [4*i for i in range(8) if i != 2]:
+            raise AssertionError(f'Unexpected verify list {root.sim.verified}')
+
+
+if __name__ == "__main__":
+    test_bulk_op()
+    test_bulk_check()
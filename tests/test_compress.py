@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : LZ4 and Zstd stream compression test and benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.interfaces.stream
+import rogue.utilities
+import rogue
+import numpy as np
+import tempfile
+import time
+import os
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+PrbsCount    = 500
+PrbsSize     = 100000
+DetCount     = 200
+DetSize      = 65536
+SmallCount   = 2000
+SmallSize    = 256
+Workers      = 4
+
+# Not included when rogue is built without lz4 and zstd
+Enabled = hasattr(rogue.utilities,'StreamCompress')
+
+Codecs = { 'lz4'  : rogue.utilities.StreamCompress.Lz4,
+           'zstd' : rogue.utilities.StreamCompress.Zstd } if Enabled else {}
+
+# Captures frames after decompression
+class FrameCapture(rogue.interfaces.stream.Slave):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        self.frames = []
+
+    def _acceptFrame(self,frame):
+        with frame.lock():
+            self.frames.append(bytes(frame.getNumpy(0,frame.getPayload())))
+
+# Sends prepared payloads
+class FrameSource(rogue.interfaces.stream.Master):
+
+    def send(self,data):
+        frame = self._reqFrame(len(data),True)
+        frame.write(bytearray(data),0)
+        self._sendFrame(frame)
+
+# Pedestal, noise and sparse hits, 16-bit pixels
+def detector_frames(count, size, rng):
+    ret = []
+    for _ in range(count):
+        pix = 1000 + (np.arange(size//2) % 64) + rng.normal(0,3,size//2)
+        hit = rng.random(size//2) < 0.01
+        pix[hit] += rng.random(hit.sum()) * 2000
+        ret.append(pix.astype(np.uint16).tobytes())
+    return ret
+
+def wait_count(rx, count):
+    cnt = 0
+    while rx() != count and cnt < 5000:
+        time.sleep(0.001)
+        cnt += 1
+
+def run_prbs(name, comp, decomp, workers=0):
+    prbsTx = rogue.utilities.Prbs()
+    prbsRx = rogue.utilities.Prbs()
+
+    if workers:
+        comp.setWorkers(workers)
+        decomp.setWorkers(workers)
+
+    prbsTx >> comp >> decomp >> prbsRx
+
+    count = PrbsCount if name != 'bzip2' else PrbsCount // 20
+
+    start = time.monotonic()
+    for _ in range(count):
+        prbsTx.genFrame(PrbsSize)
+
+    wait_count(prbsRx.getRxCount, count)
+    dtime = time.monotonic() - start
+
+    ratio = comp.getInBytes() / comp.getOutBytes() if name != 'bzip2' else 1.0
+
+    print(f"PRBS     {name:5} workers={workers}: {count*PrbsSize/dtime/1e6:7.1f} MB/s ratio={ratio:.2f}")
+
+    if prbsRx.getRxCount() != count:
+        raise AssertionError(f'{name}: Frame count error. Got = {prbsRx.getRxCount()} expected = {count}')
+
+    if prbsRx.getRxErrors() != 0:
+        raise AssertionError(f'{name}: PRBS errors detected')
+
+def run_frames(name, frames, codec, workers=0, dictionary=''):
+    src    = FrameSource()
+    comp   = rogue.utilities.StreamCompress(codec, 1)
+    decomp = rogue.utilities.StreamDecompress()
+    cap    = FrameCapture()
+
+    comp.setDictionary(dictionary)
+    decomp.setDictionary(dictionary)
+    comp.setWorkers(workers)
+    decomp.setWorkers(workers)
+
+    src >> comp >> decomp >> cap
+
+    start = time.monotonic()
+    for data in frames:
+        src.send(data)
+
+    wait_count(lambda: len(cap.frames), len(frames))
+    dtime = time.monotonic() - start
+
+    ratio = comp.getInBytes() / comp.getOutBytes()
+    print(f"{name:8} {'lz4' if codec == Codecs['lz4'] else 'zstd':5} workers={workers} dict={dictionary != ''}: " +
+          f"{sum(len(d) for d in frames)/dtime/1e6:7.1f} MB/s ratio={ratio:.2f}")
+
+    comp.setWorkers(0)
+    decomp.setWorkers(0)
+
+    if cap.frames != frames:
+        raise AssertionError(f'{name}: Frame mismatch after decompression')
+
+    return ratio
+
+def test_compress():
+    if not Enabled:
+        return
+
+    rng = np.random.default_rng(1)
+
+    # PRBS data is not compressible, measures the cost of passing through
+    run_prbs('bzip2', rogue.utilities.StreamZip(), rogue.utilities.StreamUnZip())
+
+    for name, codec in Codecs.items():
+        run_prbs(name, rogue.utilities.StreamCompress(codec), rogue.utilities.StreamDecompress())
+        run_prbs(name, rogue.utilities.StreamCompress(codec), rogue.utilities.StreamDecompress(), Workers)
+
+    det   = detector_frames(DetCount, DetSize, rng)
+    small = detector_frames(SmallCount, SmallSize, rng)
+
+    with tempfile.TemporaryDirectory() as tmp:
+
+        # Raw content dictionary from sample frames
+        dictFile = os.path.join(tmp,'frames.dict')
+        with open(dictFile,'wb') as f:
+            for data in detector_frames(64, SmallSize, rng):
+                f.write(data)
+
+        for name, codec in Codecs.items():
+            run_frames('detector', det, codec)
+            run_frames('detector', det, codec, Workers)
+
+            plain    = run_frames('small', small, codec)
+            withDict = run_frames('small', small, codec, Workers, dictFile)
+
+            if withDict <= plain:
+                raise AssertionError(f'{name}: Dictionary did not improve ratio {withDict:.2f} <= {plain:.2f}')
+
+        # Dictionary mismatch is detected
+        src    = FrameSource()
+        comp   = rogue.utilities.StreamCompress(Codecs['lz4'])
+        decomp = rogue.utilities.StreamDecompress()
+        comp.setDictionary(dictFile)
+        src >> comp >> decomp
+
+        try:
+            src.send(small[0])
+        except Exception:
+            pass
+        else:
+            raise AssertionError('Dictionary mismatch was not detected')
+
+    # Frames larger than the max size are rejected before decompression
+    for name, codec in Codecs.items():
+        src    = FrameSource()
+        comp   = rogue.utilities.StreamCompress(codec)
+        decomp = rogue.utilities.StreamDecompress()
+        decomp.setMaxSize(DetSize // 2)
+        src >> comp >> decomp
+
+        try:
+            src.send(det[0])
+        except Exception:
+            pass
+        else:
+            raise AssertionError(f'{name}: Frame over max size was not rejected')
+
+    # LZ4 header without payload
+    src    = FrameSource()
+    decomp = rogue.utilities.StreamDecompress()
+    src >> decomp
+
+    try:
+        src.send(np.array([0x345A4C52, 0x40000000, 0], dtype=np.uint32).tobytes())
+    except Exception:
+        pass
+    else:
+        raise AssertionError('Truncated LZ4 frame was not rejected')
+
+if __name__ == "__main__":
+    test_compress()
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : CRC-32 implementation consistency and throughput
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import random
+import time
+import zlib
+
+Crc32 = rogue.utilities.Crc32
+
+Impls = { 'table'   : Crc32.Table,
+          'slice16' : Crc32.Slice16,
+          'clmul'   : Crc32.Clmul,
+          'armcrc'  : Crc32.ArmCrc,
+          'auto'    : Crc32.Auto }
+
+def test_crc32_exact():
+    rng  = random.Random(1)
+    data = bytes(rng.getrandbits(8) for _ in range(8192))
+
+    impls = {k:v for k,v in Impls.items() if Crc32.supported(v)}
+    print(f"CRC-32 auto={Crc32.implName()} supported={list(impls.keys())}")
+
+    for _ in range(2000):
+        off  = rng.randrange(16)
+        size = rng.randrange(5000)
+        seed = rng.choice([0, rng.getrandbits(32)])
+        buf  = data[off:off+size]
+        ref  = zlib.crc32(buf,seed)
+
+        for name,impl in impls.items():
+            crc = Crc32.computeImpl(impl,buf,seed)
+            if crc != ref:
+                raise AssertionError(f'CRC mismatch impl={name} off={off} size={size} seed={seed:#x} got={crc:#x} exp={ref:#x}')
+
+    # Continuation across buffers matches a single pass
+    for name,impl in impls.items():
+        crc = 0
+        for i in range(0,len(data),1000):
+            crc = Crc32.computeImpl(impl,data[i:i+1000],crc)
+
+        if crc != Crc32.compute(data):
+            raise AssertionError(f'CRC continuation mismatch impl={name}')
+
+def test_crc32_rate():
+    data  = bytearray(random.Random(2).getrandbits(8) for _ in range(1 << 20))
+    count = 200
+
+    for name,impl in Impls.items():
+        if not Crc32.supported(impl):
+            continue
+
+        start = time.monotonic()
+        for _ in range(count):
+            Crc32.computeImpl(impl,data)
+        dur = time.monotonic() - start
+
+        print(f"CRC-32 impl={name}: {count*len(data)/dur/1e9:.2f} GB/s")
+
+if __name__ == "__main__":
+    test_crc32_exact()
+    test_crc32_rate()
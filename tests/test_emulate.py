@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Native memory emulator test
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import pyrogue as pr
+import rogue.interfaces.memory
+import os
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+class EmuDev(pr.Device):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+
+        for i in range(256):
+            self.add(pr.RemoteVariable(
+                name      = f'Reg[{i}]',
+                offset    = 4*i,
+                bitSize   = 32,
+                bitOffset = 0,
+                base      = pr.UInt,
+                mode      = 'RW',
+            ))
+
+
+class EmuTree(pr.Root):
+
+    def __init__(self, fileName=None):
+        pr.Root.__init__(self,
+                         name='emuTree',
+                         description="Emulated memory tree",
+                         timeout=2.0,
+                         pollEn=False,
+                         serverPort=None)
+
+        self.sim = rogue.interfaces.memory.Emulate(4,0x1000)
+        self.addInterface(self.sim)
+
+        if fileName is not None:
+            self.sim.mapFile(fileName,0x100000)
+
+        # Devices far apart in the address space to exercise the sparse page map
+        for i in range(4):
+            self.add(EmuDev(
+                name    = f'EmuDev[{i}]',
+                offset  = i*0x10000,
+                memBase = self.sim,
+            ))
+
+
+def test_emulate():
+
+    with EmuTree() as root:
+
+        if root.EmuDev[0].Reg[10].get() != 0:
+            raise AssertionError('Unwritten emulated memory did not read back as zero')
+
+        for dev in range(4):
+            for i in range(256):
+                root.EmuDev[dev].Reg[i].set(dev*1000+i)
+
+        for dev in range(4):
+            for i in range(256):
+                ret = root.EmuDev[dev].Reg[i].get()
+                if ret != dev*1000+i:
+                    raise AssertionError(f'Verification failure: dev={dev}, i={i}, ret={ret}')
+
+        if root.sim.getPageCount() != 4:
+            raise AssertionError(f'Unexpected page count {root.sim.getPageCount()}')
+
+        # Native rate test, threads share the emulated space above the devices
+        gen = rogue.interfaces.memory.TrafficGen()
+        gen >> root.sim
+
+        for threads in [1,4]:
+            for size in [4,0x1000]:
+                gen.run(threads,10000,size,0x100000,0x100000)
+
+                print(f'Emulated threads={threads} size={size}: ' +
+                      f'{gen.getRate():.0f} Hz, {gen.getBandwidth()/1e6:.1f} MB/s')
+
+                if gen.getErrorCount() != 0:
+                    raise AssertionError(f'Traffic generator errors: threads={threads} size={size} errors={gen.getErrorCount()}')
+
+
+def test_emulate_file():
+    fileName = 'emulate.bin'
+
+    with EmuTree(fileName=fileName) as root:
+        root.EmuDev[0].Reg[5].set(0x12345678)
+
+    with EmuTree(fileName=fileName) as root:
+        ret = root.EmuDev[0].Reg[5].get()
+
+        # Accesses past the end of the file, including address wrap, are rejected
+        gen = rogue.interfaces.memory.TrafficGen()
+        gen >> root.sim
+
+        for base in [0x100000-8, 2**64-16]:
+            gen.run(1,1,16,base,16)
+
+            if gen.getErrorCount() != 1:
+                raise AssertionError(f'Out of bounds access at {base:#x} was not rejected')
+
+    os.remove(fileName)
+
+    if ret != 0x12345678:
+        raise AssertionError(f'File backed emulation did not persist: ret={ret:#x}')
+
+
+if __name__ == "__main__":
+    test_emulate()
+    test_emulate_file()
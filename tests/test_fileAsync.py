@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Asynchronous file write benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.utilities.fileio
+import rogue
+import tempfile
+import time
+import os
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+FrameCount = 20000
+FrameSize  = 10000
+BufferSize = 1048576
+MaxSize    = 50000000
+
+def write_file(path, asyncCount, direct):
+
+    fwr = rogue.utilities.fileio.StreamWriter()
+    fwr.setBufferSize(BufferSize)
+    fwr.setMaxSize(MaxSize)
+    fwr.setAsync(asyncCount)
+    fwr.setDirect(direct)
+
+    prbs = rogue.utilities.Prbs()
+    prbs >> fwr.getChannel(0)
+
+    fwr.open(path)
+
+    stime = time.time()
+    for _ in range(FrameCount):
+        prbs.genFrame(FrameSize)
+
+    # Close returns once all staging buffers are written
+    fwr.close()
+    dtime = time.time() - stime
+
+    print(f"Write async={asyncCount} direct={direct}: {FrameCount/dtime:.0f} Hz " +
+          f"bw={8.0*fwr.getTotalSize()/dtime/1e9:.2f} Gbps")
+
+    if fwr.getFrameCount() != FrameCount:
+        raise AssertionError(f'Incorrect frame count. Got = {fwr.getFrameCount()} expected = {FrameCount}')
+
+    if fwr.getDropCount() != 0:
+        raise AssertionError(f'Frames dropped: {fwr.getDropCount()}')
+
+    # Every byte reported by the writer is on disk across the rolled over files
+    files = [f'{path}.{idx}' for idx in range(1,100) if os.path.exists(f'{path}.{idx}')]
+    total = sum(os.path.getsize(f) for f in files)
+
+    if total != fwr.getTotalSize():
+        raise AssertionError(f'File size mismatch. Got = {total} expected = {fwr.getTotalSize()}')
+
+    return files
+
+def read_files(files):
+
+    frd  = rogue.utilities.fileio.StreamReader()
+    prbs = rogue.utilities.Prbs()
+
+    frd >> prbs
+
+    frd.open(files[0])
+    frd.closeWait()
+
+    if prbs.getRxCount() != FrameCount:
+        raise AssertionError(f'Incorrect number of frames read. Got = {prbs.getRxCount()} expected = {FrameCount}')
+
+    if prbs.getRxErrors() != 0:
+        raise AssertionError('PRBS errors detected')
+
+def file_async(base):
+
+    for asyncCount,direct in [(0,False),(4,False),(4,True)]:
+        with tempfile.TemporaryDirectory(dir=base) as tmp:
+            files = write_file(os.path.join(tmp,'data.dat'), asyncCount, direct)
+            read_files(files)
+
+# Descriptors open on a path, Linux only
+def open_count(path):
+    fds = '/proc/self/fd'
+    return sum(1 for fd in os.listdir(fds) if os.path.realpath(os.path.join(fds,fd)) == path)
+
+def file_error():
+
+    fwr = rogue.utilities.fileio.StreamWriter()
+    fwr.setBufferSize(4096)
+    fwr.setAsync(2)
+
+    prbs = rogue.utilities.Prbs()
+    prbs >> fwr.getChannel(0)
+
+    # Every write to /dev/full fails, the file is closed when the next frame arrives
+    fwr.open('/dev/full')
+
+    for _ in range(20):
+        prbs.genFrame(3000)
+        time.sleep(0.002)
+
+    if open_count('/dev/full') != 0:
+        raise AssertionError('File not closed after asynchronous write failure')
+
+    fwr.close()
+
+def test_file_async():
+
+    if os.path.exists('/dev/full') and os.path.isdir('/proc/self/fd'):
+        file_error()
+
+    # tmpfs when available, then the local file system
+    if os.path.isdir('/dev/shm'):
+        file_async('/dev/shm')
+
+    file_async(None)
+
+if __name__ == "__main__":
+    test_file_async()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : File index, seek and channel filter test
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.utilities.fileio
+import rogue
+import tempfile
+import struct
+import os
+
+from test_fileMapped import write_file, read_file
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+FrameCount = 10000
+FrameSize  = 1000
+MaxSize    = 1000003
+
+def check_reads(path):
+
+    frd, prbs, dtime = read_file(path, channel=1)
+    if prbs.getRxCount() != FrameCount//2:
+        raise AssertionError(f'Channel filter read {prbs.getRxCount()} frames, expected {FrameCount//2}')
+
+    frd, prbs, dtime = read_file(path, first=5000, count=1000, channel=0)
+    if prbs.getRxCount() != 500:
+        raise AssertionError(f'Range read {prbs.getRxCount()} frames, expected 500')
+
+    # Parallel range reads cover the data set once
+    readers = []
+    for i in range(4):
+        frd  = rogue.utilities.fileio.StreamReader()
+        prbs = rogue.utilities.Prbs()
+        frd >> prbs
+        frd.setRange(i*FrameCount//4, FrameCount//4)
+        frd.filterChannel(0)
+        frd.open(path)
+        readers.append((frd,prbs))
+
+    total = 0
+    for frd,prbs in readers:
+        frd.closeWait()
+        total += prbs.getRxCount()
+
+        if prbs.getRxErrors() != 0:
+            raise AssertionError('PRBS errors detected in parallel read')
+
+    if total != FrameCount//2:
+        raise AssertionError(f'Parallel reads got {total} frames, expected {FrameCount//2}')
+
+def read_index(path):
+
+    # Header followed by frame, offset, size, meta, file and time for each entry
+    with open(path,'rb') as f:
+        data = f.read()
+
+    return [e[:5] for e in struct.iter_unpack('QQIIII',data[8:])]
+
+def test_file_index():
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp,'data.dat')
+        # Even frames on channel 0, odd frames on channel 1
+        write_file(path, count=FrameCount, size=FrameSize, maxSize=MaxSize, bufferSize=100000, channels=2)
+
+        idx = rogue.utilities.fileio.StreamIndex()
+        if not idx.load(path + '.1') or idx.getCount() != FrameCount:
+            raise AssertionError(f'Index has {idx.getCount()} entries, expected {FrameCount}')
+
+        # Frame, channel, file, offset, size, flags, error
+        entry = idx.getEntry(idx.find(FrameCount-1))
+        if entry[0] != FrameCount-1 or entry[1] != 1 or entry[4] != FrameSize:
+            raise AssertionError(f'Bad index entry {entry}')
+
+        check_reads(path + '.1')
+
+        # Rebuilt index matches the one written, except for the frame times
+        written = read_index(path + '.idx')
+
+        if rogue.utilities.fileio.StreamIndex.rebuild(path + '.1') != FrameCount:
+            raise AssertionError('Rebuild frame count mismatch')
+
+        if read_index(path + '.idx') != written:
+            raise AssertionError('Rebuilt index does not match')
+
+        # Without an index the same reads scan the frame headers
+        os.remove(path + '.idx')
+        check_reads(path + '.1')
+
+if __name__ == "__main__":
+    test_file_index()
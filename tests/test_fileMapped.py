@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Memory mapped file replay benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.interfaces.stream
+import rogue.utilities
+import rogue.utilities.fileio
+import rogue
+import tempfile
+import struct
+import time
+import os
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+FrameCount = 2000
+FrameSize  = 100000
+MaxSize    = 50000000
+
+# Captures and holds received frames
+class FrameCapture(rogue.interfaces.stream.Slave):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        self.frames = []
+
+    def _acceptFrame(self,frame):
+        self.frames.append(frame)
+
+# Writes PRBS frames with an index, frames rotate through the channels.
+# Also used by test_filePrefetch and test_fileIndex
+def write_file(path, count=FrameCount, size=FrameSize, maxSize=MaxSize, bufferSize=1048576, channels=1):
+
+    fwr = rogue.utilities.fileio.StreamWriter()
+    fwr.setBufferSize(bufferSize)
+    fwr.setMaxSize(maxSize)
+    fwr.setIndex(True)
+
+    prbs = [rogue.utilities.Prbs() for _ in range(channels)]
+
+    for i in range(channels):
+        prbs[i] >> fwr.getChannel(i)
+
+    fwr.open(path)
+
+    for i in range(count):
+        prbs[i % channels].genFrame(size)
+
+    fwr.close()
+
+# Reads a file into a PRBS checker, returns the reader, the checker and the read time.
+# Settings are passed to the matching reader setter
+def read_file(path, hold=None, first=0, count=0, channel=None, mapped=False, rate=0, timing=0, depth=0, threads=1):
+
+    frd  = rogue.utilities.fileio.StreamReader()
+    prbs = rogue.utilities.Prbs()
+
+    frd >> prbs
+
+    if hold is not None:
+        frd >> hold
+
+    frd.setRange(first,count)
+    if channel is not None:
+        frd.filterChannel(channel)
+
+    frd.setMapped(mapped)
+    frd.setRate(rate)
+    frd.setTiming(timing)
+    frd.setPrefetchDepth(depth)
+    frd.setPrefetchThreads(threads)
+
+    stime = time.time()
+    frd.open(path)
+    frd.closeWait()
+    dtime = time.time() - stime
+
+    if prbs.getRxErrors() != 0:
+        raise AssertionError(f'PRBS errors detected. mapped={mapped} first={first} count={count} channel={channel}')
+
+    return frd, prbs, dtime
+
+def check_read(path, **config):
+    frd, prbs, dtime = read_file(path, **config)
+
+    print(f"Read {config}: {prbs.getRxCount()/dtime:.0f} Hz " +
+          f"bw={8.0*prbs.getRxBytes()/dtime/1e9:.2f} Gbps")
+
+    if prbs.getRxCount() != FrameCount:
+        raise AssertionError(f'Incorrect number of frames read. Got = {prbs.getRxCount()} expected = {FrameCount}')
+
+    return dtime
+
+def test_file_mapped():
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp,'data.dat')
+        write_file(path)
+
+        check_read(path + '.1', mapped=False)
+        check_read(path + '.1', mapped=True)
+
+        # Fixed rate replay
+        dtime = check_read(path + '.1', mapped=True, rate=10000)
+        if dtime < FrameCount / 10000:
+            raise AssertionError(f'Rate limited replay took {dtime:.3f} seconds')
+
+def test_file_mapped_zero_copy():
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp,'data.dat')
+        write_file(path, count=100, size=1000)
+
+        for mapped in [False, True]:
+            hold = FrameCapture()
+            frd, prbs, dtime = read_file(path + '.1', hold=hold, mapped=mapped)
+
+            if len(hold.frames) != 100:
+                raise AssertionError(f'Held {len(hold.frames)} frames, expected 100')
+
+            # Read frames are allocated by the receiver, mapped buffers by the reader
+            if frd.getAllocCount() != (100 if mapped else 0):
+                raise AssertionError(f'Reader allocated {frd.getAllocCount()} buffers. mapped={mapped}')
+
+            # Overwrite the first frame in the file, after its size and flags header
+            mark = bytes([0xA5] * 1000)
+            with open(path + '.1','r+b') as f:
+                orig = bytearray(f.read(1008))[8:]
+                f.seek(8)
+                f.write(mark)
+
+            data = bytearray(1000)
+            hold.frames[0].read(data,0)
+
+            # Mapped frames reference the file, read frames hold a copy
+            if data != (mark if mapped else orig):
+                raise AssertionError(f'Frame data does not match. mapped={mapped}')
+
+            with open(path + '.1','r+b') as f:
+                f.seek(8)
+                f.write(orig)
+
+            # Mappings are released with the frames
+            hold.frames.clear()
+
+            if frd.getAllocCount() != 0:
+                raise AssertionError(f'Reader buffers not returned. Count={frd.getAllocCount()}')
+
+def test_file_timing():
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp,'data.dat')
+        write_file(path, count=100, size=1000)
+
+        # Replace the recorded frame times with 10 ms deltas
+        with open(path + '.idx','r+b') as f:
+            data = bytearray(f.read())
+
+            for i in range(100):
+                struct.pack_into('<I', data, 8 + i*32 + 28, 10000)
+
+            f.seek(0)
+            f.write(data)
+
+        # Speed, first frame and expected duration
+        for speed, first, exp in [(1, 0, 1.0), (4, 0, 0.25), (2, 50, 0.25)]:
+            for mapped in [False, True]:
+                frd, prbs, dtime = read_file(path + '.1', first=first, mapped=mapped, timing=speed)
+
+                print(f"Timing replay speed={speed} first={first} mapped={mapped}: {dtime:.3f} seconds")
+
+                if prbs.getRxCount() != 100 - first:
+                    raise AssertionError(f'Timing replay read {prbs.getRxCount()} frames, expected {100 - first}')
+
+                if dtime < exp * 0.95 or dtime > exp + 0.5:
+                    raise AssertionError(f'Timing replay speed={speed} first={first} mapped={mapped} took {dtime:.3f} seconds, expected {exp}')
+
+if __name__ == "__main__":
+    test_file_mapped()
+    test_file_mapped_zero_copy()
+    test_file_timing()
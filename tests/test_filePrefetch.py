@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Prefetched file read benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.utilities.fileio
+import rogue
+import tempfile
+import os
+
+from test_fileMapped import FrameCount, write_file, read_file
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+# Smaller files than the mapped test so there are files to prefetch
+MaxSize = 20000000
+
+def test_file_prefetch():
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp,'data.dat')
+        write_file(path, maxSize=MaxSize)
+
+        total = sum(os.path.getsize(os.path.join(tmp,f)) for f in os.listdir(tmp) if not f.endswith('.idx'))
+
+        for mapped in [False, True]:
+            for depth, threads in [(0, 1), (2, 4)]:
+                frd, prbs, dtime = read_file(path + '.1', mapped=mapped, depth=depth, threads=threads)
+
+                print(f"Read mapped={mapped} depth={depth} threads={threads}: {prbs.getRxCount()/dtime:.0f} Hz " +
+                      f"prefetched={frd.getPrefetchBytes()} bytes")
+
+                if prbs.getRxCount() != FrameCount:
+                    raise AssertionError(f'Incorrect number of frames read. Got = {prbs.getRxCount()} expected = {FrameCount}')
+
+                # Prefetch threads load the files only when enabled
+                if (depth == 0) != (frd.getPrefetchBytes() == 0) or frd.getPrefetchBytes() > total:
+                    raise AssertionError(f'Prefetched {frd.getPrefetchBytes()} of {total} bytes. mapped={mapped} depth={depth}')
+
+        # Prefetch with a frame range
+        frd, prbs, dtime = read_file(path + '.1', first=FrameCount//2, count=FrameCount, depth=4)
+
+        if prbs.getRxCount() != FrameCount - FrameCount//2 or frd.getPrefetchBytes() == 0:
+            raise AssertionError(f'Range read failed. count={prbs.getRxCount()} prefetched={frd.getPrefetchBytes()}')
+
+if __name__ == "__main__":
+    test_file_prefetch()
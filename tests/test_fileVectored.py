@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Vectored file write benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.utilities.fileio
+import rogue
+import tempfile
+import time
+import os
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+# Frame size and count
+Sizes = [(64,100000), (4096,20000), (1048576,100)]
+
+BufferSize = 1048576
+
+def write_file(path, frameSize, frameCount, vectored):
+
+    fwr = rogue.utilities.fileio.StreamWriter()
+    fwr.setBufferSize(BufferSize)
+    fwr.setVectored(vectored)
+
+    prbs = rogue.utilities.Prbs()
+    prbs >> fwr.getChannel(0)
+
+    fwr.open(path)
+
+    stime = time.time()
+    for _ in range(frameCount):
+        prbs.genFrame(frameSize)
+
+    fwr.close()
+    dtime = time.time() - stime
+
+    print(f"Write size={frameSize} vectored={vectored}: {frameCount/dtime:.0f} Hz " +
+          f"bw={8.0*fwr.getTotalSize()/dtime/1e9:.2f} Gbps")
+
+    if fwr.getFrameCount() != frameCount:
+        raise AssertionError(f'Incorrect frame count. Got = {fwr.getFrameCount()} expected = {frameCount}')
+
+    if os.path.getsize(path) != fwr.getTotalSize():
+        raise AssertionError(f'File size mismatch. Got = {os.path.getsize(path)} expected = {fwr.getTotalSize()}')
+
+def read_file(path, frameCount):
+
+    frd  = rogue.utilities.fileio.StreamReader()
+    prbs = rogue.utilities.Prbs()
+
+    frd >> prbs
+
+    frd.open(path)
+    frd.closeWait()
+
+    if prbs.getRxCount() != frameCount:
+        raise AssertionError(f'Incorrect number of frames read. Got = {prbs.getRxCount()} expected = {frameCount}')
+
+    if prbs.getRxErrors() != 0:
+        raise AssertionError('PRBS errors detected')
+
+def test_file_vectored():
+
+    # tmpfs when available so the benchmark measures the writer
+    base = '/dev/shm' if os.path.isdir('/dev/shm') else None
+
+    for frameSize,frameCount in Sizes:
+        for vectored in [False,True]:
+            with tempfile.TemporaryDirectory(dir=base) as tmp:
+                path = os.path.join(tmp,'data.dat')
+                write_file(path, frameSize, frameCount, vectored)
+                read_file(path, frameCount)
+
+if __name__ == "__main__":
+    test_file_vectored()
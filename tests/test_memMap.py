@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Compiled memory map round trip test and startup benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import pyrogue as pr
+import rogue.interfaces.memory
+import rogue
+import tempfile
+import time
+import os
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+class MapDev(pr.Device):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+
+        for i in range(32):
+            self.add(pr.RemoteVariable(
+                name      = f'Reg[{i}]',
+                offset    = 4*i,
+                bitSize   = 32,
+                bitOffset = 0,
+                base      = pr.UInt,
+                mode      = 'RW',
+            ))
+
+        self.add(pr.RemoteVariable(
+            name      = 'IntField',
+            offset    = 0x80,
+            bitSize   = 12,
+            bitOffset = 4,
+            base      = pr.Int,
+            mode      = 'RW',
+        ))
+
+        self.add(pr.RemoteVariable(
+            name      = 'FloatReg',
+            offset    = 0x84,
+            bitSize   = 32,
+            bitOffset = 0,
+            base      = pr.Float,
+            mode      = 'RW',
+        ))
+
+        self.add(pr.RemoteVariable(
+            name      = 'Flag',
+            offset    = 0x88,
+            bitSize   = 1,
+            bitOffset = 7,
+            base      = pr.Bool,
+            mode      = 'RW',
+        ))
+
+        self.add(pr.RemoteVariable(
+            name      = 'Split',
+            offset    = [0x8C, 0x90],
+            bitSize   = [8, 8],
+            bitOffset = [0, 0],
+            base      = pr.UInt,
+            mode      = 'RW',
+        ))
+
+        self.add(pr.RemoteVariable(
+            name        = 'Array',
+            offset      = 0x100,
+            bitSize     = 16*16,
+            bitOffset   = 0,
+            numValues   = 16,
+            valueBits   = 16,
+            valueStride = 16,
+            base        = pr.UInt,
+            mode        = 'RW',
+        ))
+
+
+class MapTree(pr.Root):
+
+    def __init__(self, devCount):
+        pr.Root.__init__(self,
+                         name='mapTree',
+                         description="Memory map tree",
+                         timeout=2.0,
+                         pollEn=False,
+                         serverPort=None)
+
+        self.sim = rogue.interfaces.memory.Emulate(4,0x1000)
+        self.sim.setName('sim')
+        self.addInterface(self.sim)
+
+        for i in range(devCount):
+            self.add(MapDev(
+                name    = f'MapDev[{i}]',
+                offset  = i*0x1000,
+                memBase = self.sim,
+            ))
+
+
+# Create libraries from the text map and from the compiled map, return load times
+def load_maps(root, tmp):
+    mapFile = os.path.join(tmp,'addr.map')
+    binFile = os.path.join(tmp,'addr.bin')
+
+    root.saveAddressMap(mapFile)
+
+    with open(mapFile) as f:
+        text = f.read()
+
+    txt = rogue.LibraryBase()
+    txt.addMemory('sim',root.sim)
+
+    stime = time.monotonic()
+    txt.parseMemMap(text)
+    txtTime = time.monotonic() - stime
+
+    rogue.LibraryBase().compileMemMap(text,binFile)
+
+    cmp = rogue.LibraryBase()
+    cmp.addMemory('sim',root.sim)
+
+    stime = time.monotonic()
+    cmp.loadMemMap(binFile)
+    cmpTime = time.monotonic() - stime
+
+    return txt, cmp, binFile, txtTime, cmpTime
+
+
+def test_mem_map():
+
+    with MapTree(4) as root, tempfile.TemporaryDirectory() as tmp:
+
+        for dev in range(4):
+            for i in range(32):
+                root.MapDev[dev].Reg[i].set(dev*1000+i)
+
+            root.MapDev[dev].IntField.set(-100-dev)
+            root.MapDev[dev].FloatReg.set(1.5*dev)
+            root.MapDev[dev].Flag.set(dev % 2 == 1)
+            root.MapDev[dev].Split.set(0x1234+dev)
+
+            for i in range(16):
+                root.MapDev[dev].Array.set(value=dev*100+i,index=i)
+
+        txt, cmp, binFile, _, _ = load_maps(root, tmp)
+
+        names = txt.getVariableNames()
+        paths = sorted(v.path for v in root.variableList if v.isinstance(pr.RemoteVariable))
+
+        if sorted(names) != paths or cmp.getVariableNames() != names:
+            raise AssertionError('Variable list mismatch between tree, text map and compiled map')
+
+        if txt.getBlockSizes() != cmp.getBlockSizes():
+            raise AssertionError('Block mismatch between text map and compiled map')
+
+        for name in names:
+            tInfo = txt.getVariableInfo(name)
+            cInfo = cmp.getVariableInfo(name)
+
+            if tInfo != cInfo:
+                raise AssertionError(f'Attribute mismatch for {name}: text={tInfo}, compiled={cInfo}')
+
+            if tInfo['mode'] != root.getNode(name).mode:
+                raise AssertionError(f'Mode mismatch for {name}')
+
+            # Values read through each library decode the same memory
+            tVal = txt.getValue(name,True)
+            cVal = cmp.getValue(name,True)
+
+            if tVal != cVal:
+                raise AssertionError(f'Value mismatch for {name}: text={tVal}, compiled={cVal}')
+
+        # A string table without a terminator is rejected
+        with open(binFile,'rb') as f:
+            data = bytearray(f.read())
+
+        data[-1] = ord('x')
+
+        with open(binFile,'wb') as f:
+            f.write(data)
+
+        try:
+            rogue.LibraryBase().loadMemMap(binFile)
+        except Exception:
+            pass
+        else:
+            raise AssertionError('Unterminated string table was not detected')
+
+
+def test_mem_map_startup():
+
+    with MapTree(64) as root, tempfile.TemporaryDirectory() as tmp:
+        txt, cmp, _, txtTime, cmpTime = load_maps(root, tmp)
+
+        count = len(txt.getVariableNames())
+
+        print(f'Startup with {count} variables: text map {txtTime*1e3:.1f} ms, compiled map {cmpTime*1e3:.1f} ms')
+
+        if cmpTime >= txtTime:
+            raise AssertionError(f'Compiled map load was not faster: {cmpTime:.3f} >= {txtTime:.3f}')
+
+
+if __name__ == "__main__":
+    test_mem_map()
+    test_mem_map_startup()
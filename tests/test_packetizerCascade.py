@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Cascaded packetizer zero copy test
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.protocols.packetizer
+import rogue.interfaces.stream
+import rogue
+import threading
+import time
+import math
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+FrameCount = 1000
+FrameSize  = 10000
+BufferSize = 2048
+
+# Forwarding stage whose pool provides every buffer in the system
+class BufferSource(rogue.interfaces.stream.Slave, rogue.interfaces.stream.Master):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        rogue.interfaces.stream.Master.__init__(self)
+        self.setFixedSize(BufferSize)
+
+    def _acceptFrame(self,frame):
+        self._sendFrame(frame)
+
+# Holds received frames until released
+class FrameHold(rogue.interfaces.stream.Slave, rogue.interfaces.stream.Master):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        rogue.interfaces.stream.Master.__init__(self)
+        self._lock   = threading.Lock()
+        self._frames = []
+
+    @property
+    def count(self):
+        with self._lock:
+            return len(self._frames)
+
+    def release(self):
+        with self._lock:
+            frames = self._frames
+            self._frames = []
+
+        for frame in frames:
+            self._sendFrame(frame)
+
+    def _acceptFrame(self,frame):
+        with self._lock:
+            self._frames.append(frame)
+
+def test_pack_cascade():
+
+    # Outer packetizer runs over inner packetizer
+    cOuter = rogue.protocols.packetizer.CoreV2(True,True,True)
+    cInner = rogue.protocols.packetizer.CoreV2(True,True,True)
+    sInner = rogue.protocols.packetizer.CoreV2(True,True,True)
+    sOuter = rogue.protocols.packetizer.CoreV2(True,True,True)
+
+    src  = BufferSource()
+    hold = FrameHold()
+
+    prbsTx = rogue.utilities.Prbs()
+    prbsRx = rogue.utilities.Prbs()
+
+    prbsTx >> cOuter.application(0)
+    cOuter.transport() >> cInner.application(1)
+    cInner.transport() >> src >> sInner.transport()
+    sInner.application(1) >> sOuter.transport()
+    sOuter.application(0) >> hold >> prbsRx
+
+    for _ in range(FrameCount):
+        prbsTx.genFrame(FrameSize)
+
+    cnt = 0
+    while hold.count != FrameCount and cnt < 100:
+        time.sleep(0.1)
+        cnt += 1
+
+    if hold.count != FrameCount:
+        raise AssertionError(f'Frame count error. Got = {hold.count} expected = {FrameCount}')
+
+    # Each application frame is built from whole upstream requests, every
+    # buffer of which carries payload at both packetizer levels
+    bufs = math.ceil((FrameSize + 32) / BufferSize)
+
+    if src.getAllocCount() != FrameCount * bufs:
+        raise AssertionError(f'Buffer count error. Got = {src.getAllocCount()} expected = {FrameCount * bufs}')
+
+    # A payload copy anywhere in the chain would allocate from another pool
+    pools = { 'cOuter.app'  : cOuter.application(0), 'cOuter.tran' : cOuter.transport(),
+              'cInner.app'  : cInner.application(1), 'cInner.tran' : cInner.transport(),
+              'sInner.app'  : sInner.application(1), 'sInner.tran' : sInner.transport(),
+              'sOuter.app'  : sOuter.application(0), 'sOuter.tran' : sOuter.transport(),
+              'hold'        : hold,                  'prbsRx'      : prbsRx }
+
+    for name,pool in pools.items():
+        if pool.getAllocCount() != 0:
+            raise AssertionError(f'Payload copy detected at {name}, {pool.getAllocCount()} buffers allocated')
+
+    hold.release()
+
+    print(f"Packetizer cascade: rx={prbsRx.getRxCount()} buffers/frame={bufs} " +
+          f"drops={sInner.getDropCount()}/{sOuter.getDropCount()}")
+
+    if prbsRx.getRxCount() != FrameCount:
+        raise AssertionError(f'PRBS count error. Got = {prbsRx.getRxCount()} expected = {FrameCount}')
+
+    if prbsRx.getRxErrors() != 0:
+        raise AssertionError('PRBS Frame errors detected!')
+
+    if sInner.getDropCount() != 0 or sOuter.getDropCount() != 0:
+        raise AssertionError('Packetizer frame drops detected!')
+
+    if src.getAllocCount() != 0:
+        raise AssertionError(f'Buffers not returned. Count = {src.getAllocCount()}')
+
+if __name__ == "__main__":
+    test_pack_cascade()
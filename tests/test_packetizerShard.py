@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Packetizer V2 multi destination reassembly benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.protocols.packetizer
+import rogue
+import time
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+DestCount = 8
+FrameSize = 100000
+RunTime   = 2.0
+
+def pack_shards(shards):
+
+    # CRC enabled in both directions
+    cPack = rogue.protocols.packetizer.CoreV2(True,True,True)
+    sPack = rogue.protocols.packetizer.CoreV2(True,True,True)
+    sPack.setRxShards(shards)
+
+    if sPack.getRxShards() != shards:
+        raise AssertionError(f'Shard count mismatch {sPack.getRxShards()}')
+
+    cPack.transport() >> sPack.transport()
+
+    links = []
+    for dest in range(DestCount):
+        prbsTx = rogue.utilities.Prbs()
+        prbsRx = rogue.utilities.Prbs()
+
+        prbsTx >> cPack.application(dest)
+        sPack.application(dest) >> prbsRx
+
+        links.append((prbsTx,prbsRx))
+
+    for link in links:
+        link[0].enable(FrameSize)
+
+    time.sleep(RunTime)
+
+    for link in links:
+        link[0].disable()
+
+    time.sleep(0.5)
+
+    rxCount  = sum(link[1].getRxCount() for link in links)
+    rxErrors = sum(link[1].getRxErrors() for link in links)
+
+    print(f"Packetizer V2 dests={DestCount} shards={shards}: rx={rxCount} rate={rxCount/RunTime:.0f} Hz " +
+          f"bw={8.0*rxCount*FrameSize/RunTime/1e9:.2f} Gbps drops={sPack.getDropCount()}")
+
+    if rxErrors != 0:
+        raise AssertionError(f'PRBS Frame errors detected! Shards={shards}')
+
+    for dest,link in enumerate(links):
+        if link[1].getRxCount() == 0:
+            raise AssertionError(f'Destination {dest} received no frames. Shards={shards}')
+
+    sPack.setRxShards(0)
+
+def test_pack_shards():
+    pack_shards(0)
+    pack_shards(2)
+    pack_shards(4)
+    pack_shards(8)
+
+if __name__ == "__main__":
+    test_pack_shards()
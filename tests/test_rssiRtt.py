@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : RSSI tests over an emulated link
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.protocols.rssi
+import rogue.interfaces.stream
+import rogue
+import threading
+import random
+import queue
+import time
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+FrameCount = 500
+FrameSize  = 1000
+Latency    = 0.005
+RetranTout = 200
+
+class LinkEmulator(rogue.interfaces.stream.Slave, rogue.interfaces.stream.Master):
+    """Loopback stand-in which delays every frame and drops a fraction of them"""
+
+    def __init__(self, latency, seed):
+        rogue.interfaces.stream.Slave.__init__(self)
+        rogue.interfaces.stream.Master.__init__(self)
+
+        self._latency = latency
+        self._rand    = random.Random(seed)
+        self._queue   = queue.Queue()
+        self.loss     = 0.0
+        self.dropped  = 0
+
+        self._thread = threading.Thread(target=self._run)
+        self._thread.daemon = True
+        self._thread.start()
+
+    def _acceptFrame(self,frame):
+        if self.loss > 0.0 and self._rand.random() < self.loss:
+            self.dropped += 1
+        else:
+            self._queue.put((time.monotonic() + self._latency, frame))
+
+    def _run(self):
+        while True:
+            due, frame = self._queue.get()
+            wait = due - time.monotonic()
+            if wait > 0:
+                time.sleep(wait)
+            self._sendFrame(frame)
+
+def test_rssi_rtt():
+
+    sRssi = rogue.protocols.rssi.Server(1400)
+    cRssi = rogue.protocols.rssi.Client(1400)
+
+    sRssi.setLocRetranTout(RetranTout)
+    cRssi.setLocRetranTout(RetranTout)
+
+    fwd = LinkEmulator(Latency,1)
+    rev = LinkEmulator(Latency,2)
+
+    cRssi.transport() >> fwd >> sRssi.transport()
+    sRssi.transport() >> rev >> cRssi.transport()
+
+    prbsTx = rogue.utilities.Prbs()
+    prbsRx = rogue.utilities.Prbs()
+
+    prbsTx >> cRssi.application()
+    sRssi.application() >> prbsRx
+
+    sRssi._start()
+    cRssi._start()
+
+    cnt = 0
+    while not cRssi.getOpen():
+        time.sleep(1)
+        cnt += 1
+
+        if cnt == 10:
+            cRssi._stop()
+            sRssi._stop()
+            raise AssertionError('RSSI timeout error')
+
+    # Drop frames in both directions once the link is open
+    fwd.loss = 0.02
+    rev.loss = 0.02
+
+    for _ in range(FrameCount):
+        prbsTx.genFrame(FrameSize)
+
+    cnt = 0
+    while prbsRx.getRxCount() != FrameCount and cnt < 100:
+        time.sleep(0.1)
+        cnt += 1
+
+    rtt    = cRssi.getRtt()
+    rttVar = cRssi.getRttVar()
+    rto    = cRssi.getRto()
+
+    print(f"RSSI rtt={rtt} us rttVar={rttVar} us rttMin={cRssi.getRttMin()} us rttMax={cRssi.getRttMax()} us " +
+          f"rto={rto} us retran={cRssi.getRetranCount()} dropped={fwd.dropped + rev.dropped}")
+
+    fwd.loss = 0.0
+    rev.loss = 0.0
+
+    cRssi._stop()
+    sRssi._stop()
+
+    if prbsRx.getRxCount() != FrameCount:
+        raise AssertionError(f'Frame count error. Got = {prbsRx.getRxCount()} expected = {FrameCount}')
+
+    if prbsRx.getRxErrors() != 0:
+        raise AssertionError('PRBS Frame errors detected!')
+
+    # Round trip covers both emulated latencies
+    if rtt < 2 * Latency * 1e6 or cRssi.getRttMin() < 2 * Latency * 1e6:
+        raise AssertionError(f'Round trip estimate {rtt} us below emulated latency')
+
+    # Timeout tracks the estimate and stays within the negotiated bound
+    if rto < rtt or rto > RetranTout * 1000:
+        raise AssertionError(f'Retransmit timeout {rto} us out of range, rtt = {rtt} us')
+
+    if fwd.dropped != 0 and cRssi.getRetranCount() == 0:
+        raise AssertionError('Dropped frames were not retransmitted')
+
+def test_rssi_idle():
+
+    sRssi = rogue.protocols.rssi.Server(1400)
+    cRssi = rogue.protocols.rssi.Client(1400)
+
+    fwd = LinkEmulator(0.0,1)
+    rev = LinkEmulator(0.0,2)
+
+    cRssi.transport() >> fwd >> sRssi.transport()
+    sRssi.transport() >> rev >> cRssi.transport()
+
+    sRssi._start()
+    cRssi._start()
+
+    cnt = 0
+    while not cRssi.getOpen():
+        time.sleep(1)
+        cnt += 1
+
+        if cnt == 10:
+            cRssi._stop()
+            sRssi._stop()
+            raise AssertionError('RSSI timeout error')
+
+    # An open link with no traffic only wakes for its null timer
+    time.sleep(0.5)
+    cpu = time.process_time()
+    time.sleep(2.0)
+    cpu = time.process_time() - cpu
+
+    print(f"RSSI idle cpu={cpu:.3f} s over 2.0 s")
+
+    linkOpen = cRssi.getOpen() and sRssi.getOpen()
+
+    cRssi._stop()
+    sRssi._stop()
+
+    if not linkOpen:
+        raise AssertionError('RSSI link dropped while idle')
+
+    if cpu > 0.2:
+        raise AssertionError(f'Idle RSSI link used {cpu:.3f} s of cpu')
+
+if __name__ == "__main__":
+    test_rssi_rtt()
+    test_rssi_idle()
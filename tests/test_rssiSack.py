@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : RSSI selective acknowledgement goodput benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.protocols.rssi
+import rogue
+import time
+
+from test_rssiRtt import LinkEmulator
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+FrameCount = 2000
+FrameSize  = 1000
+Latency    = 0.001
+
+def rssi_loss(loss, sack):
+
+    sRssi = rogue.protocols.rssi.Server(1400)
+    cRssi = rogue.protocols.rssi.Client(1400)
+
+    cRssi.setLocSack(sack)
+    cRssi.setLocRetranTout(100)
+
+    fwd = LinkEmulator(Latency,1)
+    rev = LinkEmulator(Latency,2)
+
+    cRssi.transport() >> fwd >> sRssi.transport()
+    sRssi.transport() >> rev >> cRssi.transport()
+
+    prbsTx = rogue.utilities.Prbs()
+    prbsRx = rogue.utilities.Prbs()
+
+    prbsTx >> cRssi.application()
+    sRssi.application() >> prbsRx
+
+    sRssi._start()
+    cRssi._start()
+
+    cnt = 0
+    while not cRssi.getOpen():
+        time.sleep(1)
+        cnt += 1
+
+        if cnt == 10:
+            cRssi._stop()
+            sRssi._stop()
+            raise AssertionError(f'RSSI timeout error. Loss={loss} Sack={sack}')
+
+    if cRssi.curSack() != sack or sRssi.curSack() != sack:
+        raise AssertionError(f'Selective ack negotiation mismatch. Sack={sack}')
+
+    # Data direction only, acks are not dropped
+    fwd.loss = loss
+
+    start = time.monotonic()
+    for _ in range(FrameCount):
+        prbsTx.genFrame(FrameSize)
+
+    cnt = 0
+    while prbsRx.getRxCount() != FrameCount and cnt < 300:
+        time.sleep(0.01)
+        cnt += 1
+
+    dur = time.monotonic() - start
+    fwd.loss = 0.0
+
+    rxCount = prbsRx.getRxCount()
+    retran  = cRssi.getRetranCount()
+    fast    = cRssi.getFastRetranCount()
+
+    cRssi._stop()
+    sRssi._stop()
+
+    print(f"RSSI loss={loss*100:.1f}% sack={sack}: dropped={fwd.dropped} retran={retran} fast={fast} " +
+          f"goodput={8.0*rxCount*FrameSize/dur/1e6:.1f} Mbps")
+
+    if rxCount != FrameCount:
+        raise AssertionError(f'Frame count error. Loss={loss} Sack={sack} Got = {rxCount} expected = {FrameCount}')
+
+    if prbsRx.getRxErrors() != 0:
+        raise AssertionError(f'PRBS Frame errors detected! Loss={loss} Sack={sack}')
+
+    return retran
+
+def test_rssi_sack():
+    for loss in [0.001, 0.005, 0.01, 0.02]:
+        base = rssi_loss(loss,False)
+        sack = rssi_loss(loss,True)
+
+    # Only holes are resent with selective acknowledgement
+    if sack >= base:
+        raise AssertionError(f'Selective ack did not reduce retransmissions. Base={base} Sack={sack}')
+
+if __name__ == "__main__":
+    test_rssi_sack()
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : RSSI window size throughput benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.protocols.rssi
+import rogue
+import time
+
+from test_rssiRtt import LinkEmulator
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+RunTime   = 2.0
+FrameSize = 1000
+Rtt       = 0.005
+
+def rssi_window(window):
+
+    sRssi = rogue.protocols.rssi.Server(1400)
+    cRssi = rogue.protocols.rssi.Client(1400)
+
+    # Windows above 255 request the Rogue window extension
+    cRssi.setLocMaxBuffers(window)
+    cRssi.setLocRetranTout(100)
+
+    fwd = LinkEmulator(Rtt/2,1)
+    rev = LinkEmulator(Rtt/2,2)
+
+    cRssi.transport() >> fwd >> sRssi.transport()
+    sRssi.transport() >> rev >> cRssi.transport()
+
+    prbsTx = rogue.utilities.Prbs()
+    prbsRx = rogue.utilities.Prbs()
+    prbsTx.genPayload(False)
+    prbsRx.checkPayload(False)
+
+    prbsTx >> cRssi.application()
+    sRssi.application() >> prbsRx
+
+    sRssi._start()
+    cRssi._start()
+
+    cnt = 0
+    while not cRssi.getOpen():
+        time.sleep(1)
+        cnt += 1
+
+        if cnt == 10:
+            cRssi._stop()
+            sRssi._stop()
+            raise AssertionError(f'RSSI timeout error. Window={window}')
+
+    ext = (cRssi.curWindowExt(), sRssi.curWindowExt())
+    cur = (cRssi.curMaxBuffers(), sRssi.curMaxBuffers())
+
+    prbsTx.enable(FrameSize)
+    time.sleep(RunTime)
+    prbsTx.disable()
+    time.sleep(0.5)
+
+    rxCount = prbsRx.getRxCount()
+
+    cRssi._stop()
+    sRssi._stop()
+
+    rate = rxCount / RunTime
+
+    print(f"RSSI window={window} negotiated={cur} ext={ext} rtt={Rtt*1e3:.1f} ms: rx={rxCount} " +
+          f"rate={rate:.0f} Hz bw={8.0*rate*FrameSize/1e6:.1f} Mbps retran={cRssi.getRetranCount()}")
+
+    if ext != ((window > 255),) * 2:
+        raise AssertionError(f'Window extension mismatch. Window={window} ext={ext}')
+
+    if cur != (window, window):
+        raise AssertionError(f'Negotiated window mismatch. Window={window} cur={cur}')
+
+    if prbsRx.getRxErrors() != 0:
+        raise AssertionError(f'PRBS Frame errors detected! Window={window}')
+
+    return rate
+
+def test_rssi_window():
+    small = rssi_window(32)
+    rssi_window(255)
+    large = rssi_window(1024)
+
+    # Throughput is bound by window / rtt until the emulated link saturates
+    if large <= small:
+        raise AssertionError(f'Extended window did not improve throughput. 32={small:.0f} Hz 1024={large:.0f} Hz')
+
+if __name__ == "__main__":
+    test_rssi_window()
@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : UDP loopback throughput benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.protocols.udp
+import rogue.interfaces.stream
+import rogue
+import time
+import os
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+RunTime = 2.0
+
+class DatagramCounter(rogue.interfaces.stream.Slave):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        self.count = 0
+        self.bytes = 0
+
+    def _acceptFrame(self,frame):
+        self.count += 1
+        self.bytes += frame.getPayload()
+
+def udp_rate(jumbo, offload=False):
+
+    # UDP Server
+    serv = rogue.protocols.udp.Server(0,jumbo)
+    port = serv.getPort()
+
+    # UDP Client
+    client = rogue.protocols.udp.Client("127.0.0.1",port,jumbo)
+    serv.setRxBufferCount(1000)
+
+    # Segmentation offload, falls back if not supported
+    if offload:
+        client.setGso(True)
+        serv.setGro(True)
+
+    # PRBS without payload generation and checking, one datagram per frame
+    prbsTx = rogue.utilities.Prbs()
+    prbsRx = rogue.utilities.Prbs()
+    prbsTx.genPayload(False)
+    prbsRx.checkPayload(False)
+
+    prbsTx >> client
+    serv >> prbsRx
+
+    # Multi buffer frames with offload so runs of datagrams can be segmented
+    prbsTx.enable(client.maxPayload() * (16 if offload else 1))
+    time.sleep(RunTime)
+    prbsTx.disable()
+    time.sleep(0.5)
+
+    # Split offload frames arrive as individual datagrams which fail the PRBS header check
+    txCount = prbsTx.getTxCount()
+    rxCount = prbsRx.getRxCount() + prbsRx.getRxErrors()
+    rxBytes = rxCount * client.maxPayload()
+
+    print(f"UDP loopback jumbo={jumbo} gso={client.getGso()} gro={serv.getGro()}: tx={txCount} rx={rxCount} " +
+          f"rate={rxCount/RunTime:.0f} Hz bw={8.0*rxBytes/RunTime/1e9:.2f} Gbps")
+
+    if rxCount == 0:
+        raise AssertionError(f'No datagrams received. Jumbo={jumbo}')
+
+class SeqSource(rogue.interfaces.stream.Master):
+
+    def __init__(self, idx):
+        rogue.interfaces.stream.Master.__init__(self)
+        self._idx = idx
+
+    def send(self, seq):
+        frame = self._reqFrame(8,True)
+        frame.write(bytearray(self._idx.to_bytes(4,'little') + seq.to_bytes(4,'little')),0)
+        self._sendFrame(frame)
+
+
+class SeqCheck(rogue.interfaces.stream.Slave):
+
+    def __init__(self):
+        rogue.interfaces.stream.Slave.__init__(self)
+        self.last   = {}
+        self.count  = 0
+        self.errors = 0
+
+    def _acceptFrame(self,frame):
+        ba = bytearray(frame.getPayload())
+        frame.read(ba,0)
+        idx = int.from_bytes(ba[0:4],'little')
+        seq = int.from_bytes(ba[4:8],'little')
+
+        # Datagrams may be lost but never reordered within a source
+        if idx in self.last and seq <= self.last[idx]:
+            self.errors += 1
+
+        self.last[idx] = seq
+        self.count += 1
+
+def test_udp_rate():
+    udp_rate(False)
+    udp_rate(True)
+    udp_rate(False,True)
+    udp_rate(True,True)
+
+def test_udp_gso():
+    serv = rogue.protocols.udp.Server(0,False)
+    client = rogue.protocols.udp.Client("127.0.0.1",serv.getPort(),False)
+    serv.setRxBufferCount(1000)
+
+    gso = client.setGso(True)
+    gro = serv.setGro(True)
+    print(f"Segmentation offload gso={gso} gro={gro}")
+
+    prbsTx = rogue.utilities.Prbs()
+    rx     = DatagramCounter()
+
+    prbsTx >> client
+    serv >> rx
+
+    # Each frame has seven full datagrams and a shorter tail which are sent as one
+    # super buffer and must be received as individual datagrams
+    frames = 100
+    size   = client.maxPayload() * 7 + 100
+
+    for _ in range(frames):
+        prbsTx.genFrame(size)
+        time.sleep(0.001)
+
+    time.sleep(0.5)
+
+    if rx.count != frames * 8 or rx.bytes != frames * size:
+        raise AssertionError(f'Segmentation offload mismatch: count={rx.count} bytes={rx.bytes}')
+
+def test_udp_shard():
+    serv = rogue.protocols.udp.Server(0,False,4)
+
+    if serv.getShardCount() != 4:
+        raise AssertionError(f'Unexpected shard count {serv.getShardCount()}')
+
+    # Shard 0 is the server itself, the others have their own endpoints
+    ports = [serv] + [serv.getShard(i) for i in range(1,4)]
+    rx    = [SeqCheck() for _ in range(4)]
+
+    for port,check in zip(ports,rx):
+        port >> check
+
+    for i in range(4):
+        serv.setShardCpu(i,i % os.cpu_count())
+
+    # Independent sources from one host, each with its own local port
+    links = []
+    for i in range(8):
+        client = rogue.protocols.udp.Client("127.0.0.1",serv.getPort(),False)
+        src    = SeqSource(i)
+        src >> client
+        links.append((client,src))
+
+    for seq in range(1000):
+        for link in links:
+            link[1].send(seq)
+
+    time.sleep(0.5)
+
+    # Each source is handled by a single shard, sources spread across shards
+    shardOf = {}
+    for idx,check in enumerate(rx):
+        for src in check.last:
+            if src in shardOf:
+                raise AssertionError(f'Source {src} received on shards {shardOf[src]} and {idx}')
+            shardOf[src] = idx
+
+    errors = sum(check.errors for check in rx)
+    used   = len(set(shardOf.values()))
+
+    print(f"Sharded server: rx={[check.count for check in rx]} sources={len(shardOf)} shards={used} errors={errors}")
+
+    if errors != 0 or len(shardOf) != 8:
+        raise AssertionError(f'Sharded receive ordering failure: sources={len(shardOf)} errors={errors}')
+
+    if used < 2:
+        raise AssertionError('Sources were not spread across shards')
+
+    # Replies go to the most recent sender on the shard of each endpoint
+    replies = []
+    for link in links:
+        cnt = DatagramCounter()
+        link[0] >> cnt
+        replies.append(cnt)
+
+    a = 0
+    b = next(i for i in range(8) if shardOf[i] != shardOf[a])
+
+    links[a][1].send(2000)
+    time.sleep(0.1)
+    links[b][1].send(2000)
+    time.sleep(0.1)
+
+    for last in [a, b]:
+        reply = SeqSource(100)
+        reply >> ports[shardOf[last]]
+        reply.send(last)
+        time.sleep(0.1)
+
+        if replies[last].count != 1 or sum(r.count for r in replies) != 1:
+            raise AssertionError(f'Reply not routed to sender {last} on shard {shardOf[last]}: {[r.count for r in replies]}')
+
+        replies[last].count = 0
+
+    # Shard 0 is not a separate endpoint
+    try:
+        serv.getShard(0)
+    except Exception:
+        pass
+    else:
+        raise AssertionError('Shard 0 endpoint request was accepted')
+
+if __name__ == "__main__":
+    test_udp_rate()
+    test_udp_gso()
+    test_udp_shard()
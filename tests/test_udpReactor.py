@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : UDP shared reactor scaling benchmark
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import rogue.utilities
+import rogue.protocols.udp
+import rogue
+import time
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+LinkCount = 64
+RunTime   = 2.0
+
+def udp_links(threads):
+    links = []
+
+    # Zero threads uses the dedicated receive thread of each endpoint
+    reactor = rogue.protocols.udp.Reactor(threads) if threads > 0 else None
+
+    for _ in range(LinkCount):
+        serv   = rogue.protocols.udp.Server(0,True)
+        client = rogue.protocols.udp.Client("127.0.0.1",serv.getPort(),True)
+
+        if reactor is not None:
+            serv.setReactor(reactor)
+            client.setReactor(reactor)
+
+        prbsTx = rogue.utilities.Prbs()
+        prbsRx = rogue.utilities.Prbs()
+        prbsTx.genPayload(False)
+        prbsRx.checkPayload(False)
+
+        prbsTx >> client
+        serv >> prbsRx
+
+        links.append((serv,client,prbsTx,prbsRx))
+
+    if reactor is not None and reactor.getCount() != LinkCount * 2:
+        raise AssertionError(f'Reactor endpoint count mismatch: {reactor.getCount()}')
+
+    for link in links:
+        link[2].enable(links[0][1].maxPayload())
+
+    time.sleep(RunTime)
+
+    for link in links:
+        link[2].disable()
+
+    time.sleep(0.5)
+
+    rxCount = sum(link[3].getRxCount() for link in links)
+    rxIdle  = sum(1 for link in links if link[3].getRxCount() == 0)
+
+    print(f"UDP {LinkCount} links reactorThreads={threads}: rx={rxCount} rate={rxCount/RunTime:.0f} Hz " +
+          f"bw={8.0*rxCount*links[0][1].maxPayload()/RunTime/1e9:.2f} Gbps")
+
+    if rxIdle != 0:
+        raise AssertionError(f'{rxIdle} links did not receive data. Threads={threads}')
+
+    if reactor is not None:
+        reactor.stop()
+
+def test_udp_reactor():
+    udp_links(0)
+    udp_links(1)
+    udp_links(2)
+
+    # A sharded server keeps its own receive threads
+    reactor = rogue.protocols.udp.Reactor(1)
+    serv    = rogue.protocols.udp.Server(0,True,2)
+
+    try:
+        serv.setReactor(reactor)
+    except Exception:
+        pass
+    else:
+        raise AssertionError('Sharded server was attached to a reactor')
+
+    reactor.stop()
+
+if __name__ == "__main__":
+    test_udp_reactor()
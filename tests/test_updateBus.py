@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+#-----------------------------------------------------------------------------
+# Title      : Variable update bus test
+#-----------------------------------------------------------------------------
+# This file is part of the rogue software platform. It is subject to
+# the license terms in the LICENSE.txt file found in the top-level directory
+# of this distribution and at:
+#    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+# No part of the rogue software platform, including this file, may be
+# copied, modified, propagated, or distributed except according to the terms
+# contained in the LICENSE.txt file.
+#-----------------------------------------------------------------------------
+import pyrogue as pr
+import rogue.interfaces.memory
+import time
+
+#rogue.Logging.setLevel(rogue.Logging.Debug)
+
+class BusDev(pr.Device):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+
+        for i in range(256):
+            self.add(pr.RemoteVariable(
+                name      = f'Reg[{i}]',
+                offset    = 4*i,
+                bitSize   = 32,
+                bitOffset = 0,
+                base      = pr.UInt,
+                mode      = 'RW',
+            ))
+
+
+class CountVariable(pr.RemoteVariable):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+        self.updateCount = 0
+
+    def _queueUpdate(self):
+        self.updateCount += 1
+        super()._queueUpdate()
+
+
+class HookDev(pr.Device):
+
+    def __init__(self,**kwargs):
+        super().__init__(**kwargs)
+
+        self.add(CountVariable(
+            name      = 'Count',
+            offset    = 0,
+            bitSize   = 32,
+            bitOffset = 0,
+            base      = pr.UInt,
+            mode      = 'RW',
+        ))
+
+        self.add(pr.LinkVariable(
+            name         = 'Double',
+            dependencies = [self.Count],
+            linkedGet    = lambda: self.Count.value() * 2,
+        ))
+
+
+class BusTree(pr.Root):
+
+    def __init__(self, updateBus):
+        pr.Root.__init__(self,
+                         name='busTree',
+                         description="Update bus tree",
+                         timeout=2.0,
+                         pollEn=False,
+                         updateBus=updateBus,
+                         serverPort=None)
+
+        self.sim = rogue.interfaces.memory.Emulate(4,0x1000)
+        self.addInterface(self.sim)
+
+        for i in range(2):
+            self.add(BusDev(
+                name    = f'BusDev[{i}]',
+                offset  = i*0x10000,
+                memBase = self.sim,
+            ))
+
+        self.add(HookDev(
+            name    = 'HookDev',
+            offset  = 0x20000,
+            memBase = self.sim,
+        ))
+
+
+def test_update_bus():
+    seen = {}
+
+    def listener(path, value):
+        seen[path] = value.value
+
+    with BusTree(updateBus=True) as root:
+        root.addVarListener(listener)
+
+        for i in range(256):
+            root.BusDev[1].Reg[i].set(i+100)
+
+        # Updates are delivered asynchronously through the bus worker
+        for i in range(100):
+            if seen.get(root.BusDev[1].Reg[255].path) == 355:
+                break
+            time.sleep(0.01)
+            root.waitOnUpdate()
+
+        for i in range(256):
+            ret = seen.get(root.BusDev[1].Reg[i].path)
+            if ret != i+100:
+                raise AssertionError(f'Update bus listener mismatch: i={i}, ret={ret}')
+
+
+def wait_for(cond):
+    for i in range(100):
+        if cond():
+            return True
+        time.sleep(0.01)
+    return False
+
+
+def test_update_bus_hooks():
+    seen = {}
+
+    def listener(path, value):
+        seen[path] = value.value
+
+    with BusTree(updateBus=True) as root:
+        root.addVarListener(listener)
+
+        # Bus updates go through the variable update hook and reach dependencies
+        root.HookDev.Count.updateCount = 0
+        root.HookDev.Count.set(21)
+
+        if not wait_for(lambda: seen.get(root.HookDev.Double.path) == 42):
+            raise AssertionError(f'Dependent variable not updated through the bus: {seen.get(root.HookDev.Double.path)}')
+
+        if root.HookDev.Count.updateCount == 0:
+            raise AssertionError('Variable update hook not called for bus update')
+
+        # Updates generated inside an update group are held until the group exits
+        seen.clear()
+
+        with root.updateGroup():
+            root.BusDev[0].Reg[7].set(0x77)
+            time.sleep(0.2)
+            root.waitOnUpdate()
+
+            if root.BusDev[0].Reg[7].path in seen:
+                raise AssertionError('Bus update delivered before the update group exited')
+
+        if not wait_for(lambda: seen.get(root.BusDev[0].Reg[7].path) == 0x77):
+            raise AssertionError('Bus update not delivered after the update group exited')
+
+
+def test_update_bus_coalesce():
+
+    with BusTree(updateBus=False) as root:
+        bus = rogue.interfaces.memory.UpdateBus(256)
+
+        # Publishing an unregistered ID is an error
+        try:
+            bus.publish(2)
+        except Exception:
+            pass
+        else:
+            raise AssertionError('Publish to an unregistered variable id was accepted')
+
+        for b in root.BusDev[0]._blocks:
+            bus.addBlock(b)
+
+        if bus.getVariableCount() != 256:
+            raise AssertionError(f'Unexpected variable count {bus.getVariableCount()}')
+
+        # Repeated publications of a pending variable are coalesced
+        for i in range(10):
+            bus.publish(2)
+
+        ids = bus.pop(0)
+
+        if ids != [2] or bus.getCoalesceCount() != 9:
+            raise AssertionError(f'Update bus coalescing failure: ids={ids}, coalesced={bus.getCoalesceCount()}')
+
+        # Nothing is delivered while the bus is held
+        bus.hold()
+        bus.publish(3)
+
+        if bus.pop(0) != []:
+            raise AssertionError('Update delivered while the bus was held')
+
+        bus.release()
+
+        if bus.pop(0) != [3]:
+            raise AssertionError('Held update not delivered after release')
+
+        bus.stop()
+
+
+if __name__ == "__main__":
+    test_update_bus()
+    test_update_bus_hooks()
+    test_update_bus_coalesce()